@@ -132,6 +132,37 @@ extern "C" {
 #define S2D_BOTTOM_LEFT  4
 #define S2D_BOTTOM_RIGHT 5
 
+// Sorted draws, kinds of draws in the order they're drawn within a layer
+#define S2D_DRAW_TRIANGLE 0
+#define S2D_DRAW_TEXTURE  1
+#define S2D_DRAW_GLYPHS   2
+#define S2D_DRAW_CALL     3  // a call run in order, which draws aren't sorted across
+#define S2D_DRAW_SHAPE    4  // circles, rings, and arcs shaded by distance
+
+// Polyline joins, where segments meet, and caps, at the ends
+#define S2D_JOIN_MITER 1  // sides extended until they meet, up to a limit
+#define S2D_JOIN_BEVEL 2  // corners cut off
+#define S2D_JOIN_ROUND 3
+#define S2D_CAP_BUTT   1  // ending at the last point
+#define S2D_CAP_SQUARE 2  // extended by half the width
+#define S2D_CAP_ROUND  3
+
+// Cameras
+#define S2D_CAMERA_STACK_SIZE 16  // cameras which can be pushed
+
+// Render targets
+#define S2D_TARGET_POOL_SIZE 16  // freed framebuffers kept for reuse
+
+// Signed distance field fonts
+#define S2D_SDF_BASE_SIZE  48    // pixel size glyphs are rasterized at
+#define S2D_SDF_SPREAD     6     // distance range, in pixels, stored around glyph edges
+#define S2D_SDF_ATLAS_SIZE 1024  // width and height of the glyph atlas
+
+// Text alignment
+#define S2D_ALIGN_LEFT   1
+#define S2D_ALIGN_CENTER 2
+#define S2D_ALIGN_RIGHT  3
+
 // Keyboard events
 #define S2D_KEY_DOWN 1  // key is pressed
 #define S2D_KEY_HELD 2  // key is held down
@@ -150,6 +181,34 @@ extern "C" {
 #define S2D_MOUSE_SCROLL_NORMAL   SDL_MOUSEWHEEL_NORMAL
 #define S2D_MOUSE_SCROLL_INVERTED SDL_MOUSEWHEEL_FLIPPED
 
+// Capture formats
+#define S2D_CAPTURE_Y4M 1  // raw YUV 4:4:4 video, to a file or a pipe
+#define S2D_CAPTURE_PNG 2  // numbered PNG images
+
+// Frame stats, stages of a frame which are timed
+#define S2D_STAGE_UPDATE 0  // `update` callback
+#define S2D_STAGE_RENDER 1  // `render` callback
+#define S2D_STAGE_FLUSH  2  // flushing OpenGL buffers
+#define S2D_STAGE_SWAP   3  // swapping the window buffers
+#define S2D_STAGE_FRAME  4  // the whole frame, start to start
+#define S2D_STAGE_COUNT  5
+#define S2D_FRAME_HISTORY 4096  // number of frames kept for stats
+
+// Quad kernels, by the instruction set they use
+#define S2D_KERNEL_AUTO  -1  // the fastest the CPU can run
+#define S2D_KERNEL_SCALAR 0
+#define S2D_KERNEL_SSE    1  // SSE2, 4 quads at a time
+#define S2D_KERNEL_AVX2   2  // 8 quads at a time
+#define S2D_KERNEL_NEON   3  // 4 quads at a time
+#define S2D_KERNEL_COUNT  4
+
+// Input devices, for dispatching events
+#define S2D_KEYBOARD   1
+#define S2D_MOUSE      2
+#define S2D_CONTROLLER 3
+#define S2D_MAX_CONTROLLERS 8  // controllers with polled state
+#define S2D_REPLAY_EVENT_SIZE 43  // bytes per event in replay files
+
 // Controller events
 #define S2D_AXIS        1
 #define S2D_BUTTON_DOWN 2
@@ -197,6 +256,7 @@ typedef struct {
   int button;
   bool dblclick;
   const char *key;
+  int scancode;  // SDL_Scancode of the key, for comparing without the name
   int x;
   int y;
   int delta_x;
@@ -211,6 +271,7 @@ typedef void (*S2D_Render)();
 typedef void (*S2D_On_Key)(S2D_Event e);
 typedef void (*S2D_On_Mouse)(S2D_Event e);
 typedef void (*S2D_On_Controller)(S2D_Event e);
+typedef void (*S2D_CaptureDone)(Uint8 *pixels, int w, int h, void *data);
 
 typedef struct {
   float x;
@@ -236,12 +297,33 @@ typedef struct {
   int height;
 } S2D_IRect;
 
+// S2D_ControllerState, polled state of a controller
+typedef struct {
+  bool connected;
+  int which;  // joystick instance ID
+  int axes[S2D_AXIS_MAX];
+  bool buttons[S2D_BUTTON_MAX];
+  bool pressed[S2D_BUTTON_MAX];   // pressed since the last frame
+  bool released[S2D_BUTTON_MAX];  // released since the last frame
+} S2D_ControllerState;
+
 // S2D_GL_Point, for graphics calculations
 typedef struct {
   GLfloat x;
   GLfloat y;
 } S2D_GL_Point;
 
+// S2D_QuadArrays, quads as an array of each attribute, for transforming many
+typedef struct {
+  const GLfloat *x;
+  const GLfloat *y;
+  const GLfloat *width;
+  const GLfloat *height;
+  const GLfloat *rotate;  // degrees
+  const GLfloat *rx;  // point rotated around
+  const GLfloat *ry;
+} S2D_QuadArrays;
+
 // S2D_Color
 typedef struct {
   GLfloat r;
@@ -250,6 +332,13 @@ typedef struct {
   GLfloat a;
 } S2D_Color;
 
+// S2D_Vertex, a colored vertex of a triangle
+typedef struct {
+  GLfloat x;
+  GLfloat y;
+  S2D_Color color;
+} S2D_Vertex;
+
 // S2D_Mouse
 typedef struct {
   int visible;
@@ -257,6 +346,14 @@ typedef struct {
   int y;
 } S2D_Mouse;
 
+// S2D_Camera, the part of the world in view
+typedef struct {
+  float x;       // world position shown at the center of the view
+  float y;
+  float zoom;    // scale of the world, 1 for none
+  float rotate;  // rotation angle in degrees
+} S2D_Camera;
+
 // S2D_Viewport
 typedef struct {
   int width;
@@ -264,6 +361,79 @@ typedef struct {
   int mode;
 } S2D_Viewport;
 
+// S2D_CaptureOptions, for capturing frames; zero values use defaults
+typedef struct {
+  int format;      // S2D_CAPTURE_Y4M or S2D_CAPTURE_PNG, by default Y4M unless
+                   // the path has a `%d` style frame number
+  int every;       // capture every Nth frame, by default 1
+  int fps;         // frame rate in the video header, by default `fps_cap / every`
+  int max_queued;  // frames waiting to be encoded before more are dropped, by
+                   // default 8, which bounds the memory used
+  int workers;     // threads encoding PNG images, by default 4
+} S2D_CaptureOptions;
+
+// S2D_CaptureStats
+typedef struct {
+  Uint32 captured;  // frames read back
+  Uint32 written;   // frames encoded and written
+  Uint32 dropped;   // frames skipped because encoding fell behind, or failed
+} S2D_CaptureStats;
+
+// S2D_RenderStats, primitives drawn in a frame
+typedef struct {
+  Uint32 submitted;   // triangles and quads drawn
+  Uint32 culled;      // triangles and quads skipped for being out of view
+  Uint32 draw_calls;  // OpenGL draw calls
+} S2D_RenderStats;
+
+// Jobs, run on a pool of worker threads
+typedef void (*S2D_JobFunc)(void *data);
+typedef void (*S2D_RangeFunc)(int first, int last, void *data);  // from `first` up to `last`
+
+// S2D_JobCounter, counts jobs not yet done, and holds jobs waiting for them.
+// Must start zeroed.
+typedef struct {
+  SDL_atomic_t count;
+  SDL_SpinLock lock;
+  void *waiting;
+} S2D_JobCounter;
+
+// S2D_FrameRing, times of recent frames, in milliseconds. Written by the main
+// loop, and can be read from other threads without locking.
+typedef struct {
+  float ms[S2D_FRAME_HISTORY][S2D_STAGE_COUNT];
+  SDL_atomic_t count;  // frames written; the newest is at `count - 1`
+  Uint64 last_start;   // performance counter at the start of the last frame
+} S2D_FrameRing;
+
+// S2D_FrameStats, percentiles of a frame stage, in milliseconds
+typedef struct {
+  int frames;  // number of frames measured
+  double mean;
+  double p50;
+  double p95;
+  double p99;
+  double max;
+} S2D_FrameStats;
+
+// S2D_ReplayEvent, an input event of a frame being recorded
+typedef struct {
+  int device;
+  S2D_Event event;
+} S2D_ReplayEvent;
+
+// S2D_Replay, input recorded to or played back from a file
+typedef struct {
+  FILE *file;
+  bool playing;
+  S2D_ReplayEvent *events;  // events of the frame being recorded
+  int event_count;
+  int event_capacity;
+  Uint32 frames;
+  float dt;      // delta time of the frame being played back
+  Uint64 start;  // performance counter when recording or playback started
+} S2D_Replay;
+
 // S2D_Window
 typedef struct {
   void *on_UpdateArgs;
@@ -297,7 +467,24 @@ typedef struct {
   Uint32 loop_ms;
   Uint32 delay_ms;
   double fps;
-  float deltaTime;
+  float deltaTime;  // seconds per update with a fixed timestep
+  bool fixed_timestep;  // time the loop with high-resolution counters and call
+  int update_rate;      // `update` this many times a second
+  double alpha;  // fraction of an update since the last one, for rendering
+  S2D_FrameRing *frame_ring;
+  const char *stats_path;  // CSV file frame times are written to on exit, or NULL
+  bool key_names;  // set `key` in key events, or only `scancode` if false
+  bool input_callbacks;  // call `on_key`, `on_mouse`, and `on_controller`
+  const char *record_path;  // file to record input to, or NULL
+  const char *replay_path;  // file to replay input from as fast as possible, or NULL
+  S2D_Replay *replay;
+  bool headless;  // render offscreen without showing a window
+  Uint32 max_frames;  // close the window after this many frames, if not 0
+  bool culling;  // skip drawing what's out of view
+  bool sorted_draws;  // sort draws by layer, then by shader and texture
+  bool render_thread;  // draw frames on their own thread while the next is made
+  S2D_RenderStats render_stats;  // of the last frame; draw calls are of the one
+                                 // before with `render_thread`
   bool close;
 } S2D_Window;
 
@@ -343,14 +530,174 @@ typedef struct {
   GLfloat ty4;
 } S2D_Sprite;
 
+// Call to run on the render thread, given a copy of its arguments
+typedef void (*S2D_RenderCall)(void *args);
+
+// S2D_DrawCommand, a draw waiting to be sorted or drawn on the render thread
+typedef struct {
+  int type;  // one of the S2D_DRAW_* kinds
+  GLuint texture_id;
+  union {
+    GLfloat triangle[18];  // x, y, r, g, b, a per vertex
+    S2D_Sprite quad;       // drawn with `texture_id`, `img` is unset
+    struct {
+      int first;  // offset of the glyph quads in the draw data
+      int count;
+      GLfloat x, y, scale, angle, rx, ry, smoothing;
+      S2D_Color color;
+    } glyphs;
+    struct {
+      S2D_RenderCall fn;
+      Uint64 args[8];
+    } call;
+    struct {
+      GLfloat x, y, radius, inner, start, end;
+      S2D_Color color;
+    } shape;
+  };
+} S2D_DrawCommand;
+
+typedef void (*S2D_SubmitDraw)(S2D_DrawCommand *command, const GLfloat *data);
+
+// S2D_RenderTarget, an offscreen framebuffer which can be drawn as an image
+typedef struct S2D_RenderTarget {
+  GLuint fbo;
+  GLuint texture_id;
+  S2D_Color color;
+  float x;
+  float y;
+  float width;
+  float height;
+  int orig_width;   // size of the framebuffer, in pixels
+  int orig_height;
+  GLfloat rotate;  // Rotation angle in degrees
+  GLfloat rx;      // X coordinate to be rotated around
+  GLfloat ry;      // Y coordinate to be rotated around
+  bool dirty;  // contents need to be drawn again, set until the target is drawn to
+  struct S2D_RenderTarget *prev;  // target being drawn to before this one
+} S2D_RenderTarget;
+
+// S2D_MeshBatch, a range of mesh vertices drawn with one texture, or none
+typedef struct {
+  GLuint texture_id;
+  int first;
+  int count;
+} S2D_MeshBatch;
+
+// S2D_Mesh, recorded draws kept in a vertex buffer on the GPU
+typedef struct {
+  GLfloat *vertices;  // x, y, r, g, b, a, tx, ty per vertex, until uploaded
+  int vertex_count;
+  int vertex_capacity;
+  S2D_MeshBatch *batches;
+  int batch_count;
+  int batch_capacity;
+  GLuint vbo;
+  GLuint vao;
+  float x;
+  float y;
+  GLfloat scale;
+  GLfloat rotate;  // Rotation angle in degrees
+  GLfloat rx;      // X coordinate to be rotated and scaled around
+  GLfloat ry;      // Y coordinate to be rotated and scaled around
+  bool recording;
+} S2D_Mesh;
+
+// S2D_Polyline, connected lines, tessellated into triangles when drawn and
+// kept until the points or style change
+typedef struct {
+  S2D_Vec2f *points;
+  int count;
+  int capacity;
+  GLfloat width;
+  int join;             // S2D_JOIN_MITER, S2D_JOIN_BEVEL, or S2D_JOIN_ROUND
+  int cap;              // S2D_CAP_BUTT, S2D_CAP_SQUARE, or S2D_CAP_ROUND
+  GLfloat miter_limit;  // longest miter, in widths, before it's bevelled instead
+  S2D_Color color;
+  Uint32 version;       // incremented when points change, to tessellate again
+  S2D_Vertex *vertices;
+  int vertex_count;
+  int vertex_capacity;
+  Uint32 tessellated_version;
+  int tessellated_count;  // points tessellated
+  struct {
+    GLfloat width;
+    int join;
+    int cap;
+    GLfloat miter_limit;
+    S2D_Color color;
+  } tessellated_style;
+  Uint32 appended_version;  // version after points were last appended
+  int append_from;          // first point appended since tessellating
+  int stable_vertices;      // vertices before the last segment, kept when appending
+} S2D_Polyline;
+
+// S2D_Polygon, a filled polygon, tessellated into triangles when drawn and
+// kept until its points change
+typedef struct {
+  S2D_Vec2f *points;
+  int count;
+  int capacity;
+  S2D_Color color;
+  Uint32 version;  // incremented when points change, to tessellate again
+  int *indices;    // of the points, three for each triangle
+  S2D_Vertex *vertices;
+  int vertex_count;
+  int vertex_capacity;
+  Uint32 tessellated_version;
+  S2D_Color tessellated_color;
+} S2D_Polygon;
+
+// S2D_SDFGlyph, a glyph's cell in a signed distance field atlas
+typedef struct {
+  bool provided;  // whether the font has this glyph
+  int width;      // cell width in atlas pixels, including the spread
+  int height;     // cell height in atlas pixels, including the spread
+  int advance;    // horizontal pen advance at the base size
+  GLfloat tx1;
+  GLfloat ty1;
+  GLfloat tx2;
+  GLfloat ty2;
+} S2D_SDFGlyph;
+
+// S2D_SDFFont, a signed distance field glyph atlas, shared by all text using
+// the same font file and rendered at any size with a single texture
+typedef struct S2D_SDFFont {
+  char *path;
+  TTF_Font *font_data;  // kept open to add glyphs on demand
+  GLuint texture_id;
+  Uint8 *pixels;  // atlas distance values, kept for uploading
+  bool dirty;     // glyphs were added since the texture was uploaded
+  int pen_x;      // where the next glyph cell is packed in the atlas
+  int pen_y;
+  int row_height;
+  int line_height;
+  S2D_SDFGlyph glyphs[256];  // Latin-1 glyphs
+  Uint16 *extra_codes;  // hash table of other glyphs, added as they're used
+  S2D_SDFGlyph *extra_glyphs;
+  int extra_count;
+  int extra_capacity;
+  int refs;
+  struct S2D_SDFFont *next;
+} S2D_SDFFont;
+
 // S2D_Text
 typedef struct {
-  const char *font;
+  char *font;  // copy of the font file path
   SDL_Surface *surface;
   GLuint texture_id;
   TTF_Font *font_data;
   S2D_Color color;
+  S2D_SDFFont *sdf;  // glyph atlas, if created with `S2D_CreateSDFText`
+  GLfloat *quads;    // SDF glyph quads and texture coordinates, at the base size
+  int quad_count;
+  int quad_capacity;
+  GLfloat size;
   char *msg;
+  size_t msg_capacity;     // Bytes allocated for `msg`
+  char *next_msg;          // Formatted into by `S2D_SetText`, then swapped with `msg`
+  size_t next_msg_capacity;
+  Uint32 renders_skipped;  // Times `S2D_SetText` kept the texture as the message didn't change
   int x;
   int y;
   int width;
@@ -360,6 +707,44 @@ typedef struct {
   GLfloat ry;      // Y coordinate to be rotated around
 } S2D_Text;
 
+// S2D_TextParagraph, text up to a newline, wrapped into one or more lines
+typedef struct {
+  int start;       // byte offset in the layout text
+  int length;      // length in bytes, not including the newline
+  bool dirty;      // needs to be laid out again
+  GLfloat *quads;  // glyph quads relative to the paragraph, at the base size
+  int quad_count;
+  int quad_capacity;
+  int lines;       // number of wrapped lines
+  GLfloat width;   // width of the widest line, at the base size
+  GLfloat y;       // offset from the top of the layout, at the base size
+} S2D_TextParagraph;
+
+// S2D_TextLayout, retained multi-line UTF-8 text which is only laid out again
+// where it changes
+typedef struct {
+  char *font;  // copy of the font file path
+  S2D_SDFFont *sdf;
+  char *text;  // UTF-8 text
+  int length;
+  int capacity;
+  S2D_TextParagraph *paragraphs;
+  int paragraph_count;
+  int paragraph_capacity;
+  GLfloat size;
+  GLfloat wrap_width;  // width to wrap lines at, 0 to not wrap
+  int align;
+  S2D_Color color;
+  GLfloat x;
+  GLfloat y;
+  GLfloat width;   // measured at the current size
+  GLfloat height;
+  GLfloat clip_y;  // only lines overlapping this range are drawn, if
+  GLfloat clip_height;  // the height isn't 0; relative to the layout
+  bool dirty;  // changed since the last update
+  Uint32 paragraphs_laid_out;  // running count, for checking what edits cost
+} S2D_TextLayout;
+
 // S2D_Sound
 typedef struct {
   const char *path;
@@ -488,6 +873,48 @@ void S2D_DrawCircle(
   GLfloat r, GLfloat g, GLfloat b, GLfloat a
 );
 
+/*
+ * Draw a line `width` wide with its edges smoothed over about a pixel, using a
+ * few more triangles instead of multisampling. Lines thinner than a pixel are
+ * drawn a pixel wide and fainter.
+ */
+void S2D_DrawSmoothLine(
+  GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2,
+  GLfloat width, S2D_Color color
+);
+
+/*
+ * Draw a filled rectangle with its edges smoothed over about a pixel
+ */
+void S2D_DrawSmoothRect(S2D_FRect rect, S2D_Color color);
+
+/*
+ * Get the points of a unit circle divided into `sectors`, as x, y pairs from
+ * angle 0 around to the first point again. Computed once for each number of
+ * sectors, and kept.
+ */
+const GLfloat *S2D_GetUnitCircle(int sectors);
+
+/*
+ * Draw a filled circle as a single quad, shaded by the distance to its edge so
+ * it's smooth at any size
+ */
+void S2D_DrawDisc(GLfloat x, GLfloat y, GLfloat radius, S2D_Color color);
+
+/*
+ * Draw a ring as a single quad, `thickness` wide inside its radius
+ */
+void S2D_DrawRing(GLfloat x, GLfloat y, GLfloat radius, GLfloat thickness, S2D_Color color);
+
+/*
+ * Draw an arc of a ring as a single quad, from angle `start` to `end` in degrees
+ * clockwise from the right. With `thickness` 0, it's filled to the center.
+ */
+void S2D_DrawArc(
+  GLfloat x, GLfloat y, GLfloat radius, GLfloat thickness,
+  GLfloat start, GLfloat end, S2D_Color color
+);
+
 /*
  * Draw a rectangle, using two triangles. Simplified version of quad
  */
@@ -497,6 +924,86 @@ void S2D_DrawRect(S2D_FRect rect, S2D_Color color, bool filled);
  */
 void S2D_DrawRect_XYWH(GLfloat x, GLfloat y, GLfloat width, GLfloat height, S2D_Color color, bool filled);
 
+/*
+ * Draw triangles from an array of vertices, three for each triangle, copied
+ * into the batch together
+ */
+void S2D_DrawTriangles(const S2D_Vertex *vertices, int count);
+
+/*
+ * Draw an array of filled rectangles, each in the color of the same index
+ */
+void S2D_DrawRects(const S2D_FRect *rects, const S2D_Color *colors, int count);
+
+/*
+ * Draw an array of lines `width` wide, from pairs of points, each line in the
+ * color of the same index
+ */
+void S2D_DrawLines(const S2D_Vec2f *points, const S2D_Color *colors, int count, GLfloat width);
+
+// Polyline ////////////////////////////////////////////////////////////////////
+
+/*
+ * Create a polyline with no points, `width` wide, mitered with butt caps
+ */
+S2D_Polyline *S2D_CreatePolyline(GLfloat width, S2D_Color color);
+
+/*
+ * Replace the points of a polyline. Points repeating the one before are
+ * skipped. After changing `points` directly, increment `version`.
+ */
+void S2D_SetPolylinePoints(S2D_Polyline *line, const S2D_Vec2f *points, int count);
+
+/*
+ * Add points to the end of a polyline, so only its end is tessellated again
+ */
+void S2D_AppendPolylinePoints(S2D_Polyline *line, const S2D_Vec2f *points, int count);
+
+/*
+ * Draw a polyline, tessellating it first if its points or style changed
+ */
+void S2D_DrawPolyline(S2D_Polyline *line);
+
+/*
+ * Free a polyline
+ */
+void S2D_FreePolyline(S2D_Polyline *line);
+
+// Polygon /////////////////////////////////////////////////////////////////////
+
+/*
+ * Triangulate a simple polygon, with points wound either way and no holes,
+ * writing three indices of `points` for each triangle to `indices`, which has
+ * room for (count - 2) * 3. Returns the number of triangles.
+ */
+int S2D_TessellatePolygon(const S2D_Vec2f *points, int count, int *indices);
+
+/*
+ * Draw a filled polygon, tessellating it each time it's drawn
+ */
+void S2D_DrawPolygon(const S2D_Vec2f *points, int count, S2D_Color color);
+
+/*
+ * Create a polygon, kept tessellated between draws
+ */
+S2D_Polygon *S2D_CreatePolygon(const S2D_Vec2f *points, int count, S2D_Color color);
+
+/*
+ * Replace the points of a polygon. After changing `points` directly,
+ * increment `version`.
+ */
+void S2D_SetPolygonPoints(S2D_Polygon *polygon, const S2D_Vec2f *points, int count);
+
+/*
+ * Draw a polygon, tessellating it first if its points changed
+ */
+void S2D_DrawCachedPolygon(S2D_Polygon *polygon);
+
+/*
+ * Free a polygon
+ */
+void S2D_FreePolygon(S2D_Polygon *polygon);
+
 // Image ///////////////////////////////////////////////////////////////////////
 
 /*
@@ -504,6 +1011,12 @@ void S2D_DrawRect_XYWH(GLfloat x, GLfloat y, GLfloat width, GLfloat height, S2D_
  */
 S2D_Image *S2D_CreateImage(const char *path);
 
+/*
+ * Create images from files, decoding them in parallel, returning the number
+ * created. Images which can't be created are set to NULL.
+ */
+int S2D_CreateImages(const char **paths, int count, S2D_Image **images);
+
 /*
  * Rotate an image
  */
@@ -541,11 +1054,259 @@ void S2D_RotateSprite(S2D_Sprite *spr, GLfloat angle, int position);
  */
 void S2D_DrawSprite(S2D_Sprite *spr);
 
+/*
+ * Draw many sprites at once, generating their vertices on the job workers.
+ * Consecutive sprites with the same image are drawn with one draw call.
+ */
+void S2D_DrawSprites(S2D_Sprite **sprites, int count);
+
 /*
  * Free a sprite
  */
 void S2D_FreeSprite(S2D_Sprite *spr);
 
+// Camera //////////////////////////////////////////////////////////////////////
+
+/*
+ * View the world through a camera, or without one if NULL. The camera applies
+ * to everything drawn after, including in later frames.
+ */
+void S2D_SetCamera(const S2D_Camera *camera);
+
+/*
+ * Save the current camera and view through another, like NULL for overlays
+ * drawn in window coordinates. Pushes must be balanced by pops.
+ */
+void S2D_PushCamera(const S2D_Camera *camera);
+
+/*
+ * Go back to the camera saved by the last push
+ */
+void S2D_PopCamera();
+
+/*
+ * Convert a point in the window, like the mouse position, to the world
+ */
+S2D_Vec2f S2D_CameraToWorld(S2D_Window *window, const S2D_Camera *camera, float x, float y);
+
+// Sorted Draws ////////////////////////////////////////////////////////////////
+
+/*
+ * Set the layer and depth of later draws, when `sorted_draws` is enabled on
+ * the window. Draws are sorted by layer, then depth, both from 0 up, then by
+ * shader and texture so draws sharing a texture are batched. Draws with the
+ * same sort key stay in the order they were made. Layers are 0 to 255, and
+ * depths 0 to 65535.
+ */
+void S2D_SetDrawLayer(int layer, int depth);
+
+/*
+ * Add a draw to be sorted, returning it to be filled in
+ */
+S2D_DrawCommand *S2D_QueueDraw(int type, GLuint texture_id);
+
+/*
+ * Add data to the queued draws, like glyph quads, returning its offset
+ */
+int S2D_QueueDrawData(const GLfloat *data, int count);
+
+/*
+ * Submit the queued draws, sorted if `sort` is true, then clear the queue.
+ * Draws are only sorted between calls, which are submitted where they were
+ * queued.
+ */
+void S2D_SubmitDraws(S2D_SubmitDraw submit, bool sort);
+
+/*
+ * Queue later draws into the other of two draw lists, leaving the draws queued
+ * so far to be submitted while they're made. With `double_buffered` false,
+ * draws are submitted from the list they're queued into.
+ */
+void S2D_SwapDrawLists(bool double_buffered);
+
+// Render Thread ///////////////////////////////////////////////////////////////
+
+/*
+ * Start drawing frames of the window on a render thread, which the OpenGL
+ * context is moved to. Frames are made on the calling thread, queuing draws
+ * and calls, and the last one is drawn while the next is made. Resources drawn
+ * in a frame can't be changed or freed until the next one.
+ */
+int S2D_StartRenderThread(S2D_Window *window);
+
+/*
+ * Draw the last frame and stop the render thread, moving the OpenGL context
+ * back to the calling thread
+ */
+void S2D_StopRenderThread(S2D_Window *window);
+
+/*
+ * Hand the frame made to the render thread, after waiting for the one before
+ * to be drawn
+ */
+void S2D_SubmitFrame(S2D_Window *window);
+
+/*
+ * Check if the calling thread makes frames for a render thread, rather than
+ * drawing them itself
+ */
+bool S2D_RecordingFrame();
+
+/*
+ * Check if the calling thread is the render thread
+ */
+bool S2D_OnRenderThread();
+
+/*
+ * Queue a call to run on the render thread, in order with the frame's draws,
+ * returning false if the calling thread draws frames itself. Up to 64 bytes
+ * of arguments are copied.
+ */
+bool S2D_DeferRenderCall(S2D_RenderCall fn, const void *args, int size);
+
+/*
+ * Run a call on the render thread between frames and wait for it, returning
+ * false if the calling thread draws frames itself
+ */
+bool S2D_InvokeRenderCall(S2D_RenderCall fn, void *args);
+
+// Jobs ////////////////////////////////////////////////////////////////////////
+
+/*
+ * Start a pool of worker threads jobs are run on, each taking jobs from the
+ * back of its own queue and stealing from the front of others when it runs
+ * out. With `workers` 0, there's one for each CPU core but the calling thread,
+ * and with a negative number there are none, running jobs on the threads
+ * waiting for them. Starts itself with the default when a job is first run.
+ */
+int S2D_InitJobs(int workers);
+
+/*
+ * Stop the worker threads, running any jobs left on the calling thread
+ */
+void S2D_QuitJobs();
+
+/*
+ * Get the number of worker threads
+ */
+int S2D_GetJobWorkers();
+
+/*
+ * Run a job on the pool, counting it in `counter` until it's done, which can
+ * be NULL. Threads waiting for jobs help run them, so jobs are also run
+ * without workers.
+ */
+void S2D_RunJob(S2D_JobFunc fn, void *data, S2D_JobCounter *counter);
+
+/*
+ * Run a job once the jobs counted in `after` are done
+ */
+void S2D_RunJobAfter(S2D_JobCounter *after, S2D_JobFunc fn, void *data, S2D_JobCounter *counter);
+
+/*
+ * Wait for the jobs counted in `counter` to be done, running jobs meanwhile
+ */
+void S2D_WaitJobs(S2D_JobCounter *counter);
+
+/*
+ * Call `fn` for ranges of up to `grain` indices from 0 up to `count`, in
+ * parallel, and wait for all of them. With `grain` 0, ranges are sized so each
+ * thread gets a few.
+ */
+void S2D_ParallelFor(int count, int grain, S2D_RangeFunc fn, void *data);
+
+// Transforms //////////////////////////////////////////////////////////////////
+
+/*
+ * Get the corners of quads rotated around their points, as 8 floats per quad:
+ * x, y of the top-left, top-right, bottom-right, and bottom-left corners
+ */
+void S2D_TransformQuads(const S2D_QuadArrays *quads, int count, GLfloat *corners);
+
+/*
+ * Choose the kernel used by `S2D_TransformQuads`, returning false if the CPU
+ * can't run it. The fastest is chosen by default.
+ */
+bool S2D_SetQuadKernel(int kernel);
+
+/*
+ * Get the kernel used by `S2D_TransformQuads`
+ */
+int S2D_GetQuadKernel();
+
+/*
+ * Get the name of a quad kernel
+ */
+const char *S2D_QuadKernelName(int kernel);
+
+// Render Target ///////////////////////////////////////////////////////////////
+
+/*
+ * Create a render target of the given size in pixels. Its framebuffer is taken
+ * from the pool of freed targets of the same size, if there is one.
+ */
+S2D_RenderTarget *S2D_CreateRenderTarget(int width, int height);
+
+/*
+ * Begin drawing to a render target, clearing it. Draw calls go to the target
+ * until `S2D_EndRenderTarget` is called. Targets can be nested.
+ */
+void S2D_BeginRenderTarget(S2D_RenderTarget *target);
+
+/*
+ * End drawing to a render target, going back to the previous target or window
+ */
+void S2D_EndRenderTarget(S2D_RenderTarget *target);
+
+/*
+ * Draw a render target
+ */
+void S2D_DrawRenderTarget(S2D_RenderTarget *target);
+
+/*
+ * Free a render target, returning its framebuffer to the pool
+ */
+void S2D_FreeRenderTarget(S2D_RenderTarget *target);
+
+/*
+ * Free the framebuffers in the render target pool
+ */
+void S2D_ClearRenderTargetPool();
+
+// Mesh ////////////////////////////////////////////////////////////////////////
+
+/*
+ * Create an empty mesh
+ */
+S2D_Mesh *S2D_CreateMesh();
+
+/*
+ * Begin recording draws into a mesh, replacing what it had. Shapes, images,
+ * sprites, and text drawn until `S2D_EndMesh` are added to the mesh instead of
+ * drawn. Textures must outlive the mesh. Distance field text can't be recorded.
+ */
+void S2D_BeginMesh(S2D_Mesh *mesh);
+
+/*
+ * End recording draws into a mesh
+ */
+void S2D_EndMesh(S2D_Mesh *mesh);
+
+/*
+ * Add vertices to the mesh being recorded, drawn with a texture, or none if 0
+ */
+void S2D_AddMeshVertices(S2D_Mesh *mesh, GLuint texture_id, const GLfloat *vertices, int count);
+
+/*
+ * Draw a mesh, translated, then rotated and scaled around its rotation point
+ */
+void S2D_DrawMesh(S2D_Mesh *mesh);
+
+/*
+ * Free a mesh
+ */
+void S2D_FreeMesh(S2D_Mesh *mesh);
+
 // Text ////////////////////////////////////////////////////////////////////////
 
 /*
@@ -554,8 +1315,21 @@ void S2D_FreeSprite(S2D_Sprite *spr);
 S2D_Text *S2D_CreateText(const char *font, const char *msg, int size);
 
 /*
-* Set the text message
-*/
+ * Create text rendered from a signed distance field glyph atlas, which stays
+ * crisp at any size, scale, or rotation. The atlas is shared by all text using
+ * the same font file.
+ */
+S2D_Text *S2D_CreateSDFText(const char *font, const char *msg, int size);
+
+/*
+ * Set the text size in pixels; free for SDF text, other text reopens the font
+ */
+void S2D_SetTextSize(S2D_Text *txt, GLfloat size);
+
+/*
+ * Set the text message; if the formatted message is the same as the current
+ * one, the texture is kept and `renders_skipped` is incremented
+ */
 void S2D_SetText(S2D_Text *txt, const char *msg, ...);
 
 /*
@@ -573,6 +1347,50 @@ void S2D_DrawText(S2D_Text *txt);
  */
 void S2D_FreeText(S2D_Text *txt);
 
+/*
+ * Create a text layout, given a font file path, size, the width to wrap lines
+ * at (0 to not wrap), and the alignment of lines: S2D_ALIGN_LEFT,
+ * S2D_ALIGN_CENTER, or S2D_ALIGN_RIGHT. Without a wrap width, lines are aligned
+ * around the layout's `x` position.
+ */
+S2D_TextLayout *S2D_CreateTextLayout(const char *font, int size, GLfloat wrap_width, int align);
+
+/*
+ * Replace all text in a layout, given UTF-8 text
+ */
+void S2D_SetLayoutText(S2D_TextLayout *layout, const char *text);
+
+/*
+ * Replace `length` bytes of the layout text from byte `start` with UTF-8 text;
+ * only the paragraphs touched are laid out again
+ */
+void S2D_EditLayoutText(S2D_TextLayout *layout, int start, int length, const char *text);
+
+/*
+ * Append UTF-8 text to the end of a layout
+ */
+void S2D_AppendLayoutText(S2D_TextLayout *layout, const char *text);
+
+/*
+ * Set the size, wrap width, and alignment of a layout
+ */
+void S2D_SetLayoutStyle(S2D_TextLayout *layout, int size, GLfloat wrap_width, int align);
+
+/*
+ * Lay out changed paragraphs and measure the layout; called when drawing
+ */
+void S2D_UpdateTextLayout(S2D_TextLayout *layout);
+
+/*
+ * Draw a text layout
+ */
+void S2D_DrawTextLayout(S2D_TextLayout *layout);
+
+/*
+ * Free a text layout
+ */
+void S2D_FreeTextLayout(S2D_TextLayout *layout);
+
 // Sound ///////////////////////////////////////////////////////////////////////
 
 /*
@@ -664,6 +1482,70 @@ void S2D_FreeMusic(S2D_Music *mus);
  */
 void S2D_GetMouseOnViewport(S2D_Window *window, int wx, int wy, int *x, int *y);
 
+/*
+ * Mark a key as held down or released, given its scancode
+ */
+void S2D_SetKeyHeld(int scancode, bool held);
+
+/*
+ * Get the scancodes of keys held down, returning how many there are
+ */
+int S2D_GetHeldKeys(const int **scancodes);
+
+/*
+ * Start a new frame of polled input, clearing keys and buttons pressed or
+ * released in the last one
+ */
+void S2D_BeginInputFrame();
+
+/*
+ * Update polled input state from an event of a device (S2D_KEYBOARD,
+ * S2D_MOUSE, or S2D_CONTROLLER), and call the window's callback for it
+ */
+void S2D_DispatchInput(S2D_Window *window, int device, S2D_Event e);
+
+/*
+ * Check if a key is held down, given its scancode
+ */
+bool S2D_IsKeyDown(int scancode);
+
+/*
+ * Check if a key was pressed since the last frame. With a fixed timestep, it's
+ * since the last update, so each press is seen by one update.
+ */
+bool S2D_WasKeyPressed(int scancode);
+
+/*
+ * Check if a key was released since the last frame
+ */
+bool S2D_WasKeyReleased(int scancode);
+
+/*
+ * Check if a mouse button is held down, e.g. S2D_MOUSE_LEFT
+ */
+bool S2D_IsMouseButtonDown(int button);
+
+/*
+ * Check if a mouse button was pressed since the last frame
+ */
+bool S2D_WasMouseButtonPressed(int button);
+
+/*
+ * Check if a mouse button was released since the last frame
+ */
+bool S2D_WasMouseButtonReleased(int button);
+
+/*
+ * Get the polled state of a controller, given its joystick instance ID;
+ * NULL if no input was seen from it
+ */
+const S2D_ControllerState *S2D_GetControllerState(int which);
+
+/*
+ * Forget the state of a removed controller
+ */
+void S2D_RemoveControllerState(int which);
+
 /*
  * Show the cursor over the window
  */
@@ -715,11 +1597,22 @@ int S2D_Show(S2D_Window *window);
  */
 void S2D_SetIcon(S2D_Window *window, const char *icon);
 
+/*
+ * Draw the queued frame and present it, on the render thread
+ */
+void S2D_PresentFrame(S2D_Window *window);
+
 /*
  * Take a screenshot of the window
  */
 void S2D_Screenshot(S2D_Window *window, const char *path);
 
+/*
+ * Take a screenshot of the window at the end of the current frame, reading
+ * and saving it in the background
+ */
+void S2D_ScreenshotAsync(S2D_Window *window, const char *path);
+
 /*
  * Close the window
  */
@@ -730,6 +1623,96 @@ int S2D_Close(S2D_Window *window);
  */
 int S2D_FreeWindow(S2D_Window *window);
 
+// Capture /////////////////////////////////////////////////////////////////////
+
+/*
+ * Start capturing frames of a window to a Y4M video file, a command the video
+ * is piped to (a path starting with `|`), or a sequence of PNG images (a path
+ * with a frame number, like `frame_%05d.png`); `options` can be NULL
+ */
+int S2D_StartCapture(S2D_Window *window, const char *path, const S2D_CaptureOptions *options);
+
+/*
+ * Stop capturing frames, waiting for captured ones to be written; called when
+ * the window's main loop ends
+ */
+void S2D_StopCapture(S2D_Window *window);
+
+/*
+ * Get stats of the current or last capture
+ */
+void S2D_GetCaptureStats(S2D_CaptureStats *stats);
+
+/*
+ * Save RGBA pixels, bottom row first as read from OpenGL, to an opaque PNG file
+ */
+int S2D_SavePixelsPNG(const Uint8 *pixels, int w, int h, const char *path);
+
+/*
+ * Request the pixels of the current frame, given a function to call with them
+ * (RGBA, bottom row first) once read; the function takes ownership of them,
+ * and is called with NULL if they couldn't be read
+ */
+void S2D_ReadbackFrame(S2D_Window *window, S2D_CaptureDone done, void *data);
+
+/*
+ * Start requested readbacks and finish earlier ones; called after the frame
+ * is drawn, before the window is swapped
+ */
+void S2D_UpdateCapture(S2D_Window *window);
+
+/*
+ * Finish all readbacks and wait for screenshots to be saved
+ */
+void S2D_FinishCaptures();
+
+// Replay //////////////////////////////////////////////////////////////////////
+
+/*
+ * Open the replay file of a window, given by `record_path` or `replay_path`
+ */
+bool S2D_OpenReplay(S2D_Window *window);
+
+/*
+ * Add an input event to the frame being recorded
+ */
+void S2D_RecordInput(S2D_Window *window, int device, S2D_Event e);
+
+/*
+ * Write the frame being recorded, given its delta time
+ */
+void S2D_WriteReplayFrame(S2D_Window *window, float dt);
+
+/*
+ * Read the next frame being played back and dispatch its input events;
+ * returns false and closes the window when the replay ends
+ */
+bool S2D_ReadReplayFrame(S2D_Window *window);
+
+/*
+ * Close the replay file
+ */
+void S2D_CloseReplay(S2D_Window *window);
+
+// Frame Stats /////////////////////////////////////////////////////////////////
+
+/*
+ * Record the times of a frame, given performance counter values at the start
+ * of each stage and at the end of the swap
+ */
+void S2D_RecordFrame(S2D_Window *window, const Uint64 t[S2D_STAGE_COUNT]);
+
+/*
+ * Get stats of a frame stage over the last `frames` frames (0 for all kept),
+ * returning the number of frames measured
+ */
+int S2D_GetFrameStats(S2D_Window *window, int stage, int frames, S2D_FrameStats *stats);
+
+/*
+ * Write the times of recent frames to a CSV file
+ */
+int S2D_DumpFrameStats(S2D_Window *window, const char *path);
+
 // Simple 2D OpenGL Functions //////////////////////////////////////////////////
 
 int S2D_GL_Init(S2D_Window *window);
@@ -740,10 +1723,17 @@ GLuint S2D_GL_LoadShader(GLenum type, const GLchar *shaderSrc, char *shaderName)
 int S2D_GL_CheckLinked(GLuint program, char *name);
 void S2D_GL_GetViewportScale(S2D_Window *window, int *w, int *h, double *scale);
 void S2D_GL_SetViewport(S2D_Window *window);
+void S2D_GL_SetCamera(const S2D_Camera *camera);
+GLfloat S2D_GL_GetPixelSize();
+void S2D_GL_BindDefaultFramebuffer();
+int S2D_GL_CreateFramebuffer(GLuint *fbo, GLuint *texture, int w, int h);
+void S2D_GL_FreeFramebuffer(GLuint *fbo, GLuint *texture);
+void S2D_GL_BindFramebuffer(GLuint fbo, int w, int h);
 void S2D_GL_CreateTexture(
   GLuint *id, GLint format,
   int w, int h,
   const GLvoid *data, GLint filter);
+void S2D_GL_CreateAlphaTexture(GLuint *id, int w, int h, const GLvoid *data);
 void S2D_GL_DrawTriangle(
   GLfloat x1, GLfloat y1,
   GLfloat r1, GLfloat g1, GLfloat b1, GLfloat a1,
@@ -751,10 +1741,25 @@ void S2D_GL_DrawTriangle(
   GLfloat r2, GLfloat g2, GLfloat b2, GLfloat a2,
   GLfloat x3, GLfloat y3,
   GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3);
+void S2D_GL_DrawTriangles(const S2D_Vertex *vertices, int count);
+void S2D_GL_DrawShape(
+  GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+  GLfloat start, GLfloat end, S2D_Color color);
 void S2D_GL_DrawImage(S2D_Image *img);
 void S2D_GL_DrawSprite(S2D_Sprite *spr);
+void S2D_GL_DrawSprites(S2D_Sprite **sprites, int count);
 void S2D_GL_DrawText(S2D_Text *txt);
+void S2D_GL_DrawGlyphs(
+  GLuint texture_id, const GLfloat *quads, int count,
+  GLfloat x, GLfloat y, GLfloat scale,
+  GLfloat angle, GLfloat rx, GLfloat ry,
+  S2D_Color color, GLfloat smoothing);
 void S2D_GL_FreeTexture(GLuint *id);
+void S2D_GL_EndFrame(S2D_Window *window);
+void S2D_GL_CountDrawCalls(int count);
+void S2D_GL_RecordMesh(S2D_Mesh *mesh);
+void S2D_GL_DrawMesh(S2D_Mesh *mesh);
+void S2D_GL_FreeMesh(S2D_Mesh *mesh);
 void S2D_GL_Clear(S2D_Color clr);
 void S2D_GL_FlushBuffers();
 
@@ -770,13 +1775,23 @@ void S2D_GL_FlushBuffers();
     GLfloat r2, GLfloat g2, GLfloat b2, GLfloat a2,
     GLfloat x3, GLfloat y3,
     GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3);
+  void S2D_GLES_DrawShape(
+    GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+    GLfloat start, GLfloat end, S2D_Color color);
+  void S2D_GLES_FlushBuffers();
   void S2D_GLES_DrawImage(S2D_Image *img);
   void S2D_GLES_DrawSprite(S2D_Sprite *spr);
   void S2D_GLES_DrawText(S2D_Text *txt);
+  void S2D_GLES_DrawGlyphs(
+    GLuint texture_id, const GLfloat *quads, int count,
+    GLfloat x, GLfloat y, GLfloat scale,
+    GLfloat angle, GLfloat rx, GLfloat ry,
+    S2D_Color color, GLfloat smoothing);
+  void S2D_GLES_DrawMesh(S2D_Mesh *mesh, GLfloat mvpMatrix[16]);
 #else
   int S2D_GL2_Init();
   int S2D_GL3_Init();
-  void S2D_GL2_ApplyProjection(int w, int h);
+  void S2D_GL2_ApplyProjection(GLfloat orthoMatrix[16]);
   void S2D_GL3_ApplyProjection(GLfloat orthoMatrix[16]);
   void S2D_GL2_DrawTriangle(
     GLfloat x1, GLfloat y1,
@@ -792,12 +1807,29 @@ void S2D_GL_FlushBuffers();
     GLfloat r2, GLfloat g2, GLfloat b2, GLfloat a2,
     GLfloat x3, GLfloat y3,
     GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3);
+  void S2D_GL3_DrawTriangles(const S2D_Vertex *vertices, int count);
+  void S2D_GL3_DrawShape(
+    GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+    GLfloat start, GLfloat end, S2D_Color color);
   void S2D_GL2_DrawImage(S2D_Image *img);
   void S2D_GL3_DrawImage(S2D_Image *img);
   void S2D_GL2_DrawSprite(S2D_Sprite *spr);
   void S2D_GL3_DrawSprite(S2D_Sprite *spr);
+  void S2D_GL3_DrawSprites(S2D_Sprite **sprites, int count);
   void S2D_GL2_DrawText(S2D_Text *txt);
   void S2D_GL3_DrawText(S2D_Text *txt);
+  void S2D_GL2_DrawGlyphs(
+    GLuint texture_id, const GLfloat *quads, int count,
+    GLfloat x, GLfloat y, GLfloat scale,
+    GLfloat angle, GLfloat rx, GLfloat ry,
+    S2D_Color color);
+  void S2D_GL3_DrawGlyphs(
+    GLuint texture_id, const GLfloat *quads, int count,
+    GLfloat x, GLfloat y, GLfloat scale,
+    GLfloat angle, GLfloat rx, GLfloat ry,
+    S2D_Color color);
+  void S2D_GL2_DrawMesh(S2D_Mesh *mesh, GLfloat modelMatrix[16]);
+  void S2D_GL3_DrawMesh(S2D_Mesh *mesh, GLfloat mvpMatrix[16]);
   void S2D_GL3_FlushBuffers();
 #endif
 
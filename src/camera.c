@@ -0,0 +1,87 @@
+// camera.c
+
+#include "../include/simple2d.h"
+
+// Cameras saved by pushes, and the current one
+static S2D_Camera stack[S2D_CAMERA_STACK_SIZE];
+static bool stack_has_camera[S2D_CAMERA_STACK_SIZE];
+static int depth = 0;
+
+
+/*
+ * Check a camera can be viewed through
+ */
+static bool S2D_CheckCamera(const char *caller, const S2D_Camera *camera) {
+  if (camera && camera->zoom <= 0) {
+    S2D_Error(caller, "Camera zoom must be greater than 0, not %f", camera->zoom);
+    return false;
+  }
+  return true;
+}
+
+
+/*
+ * View the world through a camera, or without one if NULL
+ */
+void S2D_SetCamera(const S2D_Camera *camera) {
+  if (!S2D_CheckCamera("S2D_SetCamera", camera)) return;
+
+  stack_has_camera[depth] = camera != NULL;
+  if (camera) stack[depth] = *camera;
+
+  S2D_GL_SetCamera(camera);
+}
+
+
+/*
+ * Save the current camera and view through another
+ */
+void S2D_PushCamera(const S2D_Camera *camera) {
+  if (!S2D_CheckCamera("S2D_PushCamera", camera)) return;
+
+  if (depth == S2D_CAMERA_STACK_SIZE - 1) {
+    S2D_Error("S2D_PushCamera", "Too many cameras pushed");
+    return;
+  }
+
+  depth++;
+  S2D_SetCamera(camera);
+}
+
+
+/*
+ * Go back to the camera saved by the last push
+ */
+void S2D_PopCamera() {
+  if (depth == 0) {
+    S2D_Error("S2D_PopCamera", "No camera to pop");
+    return;
+  }
+
+  depth--;
+  S2D_GL_SetCamera(stack_has_camera[depth] ? &stack[depth] : NULL);
+}
+
+
+/*
+ * Convert a point in the window, like the mouse position, to the world
+ */
+S2D_Vec2f S2D_CameraToWorld(S2D_Window *window, const S2D_Camera *camera, float x, float y) {
+  S2D_Vec2f p = { x, y };
+  if (!window || !camera || camera->zoom <= 0) return p;
+
+  // The size of the view, as set up by `S2D_GL_SetViewport`
+  bool expand = window->viewport.mode == S2D_EXPAND;
+  float w = expand ? window->width  : window->viewport.width;
+  float h = expand ? window->height : window->viewport.height;
+
+  // Undo the zoom and rotation around the center of the view
+  float rad = camera->rotate * M_PI / 180.0;
+  float sa = sin(rad), ca = cos(rad);
+  float dx = (x - w / 2) / camera->zoom;
+  float dy = (y - h / 2) / camera->zoom;
+
+  p.x = camera->x + dx * ca - dy * sa;
+  p.y = camera->y + dx * sa + dy * ca;
+  return p;
+}
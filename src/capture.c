@@ -0,0 +1,633 @@
+// capture.c
+
+#include "../include/simple2d.h"
+
+// Number of pixel pack buffers frames are read into, and how many frames a
+// readback is left before its buffer is mapped
+#define S2D_CAPTURE_SLOTS 3
+#define S2D_CAPTURE_LATENCY 2
+
+// A readback of a frame, waiting for its pixels
+typedef struct {
+  S2D_CaptureDone done;  // called with the pixels when they're read
+  void *data;
+  int width;
+  int height;
+  Uint32 frame;  // frame the readback was started on
+  bool busy;
+  #if !GLES
+    GLuint pbo;
+  #endif
+} S2D_CaptureSlot;
+
+// Screenshot to be encoded on the worker thread
+typedef struct S2D_CaptureJob {
+  Uint8 *pixels;  // RGBA, bottom row first
+  int width;
+  int height;
+  char *path;
+  struct S2D_CaptureJob *next;
+} S2D_CaptureJob;
+
+static S2D_CaptureSlot slots[S2D_CAPTURE_SLOTS];
+static Uint32 capture_frame = 0;
+
+// Readbacks requested for the current frame
+static S2D_CaptureSlot *requests = NULL;
+static int request_count = 0;
+static int request_capacity = 0;
+
+// Worker thread flipping and encoding screenshots
+static SDL_Thread *worker = NULL;
+static SDL_mutex *worker_lock = NULL;
+static SDL_cond *worker_cond = NULL;
+static S2D_CaptureJob *jobs_head = NULL;
+static S2D_CaptureJob *jobs_tail = NULL;
+static bool worker_quit = false;
+
+#if WINDOWS
+  #define popen  _popen
+  #define pclose _pclose
+#endif
+
+#define S2D_CAPTURE_MAX_WORKERS 16
+
+// Captured frame waiting to be encoded
+typedef struct S2D_CaptureFrame {
+  Uint8 *pixels;  // RGBA, bottom row first
+  Uint32 index;
+  struct S2D_CaptureFrame *next;
+} S2D_CaptureFrame;
+
+// Continuous capture of frames, one at a time
+static struct {
+  bool active;
+  S2D_CaptureOptions options;
+  char *path;
+  FILE *file;  // video file or pipe
+  bool pipe;
+  int width;
+  int height;
+  Uint8 *yuv;  // video frame being written
+  Uint32 frame;  // frames drawn since the capture started
+  SDL_Thread *threads[S2D_CAPTURE_MAX_WORKERS];
+  int thread_count;
+  SDL_mutex *lock;  // guards everything below
+  SDL_cond *cond;
+  S2D_CaptureFrame *head;
+  S2D_CaptureFrame *tail;
+  int queued;  // frames being read back or waiting to be encoded
+  bool quit;
+  S2D_CaptureStats stats;
+} capture;
+
+
+/*
+ * Save RGBA pixels, bottom row first as OpenGL reads them, to an opaque PNG
+ * file, ignoring the alpha of the framebuffer like screenshots always have
+ */
+int S2D_SavePixelsPNG(const Uint8 *pixels, int w, int h, const char *path) {
+
+  SDL_Surface *surface = SDL_CreateRGBSurface(
+    SDL_SWSURFACE, w, h, 32,
+    0x000000FF, 0x0000FF00, 0x00FF0000, 0
+  );
+  if (!surface) {
+    S2D_Error("SDL_CreateRGBSurface", SDL_GetError());
+    return 1;
+  }
+
+  // Flip the image vertically while copying it into the surface
+  int row = w * 4;
+  for (int y = 0; y < h; y++) {
+    memcpy((Uint8 *)surface->pixels + surface->pitch * y, pixels + row * (h - y - 1), row);
+  }
+
+  int result = IMG_SavePNG(surface, path);
+  if (result != 0) S2D_Error("IMG_SavePNG", IMG_GetError());
+  SDL_FreeSurface(surface);
+  return result;
+}
+
+
+/*
+ * Encode screenshots queued for the worker thread
+ */
+static int S2D_CaptureWorker(void *unused) {
+  SDL_LockMutex(worker_lock);
+
+  for (;;) {
+    while (!jobs_head && !worker_quit) SDL_CondWait(worker_cond, worker_lock);
+    if (!jobs_head) break;
+
+    S2D_CaptureJob *job = jobs_head;
+    jobs_head = job->next;
+    if (!jobs_head) jobs_tail = NULL;
+
+    SDL_UnlockMutex(worker_lock);
+    S2D_SavePixelsPNG(job->pixels, job->width, job->height, job->path);
+    free(job->pixels);
+    free(job->path);
+    free(job);
+    SDL_LockMutex(worker_lock);
+  }
+
+  SDL_UnlockMutex(worker_lock);
+  return 0;
+}
+
+
+/*
+ * Queue pixels of a screenshot to be saved by the worker thread, which takes
+ * ownership of them
+ */
+static void S2D_QueueScreenshot(Uint8 *pixels, int w, int h, void *path) {
+
+  // The readback was dropped
+  if (!pixels) {
+    free(path);
+    return;
+  }
+
+  if (!worker) {
+    worker_lock = SDL_CreateMutex();
+    worker_cond = SDL_CreateCond();
+    worker_quit = false;
+    worker = SDL_CreateThread(S2D_CaptureWorker, "S2D_CaptureWorker", NULL);
+  }
+
+  S2D_CaptureJob *job = (S2D_CaptureJob *) malloc(sizeof(S2D_CaptureJob));
+
+  // Save it here if the worker can't be used
+  if (!worker || !job) {
+    S2D_SavePixelsPNG(pixels, w, h, path);
+    free(pixels);
+    free(path);
+    free(job);
+    return;
+  }
+
+  job->pixels = pixels;
+  job->width = w;
+  job->height = h;
+  job->path = path;
+  job->next = NULL;
+
+  SDL_LockMutex(worker_lock);
+  if (jobs_tail) jobs_tail->next = job;
+  else jobs_head = job;
+  jobs_tail = job;
+  SDL_CondSignal(worker_cond);
+  SDL_UnlockMutex(worker_lock);
+}
+
+
+// Arguments of capture calls run on the render thread, which reads frames
+typedef struct {
+  S2D_Window *window;
+  S2D_CaptureDone done;
+  void *data;
+  const char *path;
+  const S2D_CaptureOptions *options;
+  int result;
+} S2D_CaptureArgs;
+
+static void S2D_CallReadbackFrame(void *args) {
+  S2D_CaptureArgs *a = (S2D_CaptureArgs *) args;
+  S2D_ReadbackFrame(a->window, a->done, a->data);
+}
+
+static void S2D_CallStartCapture(void *args) {
+  S2D_CaptureArgs *a = (S2D_CaptureArgs *) args;
+  a->result = S2D_StartCapture(a->window, a->path, a->options);
+}
+
+static void S2D_CallStopCapture(void *window) {
+  S2D_StopCapture((S2D_Window *) window);
+}
+
+
+/*
+ * Request the pixels of the current frame, given a function to call with them
+ * once they're read, which takes ownership of them
+ */
+void S2D_ReadbackFrame(S2D_Window *window, S2D_CaptureDone done, void *data) {
+
+  S2D_CaptureArgs args = { window, done, data };
+  if (S2D_InvokeRenderCall(S2D_CallReadbackFrame, &args)) return;
+
+  if (request_count == request_capacity) {
+    int capacity = request_capacity ? request_capacity * 2 : 4;
+    S2D_CaptureSlot *tmp = (S2D_CaptureSlot *) realloc(requests, capacity * sizeof(S2D_CaptureSlot));
+    if (!tmp) {
+      S2D_Error("S2D_ReadbackFrame", "Out of memory!");
+      return;
+    }
+    requests = tmp;
+    request_capacity = capacity;
+  }
+
+  S2D_CaptureSlot *r = &requests[request_count++];
+  memset(r, 0, sizeof(S2D_CaptureSlot));
+  r->done = done;
+  r->data = data;
+  r->width = window->width;
+  r->height = window->height;
+}
+
+
+/*
+ * Take a screenshot of the window without waiting for it to be read and saved
+ */
+void S2D_ScreenshotAsync(S2D_Window *window, const char *path) {
+  if (!window || !path) return;
+
+  char *p = (char *) malloc(strlen(path) + 1);
+  if (!p) {
+    S2D_Error("S2D_ScreenshotAsync", "Out of memory!");
+    return;
+  }
+  strcpy(p, path);
+
+  S2D_ReadbackFrame(window, S2D_QueueScreenshot, p);
+}
+
+
+/*
+ * Write a frame to a Y4M video, converting it to YUV 4:4:4
+ */
+static bool S2D_WriteY4MFrame(const Uint8 *pixels) {
+  int w = capture.width, h = capture.height;
+  Uint8 *py = capture.yuv, *pu = py + w * h, *pv = pu + w * h;
+
+  // BT.601, limited range; rows are flipped since OpenGL reads bottom-up
+  for (int y = 0; y < h; y++) {
+    const Uint8 *src = pixels + (size_t)(h - y - 1) * w * 4;
+    for (int x = 0; x < w; x++, src += 4) {
+      int r = src[0], g = src[1], b = src[2];
+      *py++ = (( 66 * r + 129 * g +  25 * b + 128) >> 8) + 16;
+      *pu++ = ((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128;
+      *pv++ = ((112 * r -  94 * g -  18 * b + 128) >> 8) + 128;
+    }
+  }
+
+  size_t size = (size_t)w * h * 3;
+  return fputs("FRAME\n", capture.file) >= 0 &&
+         fwrite(capture.yuv, 1, size, capture.file) == size;
+}
+
+
+/*
+ * Encode captured frames; Y4M video has a single encoder so frames stay in
+ * order, PNG images can have several
+ */
+static int S2D_CaptureEncoder(void *unused) {
+  SDL_LockMutex(capture.lock);
+
+  for (;;) {
+    while (!capture.head && !capture.quit) SDL_CondWait(capture.cond, capture.lock);
+    if (!capture.head) break;
+
+    S2D_CaptureFrame *frame = capture.head;
+    capture.head = frame->next;
+    if (!capture.head) capture.tail = NULL;
+    SDL_UnlockMutex(capture.lock);
+
+    bool written;
+    if (capture.options.format == S2D_CAPTURE_Y4M) {
+      written = S2D_WriteY4MFrame(frame->pixels);
+    } else {
+      char path[1024];
+      snprintf(path, sizeof(path), capture.path, frame->index);
+      written = S2D_SavePixelsPNG(frame->pixels, capture.width, capture.height, path) == 0;
+    }
+    free(frame->pixels);
+    free(frame);
+
+    SDL_LockMutex(capture.lock);
+    capture.queued--;
+    if (written) capture.stats.written++;
+    else capture.stats.dropped++;
+  }
+
+  SDL_UnlockMutex(capture.lock);
+  return 0;
+}
+
+
+/*
+ * Queue a read back frame to be encoded
+ */
+static void S2D_QueueCaptureFrame(Uint8 *pixels, int w, int h, void *unused) {
+
+  S2D_CaptureFrame *frame = NULL;
+  if (pixels && w == capture.width && h == capture.height) {
+    frame = (S2D_CaptureFrame *) malloc(sizeof(S2D_CaptureFrame));
+  }
+
+  SDL_LockMutex(capture.lock);
+  if (frame) {
+    frame->pixels = pixels;
+    frame->index = capture.stats.captured++;
+    frame->next = NULL;
+    if (capture.tail) capture.tail->next = frame;
+    else capture.head = frame;
+    capture.tail = frame;
+    SDL_CondSignal(capture.cond);
+  } else {
+    // Not read, out of memory, or the window was resized
+    free(pixels);
+    capture.queued--;
+    capture.stats.dropped++;
+  }
+  SDL_UnlockMutex(capture.lock);
+}
+
+
+/*
+ * Request a readback of the frame if it's one to be captured, dropping it if
+ * too many frames are waiting to be encoded
+ */
+static void S2D_CaptureTick(S2D_Window *window) {
+  if (capture.frame++ % capture.options.every != 0) return;
+
+  SDL_LockMutex(capture.lock);
+  bool full = capture.queued >= capture.options.max_queued;
+  if (full) capture.stats.dropped++;
+  else capture.queued++;
+  SDL_UnlockMutex(capture.lock);
+
+  if (!full) S2D_ReadbackFrame(window, S2D_QueueCaptureFrame, NULL);
+}
+
+
+/*
+ * Check that an image sequence path has exactly one frame number conversion,
+ * like `%05d`, and no other besides `%%`, since it's used as a format string
+ */
+static bool S2D_IsFramePath(const char *path) {
+  int numbers = 0;
+
+  for (const char *c = path; *c; c++) {
+    if (*c != '%') continue;
+    c++;
+    if (*c == '%') continue;
+
+    // Flags and a width, then an integer
+    while (*c && strchr("-+ #0", *c)) c++;
+    while (*c >= '0' && *c <= '9') c++;
+    if (*c != 'd' && *c != 'i') return false;
+    numbers++;
+  }
+
+  return numbers == 1;
+}
+
+
+/*
+ * Start capturing frames of the window
+ */
+int S2D_StartCapture(S2D_Window *window, const char *path, const S2D_CaptureOptions *options) {
+  if (!window || !path) return 1;
+
+  S2D_CaptureArgs args = { window, NULL, NULL, path, options, 0 };
+  if (S2D_InvokeRenderCall(S2D_CallStartCapture, &args)) return args.result;
+
+  if (capture.active) {
+    S2D_Error("S2D_StartCapture", "Already capturing frames");
+    return 1;
+  }
+
+  memset(&capture, 0, sizeof(capture));
+  if (options) capture.options = *options;
+
+  // Fill in defaults
+  S2D_CaptureOptions *o = &capture.options;
+  if (o->format == 0) o->format = strchr(path, '%') ? S2D_CAPTURE_PNG : S2D_CAPTURE_Y4M;
+  if (o->every <= 0) o->every = 1;
+  if (o->fps <= 0) o->fps = window->fps_cap > 0 ? window->fps_cap / o->every : 60;
+  if (o->fps <= 0) o->fps = 1;
+  if (o->max_queued <= 0) o->max_queued = 8;
+  if (o->workers <= 0) o->workers = 4;
+  if (o->workers > S2D_CAPTURE_MAX_WORKERS) o->workers = S2D_CAPTURE_MAX_WORKERS;
+
+  capture.width = window->width;
+  capture.height = window->height;
+
+  if (o->format == S2D_CAPTURE_PNG) {
+    if (!S2D_IsFramePath(path)) {
+      S2D_Error("S2D_StartCapture", "Image path `%s` needs one frame number, like `frame_%%05d.png`", path);
+      return 1;
+    }
+    capture.thread_count = o->workers;
+
+  } else {
+    // A path starting with `|` is a command frames are piped to
+    capture.pipe = path[0] == '|';
+    capture.file = capture.pipe ? popen(path + 1, "w") : fopen(path, "wb");
+    if (!capture.file) {
+      S2D_Error("S2D_StartCapture", "Could not open `%s`", path);
+      return 1;
+    }
+    capture.yuv = (Uint8 *) malloc((size_t)capture.width * capture.height * 3);
+    if (!capture.yuv) {
+      S2D_Error("S2D_StartCapture", "Out of memory!");
+      if (capture.pipe) pclose(capture.file);
+      else fclose(capture.file);
+      return 1;
+    }
+    fprintf(capture.file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n",
+            capture.width, capture.height, o->fps);
+    capture.thread_count = 1;
+  }
+
+  capture.path = (char *) malloc(strlen(path) + 1);
+  strcpy(capture.path, path);
+  capture.lock = SDL_CreateMutex();
+  capture.cond = SDL_CreateCond();
+  for (int i = 0; i < capture.thread_count; i++) {
+    capture.threads[i] = SDL_CreateThread(S2D_CaptureEncoder, "S2D_CaptureEncoder", NULL);
+  }
+
+  capture.active = true;
+  S2D_Log(S2D_INFO, "Capturing every %i frame(s) to `%s`", o->every, path);
+  return 0;
+}
+
+
+/*
+ * Stop capturing frames, waiting for captured frames to be written
+ */
+void S2D_StopCapture(S2D_Window *window) {
+  if (S2D_InvokeRenderCall(S2D_CallStopCapture, window)) return;
+  if (!capture.active) return;
+  capture.active = false;
+
+  // Finish readbacks, which queues their frames
+  S2D_FinishCaptures();
+
+  SDL_LockMutex(capture.lock);
+  capture.quit = true;
+  SDL_CondBroadcast(capture.cond);
+  SDL_UnlockMutex(capture.lock);
+
+  for (int i = 0; i < capture.thread_count; i++) {
+    if (capture.threads[i]) SDL_WaitThread(capture.threads[i], NULL);
+  }
+
+  if (capture.file) {
+    if (capture.pipe) pclose(capture.file);
+    else fclose(capture.file);
+  }
+
+  S2D_Log(S2D_INFO, "Captured %u frame(s), wrote %u, dropped %u",
+          capture.stats.captured, capture.stats.written, capture.stats.dropped);
+
+  SDL_DestroyCond(capture.cond);
+  SDL_DestroyMutex(capture.lock);
+  free(capture.yuv);
+  free(capture.path);
+  capture.file = NULL;
+  capture.yuv = NULL;
+  capture.path = NULL;
+}
+
+
+/*
+ * Get stats of the current or last capture
+ */
+void S2D_GetCaptureStats(S2D_CaptureStats *stats) {
+  if (!stats) return;
+  if (capture.lock && capture.active) SDL_LockMutex(capture.lock);
+  *stats = capture.stats;
+  if (capture.lock && capture.active) SDL_UnlockMutex(capture.lock);
+}
+
+
+/*
+ * Map a finished readback and pass its pixels on
+ */
+static void S2D_FinishReadback(S2D_CaptureSlot *slot) {
+  #if !GLES
+    size_t size = (size_t)slot->width * slot->height * 4;
+    Uint8 *pixels = (Uint8 *) malloc(size);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    void *mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (mapped && pixels) {
+      memcpy(pixels, mapped, size);
+    } else {
+      S2D_Log(S2D_WARN, "Could not read captured frame %u", slot->frame);
+      free(pixels);
+      pixels = NULL;
+    }
+    if (mapped) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->busy = false;
+    slot->done(pixels, slot->width, slot->height, slot->data);
+  #endif
+}
+
+
+/*
+ * Start readbacks requested this frame, and finish ones started long enough
+ * ago that reading them won't stall. Called after the frame is drawn, before
+ * the window is swapped.
+ */
+void S2D_UpdateCapture(S2D_Window *window) {
+
+  capture_frame++;
+
+  if (capture.active) S2D_CaptureTick(window);
+
+  #if !GLES
+    for (int i = 0; i < S2D_CAPTURE_SLOTS; i++) {
+      if (slots[i].busy && capture_frame - slots[i].frame >= S2D_CAPTURE_LATENCY) {
+        S2D_FinishReadback(&slots[i]);
+      }
+    }
+  #endif
+
+  if (request_count == 0) return;
+
+  #if GLES
+    // No pixel pack buffers in OpenGL ES 2.0, so read now and leave only the
+    // flip and encode to the worker
+    for (int i = 0; i < request_count; i++) {
+      S2D_CaptureSlot *r = &requests[i];
+      Uint8 *pixels = (Uint8 *) malloc((size_t)r->width * r->height * 4);
+      if (!pixels) S2D_Error("S2D_UpdateCapture", "Out of memory!");
+      else glReadPixels(0, 0, r->width, r->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+      r->done(pixels, r->width, r->height, r->data);
+    }
+  #else
+    glReadBuffer(window->headless ? GL_COLOR_ATTACHMENT0 : GL_BACK);
+
+    for (int i = 0; i < request_count; i++) {
+      S2D_CaptureSlot *r = &requests[i];
+
+      // Use a free slot, or finish the oldest readback to free one
+      S2D_CaptureSlot *slot = NULL;
+      for (int s = 0; s < S2D_CAPTURE_SLOTS; s++) {
+        if (!slots[s].busy) { slot = &slots[s]; break; }
+        if (!slot || slots[s].frame < slot->frame) slot = &slots[s];
+      }
+      if (slot->busy) S2D_FinishReadback(slot);
+
+      GLuint pbo = slot->pbo;
+      if (pbo == 0) glGenBuffers(1, &pbo);
+      *slot = *r;
+      slot->pbo = pbo;
+      slot->frame = capture_frame;
+      slot->busy = true;
+
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+      glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)r->width * r->height * 4, NULL, GL_STREAM_READ);
+      glReadPixels(0, 0, r->width, r->height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+  #endif
+
+  request_count = 0;
+}
+
+
+/*
+ * Finish all readbacks and wait for queued screenshots to be saved
+ */
+void S2D_FinishCaptures() {
+
+  #if !GLES
+    // Finish the oldest first, so frames are passed on in order
+    for (;;) {
+      S2D_CaptureSlot *oldest = NULL;
+      for (int i = 0; i < S2D_CAPTURE_SLOTS; i++) {
+        if (slots[i].busy && (!oldest || slots[i].frame < oldest->frame)) oldest = &slots[i];
+      }
+      if (!oldest) break;
+      S2D_FinishReadback(oldest);
+    }
+    for (int i = 0; i < S2D_CAPTURE_SLOTS; i++) {
+      if (slots[i].pbo) glDeleteBuffers(1, &slots[i].pbo);
+      slots[i].pbo = 0;
+    }
+  #endif
+
+  // Requests made after the last frame are dropped
+  for (int i = 0; i < request_count; i++) {
+    requests[i].done(NULL, 0, 0, requests[i].data);
+  }
+  request_count = 0;
+
+  if (worker) {
+    SDL_LockMutex(worker_lock);
+    worker_quit = true;
+    SDL_CondSignal(worker_cond);
+    SDL_UnlockMutex(worker_lock);
+    SDL_WaitThread(worker, NULL);
+    SDL_DestroyCond(worker_cond);
+    SDL_DestroyMutex(worker_lock);
+    worker = NULL;
+  }
+}
@@ -8,8 +8,44 @@ static bool FORCE_GL2 = false;
 // Flag set if using OpenGL 2.1
 static bool S2D_GL2 = false;
 
-// The orthographic projection matrix for 2D rendering.
-// Elements 0 and 5 are set in S2D_GL_SetViewport.
+// Framebuffer rendered to instead of the window's, when headless
+static GLuint headlessFramebuffer = 0;
+static GLuint headlessTexture = 0;
+
+// The framebuffer being drawn to, and the window it belongs to
+static GLuint boundFramebuffer = 0;
+static S2D_Window *glWindow = NULL;
+
+// Size of the view in pixels and the camera it's seen through, if any, as
+// draws are made, and the bounds of the view in the world for culling what's
+// outside
+static GLfloat viewWidth = 0, viewHeight = 0;
+static S2D_Camera viewCamera;
+static bool viewHasCamera = false;
+static GLfloat viewX1 = 0, viewY1 = 0, viewX2 = 0, viewY2 = 0;
+static GLfloat viewPixelScale = 1;  // pixels per unit of the view, before zoom
+
+// The view as drawn, which is behind the one above while a frame is being
+// made for the render thread
+static GLfloat drawnWidth = 0, drawnHeight = 0;
+static S2D_Camera drawnCamera;
+static bool drawnHasCamera = false;
+static GLfloat drawnPixelScale = 1;
+
+// Primitives drawn and culled in the current frame, and draw calls made, which
+// are counted on the render thread if there is one
+static S2D_RenderStats frameStats = { 0, 0, 0 };
+static SDL_atomic_t drawCalls;
+
+// Mesh draws are recorded into instead of drawn, if any
+static S2D_Mesh *recordingMesh = NULL;
+
+// Sprites in view of a bulk sprite draw
+static S2D_Sprite **visibleSprites = NULL;
+static int visibleCapacity = 0;
+
+// The orthographic projection matrix for 2D rendering, with the camera.
+// Elements 0, 1, 4, 5, 12, and 13 are set in S2D_GL_ApplyView.
 static GLfloat orthoMatrix[16] =
   {    0,    0,     0,    0,
        0,    0,     0,    0,
@@ -153,9 +189,191 @@ void S2D_GL_GetViewportScale(S2D_Window *window, int *w, int *h, double *scale)
 
 
 /*
- * Sets the viewport and matrix projection
+ * Get the center, zoom, and rotation of a view of the given size, seen through
+ * a camera, or from the origin if NULL
  */
-void S2D_GL_SetViewport(S2D_Window *window) {
+static void S2D_GL_GetView(const S2D_Camera *camera, GLfloat w, GLfloat h,
+                           GLfloat *cx, GLfloat *cy, GLfloat *zoom,
+                           GLfloat *sa, GLfloat *ca) {
+  if (camera) {
+    GLfloat rad = camera->rotate * M_PI / 180.0;
+    *cx = camera->x;
+    *cy = camera->y;
+    *zoom = camera->zoom;
+    *sa = sin(rad);
+    *ca = cos(rad);
+  } else {
+    *cx = w / 2; *cy = h / 2; *zoom = 1; *sa = 0; *ca = 1;
+  }
+}
+
+
+/*
+ * Bound the view of the given size in the world, for culling draws made
+ */
+static void S2D_GL_CullView(GLfloat w, GLfloat h) {
+
+  viewWidth = w;
+  viewHeight = h;
+
+  GLfloat cx, cy, zoom, sa, ca;
+  S2D_GL_GetView(viewHasCamera ? &viewCamera : NULL, w, h, &cx, &cy, &zoom, &sa, &ca);
+
+  // Bound the rotated view
+  GLfloat hw = w / 2 / zoom, hh = h / 2 / zoom;
+  GLfloat ex = fabsf(ca) * hw + fabsf(sa) * hh;
+  GLfloat ey = fabsf(sa) * hw + fabsf(ca) * hh;
+  viewX1 = cx - ex; viewY1 = cy - ey;
+  viewX2 = cx + ex; viewY2 = cy + ey;
+}
+
+
+/*
+ * Set the projection for a view of the given size, seen through the camera
+ */
+static void S2D_GL_ApplyView(GLfloat w, GLfloat h) {
+
+  drawnWidth = w;
+  drawnHeight = h;
+
+  GLfloat cx, cy, zoom, sa, ca;
+  S2D_GL_GetView(drawnHasCamera ? &drawnCamera : NULL, w, h, &cx, &cy, &zoom, &sa, &ca);
+
+  // World to view: move the camera position to the center of the view, then
+  // rotate by the opposite of the camera angle and zoom
+  GLfloat a00 =  zoom * ca, a01 = zoom * sa;
+  GLfloat a10 = -zoom * sa, a11 = zoom * ca;
+  GLfloat tx = w / 2 - (a00 * cx + a01 * cy);
+  GLfloat ty = h / 2 - (a10 * cx + a11 * cy);
+
+  // Then view to clip space, column-major
+  orthoMatrix[0]  =  2.0f / w * a00;
+  orthoMatrix[1]  = -2.0f / h * a10;
+  orthoMatrix[4]  =  2.0f / w * a01;
+  orthoMatrix[5]  = -2.0f / h * a11;
+  orthoMatrix[12] =  2.0f / w * tx - 1.0f;
+  orthoMatrix[13] = -2.0f / h * ty + 1.0f;
+
+  #if GLES
+    S2D_GLES_ApplyProjection(orthoMatrix);
+  #else
+    if (S2D_GL2) {
+      S2D_GL2_ApplyProjection(orthoMatrix);
+    } else {
+      S2D_GL3_ApplyProjection(orthoMatrix);
+    }
+  #endif
+}
+
+
+/*
+ * Arguments of calls run on the render thread
+ */
+typedef struct {
+  bool has_camera;
+  S2D_Camera camera;
+} S2D_GL_CameraArgs;
+
+typedef struct {
+  GLuint fbo;
+  int w, h;
+} S2D_GL_FramebufferArgs;
+
+typedef struct {
+  GLuint *fbo;
+  GLuint *texture;
+  int w, h;
+  int result;
+} S2D_GL_CreateFramebufferArgs;
+
+typedef struct {
+  GLuint *id;
+  GLint format;
+  int w, h;
+  const GLvoid *data;
+  GLint filter;
+  bool alpha;
+} S2D_GL_TextureArgs;
+
+static void S2D_GL_CallSetCamera(void *args) {
+  S2D_GL_CameraArgs *a = (S2D_GL_CameraArgs *) args;
+  S2D_GL_SetCamera(a->has_camera ? &a->camera : NULL);
+}
+
+static void S2D_GL_CallSetViewport(void *window) {
+  S2D_GL_SetViewport((S2D_Window *) window);
+}
+
+static void S2D_GL_CallBindFramebuffer(void *args) {
+  S2D_GL_FramebufferArgs *a = (S2D_GL_FramebufferArgs *) args;
+  S2D_GL_BindFramebuffer(a->fbo, a->w, a->h);
+}
+
+static void S2D_GL_CallCreateFramebuffer(void *args) {
+  S2D_GL_CreateFramebufferArgs *a = (S2D_GL_CreateFramebufferArgs *) args;
+  a->result = S2D_GL_CreateFramebuffer(a->fbo, a->texture, a->w, a->h);
+}
+
+static void S2D_GL_CallFreeFramebuffer(void *args) {
+  S2D_GL_CreateFramebufferArgs *a = (S2D_GL_CreateFramebufferArgs *) args;
+  S2D_GL_FreeFramebuffer(a->fbo, a->texture);
+}
+
+static void S2D_GL_CallCreateTexture(void *args) {
+  S2D_GL_TextureArgs *a = (S2D_GL_TextureArgs *) args;
+  if (a->alpha) S2D_GL_CreateAlphaTexture(a->id, a->w, a->h, a->data);
+  else S2D_GL_CreateTexture(a->id, a->format, a->w, a->h, a->data, a->filter);
+}
+
+static void S2D_GL_CallFreeTexture(void *id) {
+  S2D_GL_FreeTexture((GLuint *) id);
+}
+
+static void S2D_GL_CallDrawMesh(void *args) {
+  S2D_GL_DrawMesh(*(S2D_Mesh **) args);
+}
+
+static void S2D_GL_CallFreeMesh(void *mesh) {
+  S2D_GL_FreeMesh((S2D_Mesh *) mesh);
+}
+
+static void S2D_GL_CallClear(void *clr) {
+  S2D_GL_Clear(*(S2D_Color *) clr);
+}
+
+
+/*
+ * View the world through a camera, or without one if NULL
+ */
+void S2D_GL_SetCamera(const S2D_Camera *camera) {
+
+  // Cull later draws with the camera as they're made
+  if (!S2D_OnRenderThread()) {
+    viewHasCamera = camera != NULL;
+    if (camera) viewCamera = *camera;
+    if (viewWidth > 0) S2D_GL_CullView(viewWidth, viewHeight);
+  }
+
+  S2D_GL_CameraArgs args = { camera != NULL };
+  if (camera) args.camera = *camera;
+  if (S2D_DeferRenderCall(S2D_GL_CallSetCamera, &args, sizeof(args))) return;
+
+  // Draw what's been batched so far with the camera it was meant for
+  S2D_GL_FlushBuffers();
+
+  drawnHasCamera = camera != NULL;
+  if (camera) drawnCamera = *camera;
+
+  // Not until there's a view, since the context is created in `S2D_Show`
+  if (drawnWidth > 0) S2D_GL_ApplyView(drawnWidth, drawnHeight);
+}
+
+
+/*
+ * Calculate the viewport in the window, and the size of the view it shows
+ */
+static void S2D_GL_GetViewport(S2D_Window *window, int *vx, int *vy, int *vw, int *vh,
+                               int *ortho_width, int *ortho_height) {
 
   int ortho_w = window->viewport.width;
   int ortho_h = window->viewport.height;
@@ -187,21 +405,129 @@ void S2D_GL_SetViewport(S2D_Window *window) {
       break;
   }
 
+  *vx = x; *vy = y; *vw = w; *vh = h;
+  *ortho_width = ortho_w;
+  *ortho_height = ortho_h;
+}
+
+
+/*
+ * Sets the viewport and matrix projection
+ */
+void S2D_GL_SetViewport(S2D_Window *window) {
+
+  int x, y, w, h, ortho_w, ortho_h;
+  S2D_GL_GetViewport(window, &x, &y, &w, &h, &ortho_w, &ortho_h);
+
+  if (!S2D_OnRenderThread()) {
+    viewPixelScale = ortho_w > 0 ? (GLfloat)w / ortho_w : 1;
+    S2D_GL_CullView(ortho_w, ortho_h);
+  }
+  if (S2D_InvokeRenderCall(S2D_GL_CallSetViewport, window)) return;
+
   glViewport(x, y, w, h);
+  drawnPixelScale = ortho_w > 0 ? (GLfloat)w / ortho_w : 1;
 
-  // Set orthographic projection matrix
-  orthoMatrix[0] =  2.0f / (GLfloat)ortho_w;
-  orthoMatrix[5] = -2.0f / (GLfloat)ortho_h;
+  S2D_GL_ApplyView(ortho_w, ortho_h);
+}
 
-  #if GLES
-    S2D_GLES_ApplyProjection(orthoMatrix);
-  #else
-    if (S2D_GL2) {
-      S2D_GL2_ApplyProjection(ortho_w, ortho_h);
+
+/*
+ * Bind the framebuffer frames are drawn to: the window's, or the offscreen
+ * one if headless
+ */
+void S2D_GL_BindDefaultFramebuffer() {
+  boundFramebuffer = headlessFramebuffer;
+  glBindFramebuffer(GL_FRAMEBUFFER, headlessFramebuffer);
+}
+
+
+/*
+ * Create a framebuffer drawing to a new texture of the given size
+ */
+int S2D_GL_CreateFramebuffer(GLuint *fbo, GLuint *texture, int w, int h) {
+
+  S2D_GL_CreateFramebufferArgs args = { fbo, texture, w, h, 0 };
+  if (S2D_InvokeRenderCall(S2D_GL_CallCreateFramebuffer, &args)) return args.result;
+
+  glGenTextures(1, texture);
+  glBindTexture(GL_TEXTURE_2D, *texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h,
+               0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+  glGenFramebuffers(1, fbo);
+  glBindFramebuffer(GL_FRAMEBUFFER, *fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                         GL_TEXTURE_2D, *texture, 0);
+
+  GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, boundFramebuffer);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    S2D_Error("S2D_GL_CreateFramebuffer", "Framebuffer is incomplete");
+    S2D_GL_FreeFramebuffer(fbo, texture);
+    return -1;
+  }
+
+  return 0;
+}
+
+
+/*
+ * Free a framebuffer and its texture
+ */
+void S2D_GL_FreeFramebuffer(GLuint *fbo, GLuint *texture) {
+  S2D_GL_CreateFramebufferArgs args = { fbo, texture };
+  if (S2D_InvokeRenderCall(S2D_GL_CallFreeFramebuffer, &args)) return;
+
+  if (*fbo != 0) {
+    glDeleteFramebuffers(1, fbo);
+    *fbo = 0;
+  }
+  S2D_GL_FreeTexture(texture);
+}
+
+
+/*
+ * Draw to a framebuffer of the given size, or to the window's if `fbo` is 0
+ */
+void S2D_GL_BindFramebuffer(GLuint fbo, int w, int h) {
+
+  // Cull later draws to the framebuffer as they're made
+  if (!S2D_OnRenderThread()) {
+    if (fbo == 0) {
+      int x, y, vw, vh, ortho_w, ortho_h;
+      S2D_GL_GetViewport(glWindow, &x, &y, &vw, &vh, &ortho_w, &ortho_h);
+      viewPixelScale = ortho_w > 0 ? (GLfloat)vw / ortho_w : 1;
+      S2D_GL_CullView(ortho_w, ortho_h);
     } else {
-      S2D_GL3_ApplyProjection(orthoMatrix);
+      viewPixelScale = 1;
+      S2D_GL_CullView(w, h);
     }
-  #endif
+  }
+
+  S2D_GL_FramebufferArgs args = { fbo, w, h };
+  if (S2D_DeferRenderCall(S2D_GL_CallBindFramebuffer, &args, sizeof(args))) return;
+
+  // Draw what's been batched so far to the framebuffer it was meant for
+  S2D_GL_FlushBuffers();
+
+  if (fbo == 0) {
+    S2D_GL_BindDefaultFramebuffer();
+    S2D_GL_SetViewport(glWindow);
+    return;
+  }
+
+  boundFramebuffer = fbo;
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glViewport(0, 0, w, h);
+  drawnPixelScale = 1;
+
+  S2D_GL_ApplyView(w, h);
 }
 
 
@@ -210,6 +536,8 @@ void S2D_GL_SetViewport(S2D_Window *window) {
  */
 int S2D_GL_Init(S2D_Window *window) {
 
+  glWindow = window;
+
   // Specify OpenGL contexts and set attributes
   #if GLES
     SDL_GL_SetAttribute(SDL_GL_RED_SIZE,   8);
@@ -288,6 +616,17 @@ int S2D_GL_Init(S2D_Window *window) {
     #endif
   }
 
+  // Draw headless frames to a framebuffer, since hidden windows may not have
+  // pixels of their own
+  if (window->headless) {
+    if (S2D_GL_CreateFramebuffer(&headlessFramebuffer, &headlessTexture,
+                                 window->width, window->height) == 0) {
+      S2D_GL_BindDefaultFramebuffer();
+    } else {
+      S2D_Log(S2D_WARN, "Drawing headless frames to the hidden window instead");
+    }
+  }
+
   // Store the context and print it if diagnostics is enabled
   S2D_GL_StoreContextInfo(window);
   if (S2D_diagnostics) S2D_GL_PrintContextInfo(window);
@@ -303,6 +642,9 @@ void S2D_GL_CreateTexture(GLuint *id, GLint format,
                           int w, int h,
                           const GLvoid *data, GLint filter) {
 
+  S2D_GL_TextureArgs args = { id, format, w, h, data, filter, false };
+  if (S2D_InvokeRenderCall(S2D_GL_CallCreateTexture, &args)) return;
+
   // If 0, then a new texture; generate name
   if (*id == 0) glGenTextures(1, id);
 
@@ -321,10 +663,51 @@ void S2D_GL_CreateTexture(GLuint *id, GLint format,
 }
 
 
+/*
+ * Creates a single channel texture, sampled as alpha, for distance fields
+ */
+void S2D_GL_CreateAlphaTexture(GLuint *id, int w, int h, const GLvoid *data) {
+
+  S2D_GL_TextureArgs args = { id, 0, w, h, data, 0, true };
+  if (S2D_InvokeRenderCall(S2D_GL_CallCreateTexture, &args)) return;
+
+  // If 0, then a new texture; generate name
+  if (*id == 0) glGenTextures(1, id);
+
+  glBindTexture(GL_TEXTURE_2D, *id);
+
+  // Rows are tightly packed single bytes
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  #if GLES
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, w, h, 0, GL_ALPHA, GL_UNSIGNED_BYTE, data);
+  #else
+    if (S2D_GL2) {
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, w, h, 0, GL_ALPHA, GL_UNSIGNED_BYTE, data);
+    } else {
+      // Core profiles have no alpha format, so swizzle red into the alpha channel
+      GLint swizzle[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, w, h, 0, GL_RED, GL_UNSIGNED_BYTE, data);
+      glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+  #endif
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  // Distance fields are interpolated, and cells must not bleed at the edges
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+
 /*
  * Free a texture
  */
 void S2D_GL_FreeTexture(GLuint *id) {
+  if (*id != 0 && S2D_InvokeRenderCall(S2D_GL_CallFreeTexture, id)) return;
+
   if (*id != 0) {
     glDeleteTextures(1, id);
     *id = 0;
@@ -332,6 +715,164 @@ void S2D_GL_FreeTexture(GLuint *id) {
 }
 
 
+/*
+ * Check if a bounding box is out of view, counting it as culled or submitted
+ */
+static bool S2D_GL_Cull(GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2) {
+  if (glWindow && glWindow->culling &&
+      (x2 < viewX1 || x1 > viewX2 || y2 < viewY1 || y1 > viewY2)) {
+    frameStats.culled++;
+    return true;
+  }
+  frameStats.submitted++;
+  return false;
+}
+
+
+/*
+ * Check if a rectangle, rotated around a point, is out of view
+ */
+static bool S2D_GL_CullRect(GLfloat x, GLfloat y, GLfloat w, GLfloat h,
+                            GLfloat angle, GLfloat rx, GLfloat ry) {
+
+  GLfloat cx = x + w / 2, cy = y + h / 2;
+  GLfloat ex = fabsf(w) / 2, ey = fabsf(h) / 2;
+
+  // Rotate the center, and grow the extents to bound the rotated corners
+  if (angle != 0) {
+    GLfloat rad = angle * M_PI / 180.0;
+    GLfloat sa = sin(rad), ca = cos(rad);
+    GLfloat dx = cx - rx, dy = cy - ry;
+    cx = dx * ca - dy * sa + rx;
+    cy = dx * sa + dy * ca + ry;
+    GLfloat ew = fabsf(ca) * ex + fabsf(sa) * ey;
+    ey = fabsf(sa) * ex + fabsf(ca) * ey;
+    ex = ew;
+  }
+
+  return S2D_GL_Cull(cx - ex, cy - ey, cx + ex, cy + ey);
+}
+
+
+/*
+ * Check if draws are sorted
+ */
+static bool S2D_GL_Sorting() {
+  return glWindow && glWindow->sorted_draws;
+}
+
+
+/*
+ * Check if draws are queued, to be sorted or drawn on the render thread
+ */
+static bool S2D_GL_Queueing() {
+  return S2D_GL_Sorting() || S2D_RecordingFrame();
+}
+
+
+/*
+ * Queue a textured quad to be sorted
+ */
+static void S2D_GL_QueueTexture(float x, float y, float w, float h,
+                                GLfloat angle, GLfloat rx, GLfloat ry,
+                                S2D_Color color,
+                                GLfloat tx1, GLfloat ty1, GLfloat tx2, GLfloat ty2,
+                                GLfloat tx3, GLfloat ty3, GLfloat tx4, GLfloat ty4,
+                                GLuint texture_id) {
+
+  S2D_DrawCommand *cmd = S2D_QueueDraw(S2D_DRAW_TEXTURE, texture_id);
+  if (!cmd) return;
+
+  cmd->quad = (S2D_Sprite){
+    .color = color, .x = x, .y = y, .width = w, .height = h,
+    .rotate = angle, .rx = rx, .ry = ry,
+    .tx1 = tx1, .ty1 = ty1, .tx2 = tx2, .ty2 = ty2,
+    .tx3 = tx3, .ty3 = ty3, .tx4 = tx4, .ty4 = ty4
+  };
+}
+
+
+/*
+ * Draw a sorted draw with the renderer
+ */
+static void S2D_GL_SubmitDraw(S2D_DrawCommand *cmd, const GLfloat *data) {
+
+  GLfloat *t = cmd->triangle;
+  S2D_Image img = { .texture_id = cmd->texture_id };
+
+  switch (cmd->type) {
+
+    case S2D_DRAW_TRIANGLE:
+      #if GLES
+        S2D_GLES_DrawTriangle(t[0],  t[1],  t[2],  t[3],  t[4],  t[5],
+                              t[6],  t[7],  t[8],  t[9],  t[10], t[11],
+                              t[12], t[13], t[14], t[15], t[16], t[17]);
+      #else
+        if (S2D_GL2) {
+          S2D_GL2_DrawTriangle(t[0],  t[1],  t[2],  t[3],  t[4],  t[5],
+                               t[6],  t[7],  t[8],  t[9],  t[10], t[11],
+                               t[12], t[13], t[14], t[15], t[16], t[17]);
+        } else {
+          S2D_GL3_DrawTriangle(t[0],  t[1],  t[2],  t[3],  t[4],  t[5],
+                               t[6],  t[7],  t[8],  t[9],  t[10], t[11],
+                               t[12], t[13], t[14], t[15], t[16], t[17]);
+        }
+      #endif
+      break;
+
+    case S2D_DRAW_TEXTURE:
+      cmd->quad.img = &img;
+      #if GLES
+        S2D_GLES_DrawSprite(&cmd->quad);
+      #else
+        if (S2D_GL2) {
+          S2D_GL2_DrawSprite(&cmd->quad);
+        } else {
+          S2D_GL3_DrawSprite(&cmd->quad);
+        }
+      #endif
+      break;
+
+    case S2D_DRAW_GLYPHS: {
+      const GLfloat *quads = data + cmd->glyphs.first;
+      #if GLES
+        S2D_GLES_DrawGlyphs(cmd->texture_id, quads, cmd->glyphs.count,
+                            cmd->glyphs.x, cmd->glyphs.y, cmd->glyphs.scale,
+                            cmd->glyphs.angle, cmd->glyphs.rx, cmd->glyphs.ry,
+                            cmd->glyphs.color, cmd->glyphs.smoothing);
+      #else
+        if (S2D_GL2) {
+          S2D_GL2_DrawGlyphs(cmd->texture_id, quads, cmd->glyphs.count,
+                             cmd->glyphs.x, cmd->glyphs.y, cmd->glyphs.scale,
+                             cmd->glyphs.angle, cmd->glyphs.rx, cmd->glyphs.ry,
+                             cmd->glyphs.color);
+        } else {
+          S2D_GL3_DrawGlyphs(cmd->texture_id, quads, cmd->glyphs.count,
+                             cmd->glyphs.x, cmd->glyphs.y, cmd->glyphs.scale,
+                             cmd->glyphs.angle, cmd->glyphs.rx, cmd->glyphs.ry,
+                             cmd->glyphs.color);
+        }
+      #endif
+      break;
+    }
+
+    case S2D_DRAW_SHAPE:
+      #if GLES
+        S2D_GLES_DrawShape(cmd->shape.x, cmd->shape.y, cmd->shape.radius, cmd->shape.inner,
+                           cmd->shape.start, cmd->shape.end, cmd->shape.color);
+      #else
+        S2D_GL3_DrawShape(cmd->shape.x, cmd->shape.y, cmd->shape.radius, cmd->shape.inner,
+                          cmd->shape.start, cmd->shape.end, cmd->shape.color);
+      #endif
+      break;
+
+    case S2D_DRAW_CALL:
+      cmd->call.fn(cmd->call.args);
+      break;
+  }
+}
+
+
 /*
  * Draw a triangle
  */
@@ -342,6 +883,29 @@ void S2D_GL_DrawTriangle(GLfloat x1, GLfloat y1,
                          GLfloat x3, GLfloat y3,
                          GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3) {
 
+  if (recordingMesh) {
+    GLfloat vertices[] =
+      { x1, y1, r1, g1, b1, a1, 0, 0,
+        x2, y2, r2, g2, b2, a2, 0, 0,
+        x3, y3, r3, g3, b3, a3, 0, 0 };
+    S2D_AddMeshVertices(recordingMesh, 0, vertices, 3);
+    return;
+  }
+
+  if (S2D_GL_Cull(fminf(x1, fminf(x2, x3)), fminf(y1, fminf(y2, y3)),
+                  fmaxf(x1, fmaxf(x2, x3)), fmaxf(y1, fmaxf(y2, y3)))) return;
+
+  if (S2D_GL_Queueing()) {
+    S2D_DrawCommand *cmd = S2D_QueueDraw(S2D_DRAW_TRIANGLE, 0);
+    if (!cmd) return;
+    GLfloat triangle[] =
+      { x1, y1, r1, g1, b1, a1,
+        x2, y2, r2, g2, b2, a2,
+        x3, y3, r3, g3, b3, a3 };
+    memcpy(cmd->triangle, triangle, sizeof(triangle));
+    return;
+  }
+
   #if GLES
     S2D_GLES_DrawTriangle(x1, y1, r1, g1, b1, a1,
                           x2, y2, r2, g2, b2, a2,
@@ -360,10 +924,243 @@ void S2D_GL_DrawTriangle(GLfloat x1, GLfloat y1,
 }
 
 
+/*
+ * Draw triangles from an array of vertices
+ */
+void S2D_GL_DrawTriangles(const S2D_Vertex *v, int count) {
+  if (count < 3) return;
+
+  // Triangles recorded, queued or drawn by the older renderers are taken one
+  // at a time
+  bool bulk = !recordingMesh && !S2D_GL_Queueing();
+  #if GLES
+    bulk = false;
+  #else
+    if (S2D_GL2) bulk = false;
+  #endif
+
+  int triangles = count / 3;
+
+  if (!bulk) {
+    for (int i = 0; i < triangles; i++, v += 3) {
+      S2D_GL_DrawTriangle(v[0].x, v[0].y, v[0].color.r, v[0].color.g, v[0].color.b, v[0].color.a,
+                          v[1].x, v[1].y, v[1].color.r, v[1].color.g, v[1].color.b, v[1].color.a,
+                          v[2].x, v[2].y, v[2].color.r, v[2].color.g, v[2].color.b, v[2].color.a);
+    }
+    return;
+  }
+
+  #if !GLES
+    if (!glWindow || !glWindow->culling) {
+      frameStats.submitted += triangles;
+      S2D_GL3_DrawTriangles(v, triangles * 3);
+      return;
+    }
+
+    // Copy runs of triangles in view, skipping those out of it
+    int first = 0;
+    for (int i = 0; i < triangles; i++) {
+      const S2D_Vertex *t = &v[i * 3];
+      if (S2D_GL_Cull(fminf(t[0].x, fminf(t[1].x, t[2].x)), fminf(t[0].y, fminf(t[1].y, t[2].y)),
+                      fmaxf(t[0].x, fmaxf(t[1].x, t[2].x)), fmaxf(t[0].y, fmaxf(t[1].y, t[2].y)))) {
+        if (i > first) S2D_GL3_DrawTriangles(&v[first * 3], (i - first) * 3);
+        first = i + 1;
+      }
+    }
+    if (triangles > first) S2D_GL3_DrawTriangles(&v[first * 3], (triangles - first) * 3);
+  #endif
+}
+
+
+/*
+ * Get the width of a pixel in the world, as the viewport is scaled and seen
+ * through the camera: the view draws are made in, or on the render thread,
+ * the one they're drawn in
+ */
+GLfloat S2D_GL_GetPixelSize() {
+  bool drawn = S2D_OnRenderThread();
+  bool has_camera = drawn ? drawnHasCamera : viewHasCamera;
+  const S2D_Camera *camera = drawn ? &drawnCamera : &viewCamera;
+
+  GLfloat scale = drawn ? drawnPixelScale : viewPixelScale;
+  if (has_camera && camera->zoom > 0) scale *= camera->zoom;
+  return scale > 0 ? 1 / scale : 1;
+}
+
+
+/*
+ * Draw the band of a sector between two radii, in a color at each, going from
+ * point `p` to `n` of a unit circle
+ */
+static void S2D_GL_TessellateBand(GLfloat x, GLfloat y,
+                                  GLfloat px, GLfloat py, GLfloat nx, GLfloat ny,
+                                  GLfloat r1, S2D_Color c1, GLfloat r2, S2D_Color c2) {
+  if (r1 > 0) {
+    S2D_GL_DrawTriangle(x + px * r1, y + py * r1, c1.r, c1.g, c1.b, c1.a,
+                        x + px * r2, y + py * r2, c2.r, c2.g, c2.b, c2.a,
+                        x + nx * r2, y + ny * r2, c2.r, c2.g, c2.b, c2.a);
+    S2D_GL_DrawTriangle(x + nx * r2, y + ny * r2, c2.r, c2.g, c2.b, c2.a,
+                        x + nx * r1, y + ny * r1, c1.r, c1.g, c1.b, c1.a,
+                        x + px * r1, y + py * r1, c1.r, c1.g, c1.b, c1.a);
+  } else {
+    S2D_GL_DrawTriangle(x, y, c1.r, c1.g, c1.b, c1.a,
+                        x + px * r2, y + py * r2, c2.r, c2.g, c2.b, c2.a,
+                        x + nx * r2, y + ny * r2, c2.r, c2.g, c2.b, c2.a);
+  }
+}
+
+
+/*
+ * Draw a circle, ring, or arc from triangles, for where it can't be shaded,
+ * with its round edges fading out over about a pixel like the shaded ones
+ */
+static void S2D_GL_TessellateShape(GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+                                   GLfloat start, GLfloat end, S2D_Color c) {
+
+  // More sectors for larger shapes, keeping edges within about a pixel
+  int sectors = radius < 4 ? 8 : radius > 480 ? 128 : 8 + (int)(radius / 4);
+  const GLfloat *unit = NULL;
+  GLfloat step = 0, ss = 0, cs = 0;
+
+  if (end - start >= 360) {
+    unit = S2D_GetUnitCircle(sectors);
+    if (!unit) return;
+  } else {
+    // Step around the arc by rotating the point before
+    sectors = (int)ceilf(sectors * (end - start) / 360);
+    if (sectors < 1) sectors = 1;
+    step = (end - start) * M_PI / 180.0 / sectors;
+    ss = sin(step);
+    cs = cos(step);
+  }
+
+  // Half the fade across each edge, no more than half the shape's thickness
+  GLfloat h = S2D_GL_GetPixelSize() / 2;
+  if (h > (radius - inner) / 2) h = (radius - inner) / 2;
+  S2D_Color clear = { c.r, c.g, c.b, 0 };
+
+  GLfloat px = unit ? unit[0] : cos(start * M_PI / 180.0);
+  GLfloat py = unit ? unit[1] : sin(start * M_PI / 180.0);
+
+  for (int i = 0; i < sectors; i++) {
+    GLfloat nx = unit ? unit[i * 2 + 2] : px * cs - py * ss;
+    GLfloat ny = unit ? unit[i * 2 + 3] : px * ss + py * cs;
+
+    GLfloat solid = inner > 0 ? inner + h : 0;
+    if (radius - h > solid) {
+      S2D_GL_TessellateBand(x, y, px, py, nx, ny, solid, c, radius - h, c);
+    }
+    S2D_GL_TessellateBand(x, y, px, py, nx, ny, radius - h, c, radius + h, clear);
+    if (inner > 0) {
+      S2D_GL_TessellateBand(x, y, px, py, nx, ny, inner - h, clear, inner + h, c);
+    }
+
+    px = nx;
+    py = ny;
+  }
+}
+
+
+/*
+ * Draw a circle, ring, or arc of a ring as a single quad, shaded by distance
+ * Params:
+ *   inner       Radius of the hole in the middle, or 0 for none
+ *   start, end  Angles of the arc in degrees, 360 or more apart for all of it
+ */
+void S2D_GL_DrawShape(GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+                      GLfloat start, GLfloat end, S2D_Color color) {
+
+  // Recorded, and drawn by the OpenGL 2 renderer, as triangles instead
+  bool shaded = !recordingMesh;
+  #if !GLES
+    if (S2D_GL2) shaded = false;
+  #endif
+
+  if (!shaded) {
+    S2D_GL_TessellateShape(x, y, radius, inner, start, end, color);
+    return;
+  }
+
+  if (S2D_GL_Cull(x - radius, y - radius, x + radius, y + radius)) return;
+
+  if (S2D_GL_Queueing()) {
+    S2D_DrawCommand *cmd = S2D_QueueDraw(S2D_DRAW_SHAPE, 0);
+    if (!cmd) return;
+    cmd->shape.x = x;
+    cmd->shape.y = y;
+    cmd->shape.radius = radius;
+    cmd->shape.inner = inner;
+    cmd->shape.start = start;
+    cmd->shape.end = end;
+    cmd->shape.color = color;
+    return;
+  }
+
+  #if GLES
+    S2D_GLES_DrawShape(x, y, radius, inner, start, end, color);
+  #else
+    S2D_GL3_DrawShape(x, y, radius, inner, start, end, color);
+  #endif
+}
+
+
+/*
+ * Record a textured quad into the mesh being recorded, as two triangles
+ */
+static void S2D_GL_RecordTexture(float x, float y, float w, float h,
+                                 GLfloat angle, GLfloat rx, GLfloat ry,
+                                 S2D_Color c,
+                                 GLfloat tx1, GLfloat ty1, GLfloat tx2, GLfloat ty2,
+                                 GLfloat tx3, GLfloat ty3, GLfloat tx4, GLfloat ty4,
+                                 GLuint texture_id) {
+
+  S2D_GL_Point v1 = { .x = x,     .y = y     };
+  S2D_GL_Point v2 = { .x = x + w, .y = y     };
+  S2D_GL_Point v3 = { .x = x + w, .y = y + h };
+  S2D_GL_Point v4 = { .x = x,     .y = y + h };
+
+  if (angle != 0) {
+    v1 = S2D_RotatePoint(v1, angle, rx, ry);
+    v2 = S2D_RotatePoint(v2, angle, rx, ry);
+    v3 = S2D_RotatePoint(v3, angle, rx, ry);
+    v4 = S2D_RotatePoint(v4, angle, rx, ry);
+  }
+
+  GLfloat vertices[] =
+    { v1.x, v1.y, c.r, c.g, c.b, c.a, tx1, ty1,
+      v2.x, v2.y, c.r, c.g, c.b, c.a, tx2, ty2,
+      v3.x, v3.y, c.r, c.g, c.b, c.a, tx3, ty3,
+      v3.x, v3.y, c.r, c.g, c.b, c.a, tx3, ty3,
+      v4.x, v4.y, c.r, c.g, c.b, c.a, tx4, ty4,
+      v1.x, v1.y, c.r, c.g, c.b, c.a, tx1, ty1 };
+
+  S2D_AddMeshVertices(recordingMesh, texture_id, vertices, 6);
+}
+
+
 /*
  * Draw an image
  */
 void S2D_GL_DrawImage(S2D_Image *img) {
+  if (recordingMesh) {
+    S2D_GL_RecordTexture(img->x, img->y, img->width, img->height,
+                         img->rotate, img->rx, img->ry, img->color,
+                         0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f,
+                         img->texture_id);
+    return;
+  }
+
+  if (S2D_GL_CullRect(img->x, img->y, img->width, img->height,
+                      img->rotate, img->rx, img->ry)) return;
+
+  if (S2D_GL_Queueing()) {
+    S2D_GL_QueueTexture(img->x, img->y, img->width, img->height,
+                        img->rotate, img->rx, img->ry, img->color,
+                        0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f,
+                        img->texture_id);
+    return;
+  }
+
   #if GLES
     S2D_GLES_DrawImage(img);
   #else
@@ -380,6 +1177,27 @@ void S2D_GL_DrawImage(S2D_Image *img) {
  * Draw sprite
  */
 void S2D_GL_DrawSprite(S2D_Sprite *spr) {
+  if (recordingMesh) {
+    S2D_GL_RecordTexture(spr->x, spr->y, spr->width, spr->height,
+                         spr->rotate, spr->rx, spr->ry, spr->color,
+                         spr->tx1, spr->ty1, spr->tx2, spr->ty2,
+                         spr->tx3, spr->ty3, spr->tx4, spr->ty4,
+                         spr->img->texture_id);
+    return;
+  }
+
+  if (S2D_GL_CullRect(spr->x, spr->y, spr->width, spr->height,
+                      spr->rotate, spr->rx, spr->ry)) return;
+
+  if (S2D_GL_Queueing()) {
+    S2D_GL_QueueTexture(spr->x, spr->y, spr->width, spr->height,
+                        spr->rotate, spr->rx, spr->ry, spr->color,
+                        spr->tx1, spr->ty1, spr->tx2, spr->ty2,
+                        spr->tx3, spr->ty3, spr->tx4, spr->ty4,
+                        spr->img->texture_id);
+    return;
+  }
+
   #if GLES
     S2D_GLES_DrawSprite(spr);
   #else
@@ -392,10 +1210,81 @@ void S2D_GL_DrawSprite(S2D_Sprite *spr) {
 }
 
 
+/*
+ * Draw many sprites, leaving out those out of view
+ */
+void S2D_GL_DrawSprites(S2D_Sprite **sprites, int count) {
+
+  // Sprites recorded, queued or drawn by the older renderers are taken one at
+  // a time; queued ones have their vertices made when they're submitted
+  bool bulk = !recordingMesh && !S2D_GL_Queueing();
+  #if GLES
+    bulk = false;
+  #else
+    if (S2D_GL2) bulk = false;
+  #endif
+
+  if (!bulk) {
+    for (int i = 0; i < count; i++) {
+      if (sprites[i]) S2D_GL_DrawSprite(sprites[i]);
+    }
+    return;
+  }
+
+  // Gather the sprites in view, in order
+  if (count > visibleCapacity) {
+    S2D_Sprite **visible = (S2D_Sprite **) realloc(visibleSprites, count * sizeof(S2D_Sprite *));
+    if (!visible) {
+      S2D_Error("S2D_GL_DrawSprites", "Out of memory!");
+      return;
+    }
+    visibleSprites = visible;
+    visibleCapacity = count;
+  }
+
+  bool culling = glWindow && glWindow->culling;
+  int visible = 0;
+  for (int i = 0; i < count; i++) {
+    S2D_Sprite *spr = sprites[i];
+    if (!spr) continue;
+    if (culling) {
+      if (S2D_GL_CullRect(spr->x, spr->y, spr->width, spr->height,
+                          spr->rotate, spr->rx, spr->ry)) continue;
+    } else {
+      frameStats.submitted++;
+    }
+    visibleSprites[visible++] = spr;
+  }
+
+  #if !GLES
+    S2D_GL3_DrawSprites(visibleSprites, visible);
+  #endif
+}
+
+
 /*
  * Draw text
  */
 void S2D_GL_DrawText(S2D_Text *txt) {
+  if (recordingMesh) {
+    S2D_GL_RecordTexture(txt->x, txt->y, txt->width, txt->height,
+                         txt->rotate, txt->rx, txt->ry, txt->color,
+                         0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f,
+                         txt->texture_id);
+    return;
+  }
+
+  if (S2D_GL_CullRect(txt->x, txt->y, txt->width, txt->height,
+                      txt->rotate, txt->rx, txt->ry)) return;
+
+  if (S2D_GL_Queueing()) {
+    S2D_GL_QueueTexture(txt->x, txt->y, txt->width, txt->height,
+                        txt->rotate, txt->rx, txt->ry, txt->color,
+                        0.f, 0.f, 1.f, 0.f, 1.f, 1.f, 0.f, 1.f,
+                        txt->texture_id);
+    return;
+  }
+
   #if GLES
     S2D_GLES_DrawText(txt);
   #else
@@ -408,13 +1297,177 @@ void S2D_GL_DrawText(S2D_Text *txt) {
 }
 
 
+/*
+ * Draw glyph quads from a distance field atlas
+ * Params:
+ *   quads      Per glyph: x1, y1, x2, y2 at the base size, then tx1, ty1, tx2, ty2
+ *   scale      Size of the text relative to the base size
+ *   smoothing  Edge softness in distance units, where screen-space derivatives
+ *              aren't available to compute it
+ */
+void S2D_GL_DrawGlyphs(GLuint texture_id, const GLfloat *quads, int count,
+                       GLfloat x, GLfloat y, GLfloat scale,
+                       GLfloat angle, GLfloat rx, GLfloat ry,
+                       S2D_Color color, GLfloat smoothing) {
+  if (recordingMesh) {
+    S2D_Log(S2D_WARN, "Distance field text can't be recorded in a mesh");
+    return;
+  }
+
+  if (count <= 0) return;
+
+  // Cull the text by the bounds of all its glyphs
+  GLfloat x1 = quads[0], y1 = quads[1], x2 = quads[2], y2 = quads[3];
+  for (int i = 1; i < count; i++) {
+    const GLfloat *q = &quads[i * 8];
+    x1 = fminf(x1, q[0]); y1 = fminf(y1, q[1]);
+    x2 = fmaxf(x2, q[2]); y2 = fmaxf(y2, q[3]);
+  }
+  if (S2D_GL_CullRect(x + x1 * scale, y + y1 * scale,
+                      (x2 - x1) * scale, (y2 - y1) * scale, angle, rx, ry)) return;
+
+  if (S2D_GL_Queueing()) {
+    int first = S2D_QueueDrawData(quads, count * 8);
+    if (first < 0) return;
+    S2D_DrawCommand *cmd = S2D_QueueDraw(S2D_DRAW_GLYPHS, texture_id);
+    if (!cmd) return;
+    cmd->glyphs.first = first;
+    cmd->glyphs.count = count;
+    cmd->glyphs.x = x; cmd->glyphs.y = y; cmd->glyphs.scale = scale;
+    cmd->glyphs.angle = angle; cmd->glyphs.rx = rx; cmd->glyphs.ry = ry;
+    cmd->glyphs.color = color;
+    cmd->glyphs.smoothing = smoothing;
+    return;
+  }
+
+  #if GLES
+    S2D_GLES_DrawGlyphs(texture_id, quads, count, x, y, scale,
+                        angle, rx, ry, color, smoothing);
+  #else
+    if (S2D_GL2) {
+      S2D_GL2_DrawGlyphs(texture_id, quads, count, x, y, scale,
+                         angle, rx, ry, color);
+    } else {
+      S2D_GL3_DrawGlyphs(texture_id, quads, count, x, y, scale,
+                         angle, rx, ry, color);
+    }
+  #endif
+}
+
+
+/*
+ * Store the render stats of the frame in the window and start counting again
+ */
+void S2D_GL_EndFrame(S2D_Window *window) {
+  frameStats.draw_calls = SDL_AtomicSet(&drawCalls, 0);
+  window->render_stats = frameStats;
+  frameStats = (S2D_RenderStats){ 0, 0, 0 };
+}
+
+
+/*
+ * Count draw calls made by the renderers
+ */
+void S2D_GL_CountDrawCalls(int count) {
+  SDL_AtomicAdd(&drawCalls, count);
+}
+
+
+/*
+ * Record draws into a mesh instead of drawing them, or stop if NULL
+ */
+void S2D_GL_RecordMesh(S2D_Mesh *mesh) {
+  if (recordingMesh && recordingMesh != mesh) recordingMesh->recording = false;
+  recordingMesh = mesh;
+}
+
+
+/*
+ * Draw a mesh with its transform
+ */
+void S2D_GL_DrawMesh(S2D_Mesh *mesh) {
+
+  if (S2D_DeferRenderCall(S2D_GL_CallDrawMesh, &mesh, sizeof(mesh))) return;
+
+  // Draw what's been queued or batched before the mesh
+  S2D_GL_FlushBuffers();
+
+  // Rotate and scale around the rotation point, then translate
+  GLfloat rad = mesh->rotate * M_PI / 180.0;
+  GLfloat sa = sin(rad) * mesh->scale;
+  GLfloat ca = cos(rad) * mesh->scale;
+
+  GLfloat model[16] =
+    { ca,  sa,  0, 0,
+     -sa,  ca,  0, 0,
+      0,   0,   1, 0,
+      mesh->x + mesh->rx - ca * mesh->rx + sa * mesh->ry,
+      mesh->y + mesh->ry - sa * mesh->rx - ca * mesh->ry, 0, 1 };
+
+  // Combine with the projection, both column-major
+  GLfloat mvp[16];
+  for (int c = 0; c < 4; c++) {
+    for (int r = 0; r < 4; r++) {
+      mvp[c * 4 + r] = 0;
+      for (int k = 0; k < 4; k++) {
+        mvp[c * 4 + r] += orthoMatrix[k * 4 + r] * model[c * 4 + k];
+      }
+    }
+  }
+
+  #if GLES
+    S2D_GLES_DrawMesh(mesh, mvp);
+    S2D_GLES_ApplyProjection(orthoMatrix);
+  #else
+    if (S2D_GL2) {
+      S2D_GL2_DrawMesh(mesh, model);
+    } else {
+      S2D_GL3_DrawMesh(mesh, mvp);
+      S2D_GL3_ApplyProjection(orthoMatrix);
+    }
+  #endif
+
+  // The vertices live on the GPU once uploaded
+  if (mesh->vbo != 0 && mesh->vertices) {
+    free(mesh->vertices);
+    mesh->vertices = NULL;
+    mesh->vertex_capacity = 0;
+  }
+}
+
+
+/*
+ * Free the vertex buffer of a mesh
+ */
+void S2D_GL_FreeMesh(S2D_Mesh *mesh) {
+  if (S2D_InvokeRenderCall(S2D_GL_CallFreeMesh, mesh)) return;
+
+  if (mesh->vbo != 0) {
+    glDeleteBuffers(1, &mesh->vbo);
+    mesh->vbo = 0;
+  }
+  #if !GLES
+    if (mesh->vao != 0) {
+      glDeleteVertexArrays(1, &mesh->vao);
+      mesh->vao = 0;
+    }
+  #endif
+}
+
+
 /*
  * Render and flush OpenGL buffers
  */
 void S2D_GL_FlushBuffers() {
+  // Frames made for the render thread are drawn there
+  if (S2D_RecordingFrame()) return;
+
+  // Draw queued draws first, which the renderer may batch
+  S2D_SubmitDraws(S2D_GL_SubmitDraw, S2D_GL_Sorting());
+
   // Only implemented in our OpenGL 3.3+ and ES 2.0 renderers
   #if GLES
-    // TODO: S2D_GLES_FlushBuffers();
+    S2D_GLES_FlushBuffers();
   #else
     if (!S2D_GL2) S2D_GL3_FlushBuffers();
   #endif
@@ -425,6 +1478,7 @@ void S2D_GL_FlushBuffers() {
  * Clear buffers to given color values
  */
 void S2D_GL_Clear(S2D_Color clr) {
+  if (S2D_DeferRenderCall(S2D_GL_CallClear, &clr, sizeof(clr))) return;
   glClearColor(clr.r, clr.g, clr.b, clr.a);
   glClear(GL_COLOR_BUFFER_BIT);
 }
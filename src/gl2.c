@@ -8,14 +8,11 @@
 /*
  * Applies the projection matrix
  */
-void S2D_GL2_ApplyProjection(int w, int h) {
+void S2D_GL2_ApplyProjection(GLfloat orthoMatrix[16]) {
 
-  // Initialize the projection matrix
+  // Load the orthographic matrix, which includes the camera
   glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-
-  // Multiply the current matrix with the orthographic matrix
-  glOrtho(0.f, w, h, 0.f, -1.f, 1.f);
+  glLoadMatrixf(orthoMatrix);
 
   // Initialize the model-view matrix
   glMatrixMode(GL_MODELVIEW);
@@ -60,6 +57,8 @@ void S2D_GL2_DrawTriangle(GLfloat x1, GLfloat y1,
     glColor4f(r2, g2, b2, a2); glVertex2f(x2, y2);
     glColor4f(r3, g3, b3, a3); glVertex2f(x3, y3);
   glEnd();
+
+  S2D_GL_CountDrawCalls(1);
 }
 
 
@@ -98,10 +97,107 @@ static void S2D_GL2_DrawTexture(int x, int y, int w, int h,
     glTexCoord2f(tx4, ty4); glVertex2f(v4.x, v4.y);
   glEnd();
 
+  S2D_GL_CountDrawCalls(1);
+
+  glDisable(GL_TEXTURE_2D);
+}
+
+
+/*
+ * Draw glyph quads from a distance field atlas
+ */
+void S2D_GL2_DrawGlyphs(GLuint texture_id, const GLfloat *quads, int count,
+                        GLfloat x, GLfloat y, GLfloat scale,
+                        GLfloat angle, GLfloat rx, GLfloat ry,
+                        S2D_Color color) {
+
+  glEnable(GL_TEXTURE_2D);
+  glBindTexture(GL_TEXTURE_2D, texture_id);
+
+  // Without shaders, cut the glyphs out at the distance field edge
+  glEnable(GL_ALPHA_TEST);
+  glAlphaFunc(GL_GEQUAL, 0.5f * color.a);
+
+  glBegin(GL_QUADS);
+  glColor4f(color.r, color.g, color.b, color.a);
+
+  for (int i = 0; i < count; i++) {
+    const GLfloat *q = &quads[i * 8];
+
+    S2D_GL_Point v1 = { .x = x + q[0] * scale, .y = y + q[1] * scale };
+    S2D_GL_Point v2 = { .x = x + q[2] * scale, .y = y + q[1] * scale };
+    S2D_GL_Point v3 = { .x = x + q[2] * scale, .y = y + q[3] * scale };
+    S2D_GL_Point v4 = { .x = x + q[0] * scale, .y = y + q[3] * scale };
+
+    // Rotate vertices
+    if (angle != 0) {
+      v1 = S2D_RotatePoint(v1, angle, rx, ry);
+      v2 = S2D_RotatePoint(v2, angle, rx, ry);
+      v3 = S2D_RotatePoint(v3, angle, rx, ry);
+      v4 = S2D_RotatePoint(v4, angle, rx, ry);
+    }
+
+    glTexCoord2f(q[4], q[5]); glVertex2f(v1.x, v1.y);
+    glTexCoord2f(q[6], q[5]); glVertex2f(v2.x, v2.y);
+    glTexCoord2f(q[6], q[7]); glVertex2f(v3.x, v3.y);
+    glTexCoord2f(q[4], q[7]); glVertex2f(v4.x, v4.y);
+  }
+
+  glEnd();
+
+  S2D_GL_CountDrawCalls(1);
+
+  glDisable(GL_ALPHA_TEST);
   glDisable(GL_TEXTURE_2D);
 }
 
 
+/*
+ * Draw a mesh, uploading it first if needed
+ */
+void S2D_GL2_DrawMesh(S2D_Mesh *mesh, GLfloat modelMatrix[16]) {
+
+  if (mesh->vbo == 0) {
+    glGenBuffers(1, &mesh->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh->vertex_count * 8 * sizeof(GLfloat),
+                 mesh->vertices, GL_STATIC_DRAW);
+  } else {
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+  }
+
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  glVertexPointer(2, GL_FLOAT, 8 * sizeof(GLfloat), 0);
+  glColorPointer(4, GL_FLOAT, 8 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+  glTexCoordPointer(2, GL_FLOAT, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
+
+  glPushMatrix();
+  glMultMatrixf(modelMatrix);
+
+  for (int i = 0; i < mesh->batch_count; i++) {
+    S2D_MeshBatch *b = &mesh->batches[i];
+    if (b->texture_id) {
+      glEnable(GL_TEXTURE_2D);
+      glBindTexture(GL_TEXTURE_2D, b->texture_id);
+    } else {
+      glDisable(GL_TEXTURE_2D);
+    }
+    glDrawArrays(GL_TRIANGLES, b->first, b->count);
+  }
+  S2D_GL_CountDrawCalls(mesh->batch_count);
+
+  glPopMatrix();
+  glDisable(GL_TEXTURE_2D);
+
+  glDisableClientState(GL_VERTEX_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
 /*
  * Draw image
  */
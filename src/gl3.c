@@ -5,17 +5,28 @@
 // Skip this file if OpenGL ES
 #if !GLES
 
+// Shapes batched before they're drawn
+#define S2D_GL3_MAX_SHAPES 1024
+
+static GLuint vao;  // vertex array object for the buffer below
 static GLuint vbo;  // our primary vertex buffer object (VBO)
 static GLuint vboSize;  // size of the VBO in bytes
 static GLfloat *vboData;  // pointer to the VBO data
 static GLfloat *vboDataCurrent;  // pointer to the data for the current vertices
 static GLuint vboDataIndex = 0;  // index of the current object being rendered
 static GLuint vboObjCapacity = 2500;  // number of objects the VBO can store
+static GLuint vboTexture = 0;  // texture of the triangles in the VBO, or 0 for none
 static GLuint shaderProgram;  // triangle shader program
 static GLuint texShaderProgram;  // texture shader program
-static GLuint indices[] =  // indices for rendering textured quads
-  { 0, 1, 2,
-    2, 3, 0 };
+static GLuint sdfShaderProgram;  // distance field text shader program
+static GLfloat *glyphVertices = NULL;  // vertex data for drawing glyphs
+static GLuint *glyphIndices = NULL;  // indices for drawing glyph quads
+static int glyphCapacity = 0;  // number of glyphs the arrays above can store
+static GLuint shapeShaderProgram;  // circle, ring, and arc shader program
+static GLuint shapeVao;  // vertex array object for the shape buffer
+static GLuint shapeVbo;  // vertex buffer of batched shapes, one quad each
+static GLfloat shapeData[S2D_GL3_MAX_SHAPES * 6 * 12];  // 12 floats per vertex
+static int shapeCount = 0;  // number of shapes batched
 
 
 /*
@@ -40,6 +51,24 @@ void S2D_GL3_ApplyProjection(GLfloat orthoMatrix[16]) {
     glGetUniformLocation(texShaderProgram, "u_mvpMatrix"),
     1, GL_FALSE, orthoMatrix
   );
+
+  // Use the distance field program object
+  glUseProgram(sdfShaderProgram);
+
+  // Apply the projection matrix to the distance field shader
+  glUniformMatrix4fv(
+    glGetUniformLocation(sdfShaderProgram, "u_mvpMatrix"),
+    1, GL_FALSE, orthoMatrix
+  );
+
+  // Use the shape program object
+  glUseProgram(shapeShaderProgram);
+
+  // Apply the projection matrix to the shape shader
+  glUniformMatrix4fv(
+    glGetUniformLocation(shapeShaderProgram, "u_mvpMatrix"),
+    1, GL_FALSE, orthoMatrix
+  );
 }
 
 
@@ -98,8 +127,77 @@ int S2D_GL3_Init() {
     "  outColor = texture(tex, Texcoord) * Color;"
     "}";
 
+  // Fragment shader source string for distance field text
+  GLchar sdfFragmentSource[] =
+    "#version 150 core\n"     // shader version
+    "in vec4 Color;"          // input color from vertex shader
+    "in vec2 Texcoord;"       // input texture coordinates
+    "out vec4 outColor;"      // output fragment color
+    "uniform sampler2D tex;"  // 2D texture unit
+
+    "void main() {"
+    // Glyph edges are at distance 0.5; smooth them over about one pixel at
+    // whatever scale and rotation the text is drawn
+    "  float dist = texture(tex, Texcoord).a;"
+    "  float width = fwidth(dist) * 0.7;"
+    "  float alpha = smoothstep(0.5 - width, 0.5 + width, dist);"
+    "  outColor = vec4(Color.rgb, Color.a * alpha);"
+    "}";
+
+  // Vertex shader source string for shapes, which are shaded by the distance
+  // of each fragment from the center, given in `local`
+  GLchar shapeVertexSource[] =
+    "#version 150 core\n"
+    "uniform mat4 u_mvpMatrix;"
+    "in vec4 position;"
+    "in vec4 color;"
+    "in vec2 local;"  // position relative to the center
+    "in vec4 shape;"  // radius, inner radius, start and end angles in degrees
+
+    "out vec4 Color;"
+    "out vec2 Local;"
+    "out vec2 Radii;"
+    "out vec4 Edges;"  // directions of the start and end of an arc
+    "out float Arc;"   // 0 for the whole circle, 1 up to a half, 2 for more
+
+    "void main() {"
+    "  Color = color;"
+    "  Local = local;"
+    "  Radii = shape.xy;"
+    "  float span = shape.w - shape.z;"
+    "  Arc = span >= 360.0 ? 0.0 : span <= 180.0 ? 1.0 : 2.0;"
+    "  vec2 a = radians(shape.zw);"
+    "  Edges = vec4(cos(a.x), sin(a.x), cos(a.y), sin(a.y));"
+    "  gl_Position = u_mvpMatrix * position;"
+    "}";
+
+  // Fragment shader source string for shapes
+  GLchar shapeFragmentSource[] =
+    "#version 150 core\n"
+    "in vec4 Color;"
+    "in vec2 Local;"
+    "in vec2 Radii;"
+    "in vec4 Edges;"
+    "in float Arc;"
+    "out vec4 outColor;"
+
+    "void main() {"
+    // Cover each edge over about one pixel at whatever scale it's drawn
+    "  float d = length(Local);"
+    "  float aa = max(fwidth(d), 0.0001);"
+    "  float alpha = clamp((Radii.x - d) / aa + 0.5, 0.0, 1.0);"
+    "  if (Radii.y > 0.0) alpha *= clamp((d - Radii.y) / aa + 0.5, 0.0, 1.0);"
+    // Inside an arc up to a half turn is past both its edges, and inside a
+    // longer one is past either
+    "  if (Arc > 0.5) {"
+    "    float s = (Edges.x * Local.y - Edges.y * Local.x) / aa + 0.5;"
+    "    float e = (Local.x * Edges.w - Local.y * Edges.z) / aa + 0.5;"
+    "    alpha *= clamp(Arc < 1.5 ? min(s, e) : max(s, e), 0.0, 1.0);"
+    "  }"
+    "  outColor = vec4(Color.rgb, Color.a * alpha);"
+    "}";
+
   // Create a vertex array object
-  GLuint vao;
   glGenVertexArrays(1, &vao);
   glBindVertexArray(vao);
 
@@ -119,6 +217,7 @@ int S2D_GL3_Init() {
   GLuint vertexShader      = S2D_GL_LoadShader(  GL_VERTEX_SHADER,      vertexSource, "GL3 Vertex");
   GLuint fragmentShader    = S2D_GL_LoadShader(GL_FRAGMENT_SHADER,    fragmentSource, "GL3 Fragment");
   GLuint texFragmentShader = S2D_GL_LoadShader(GL_FRAGMENT_SHADER, texFragmentSource, "GL3 Texture Fragment");
+  GLuint sdfFragmentShader = S2D_GL_LoadShader(GL_FRAGMENT_SHADER, sdfFragmentSource, "GL3 SDF Fragment");
 
   // Triangle Shader //
 
@@ -193,23 +292,152 @@ int S2D_GL3_Init() {
   glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
   glEnableVertexAttribArray(texAttrib);
 
+  // Distance Field Shader //
+
+  // Create the distance field shader program object
+  sdfShaderProgram = glCreateProgram();
+
+  // Check if program was created successfully
+  if (sdfShaderProgram == 0) {
+    S2D_GL_PrintError("Failed to create shader program");
+    return GL_FALSE;
+  }
+
+  // Attach the shader objects to the program object
+  glAttachShader(sdfShaderProgram, vertexShader);
+  glAttachShader(sdfShaderProgram, sdfFragmentShader);
+
+  // Bind the output color variable to the fragment shader color number
+  glBindFragDataLocation(sdfShaderProgram, 0, "outColor");
+
+  // Link the shader program
+  glLinkProgram(sdfShaderProgram);
+
+  // Check if linked
+  S2D_GL_CheckLinked(sdfShaderProgram, "GL3 SDF shader");
+
+  // Specify the layout of the position vertex data...
+  posAttrib = glGetAttribLocation(sdfShaderProgram, "position");
+  glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), 0);
+  glEnableVertexAttribArray(posAttrib);
+
+  // ...and the color vertex data...
+  colAttrib = glGetAttribLocation(sdfShaderProgram, "color");
+  glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+  glEnableVertexAttribArray(colAttrib);
+
+  // ...and the texture coordinates
+  texAttrib = glGetAttribLocation(sdfShaderProgram, "texcoord");
+  glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
+  glEnableVertexAttribArray(texAttrib);
+
+  // Shape Shader //
+
+  GLuint shapeVertexShader   = S2D_GL_LoadShader(  GL_VERTEX_SHADER,   shapeVertexSource, "GL3 Shape Vertex");
+  GLuint shapeFragmentShader = S2D_GL_LoadShader(GL_FRAGMENT_SHADER, shapeFragmentSource, "GL3 Shape Fragment");
+
+  // Create the shape shader program object
+  shapeShaderProgram = glCreateProgram();
+
+  // Check if program was created successfully
+  if (shapeShaderProgram == 0) {
+    S2D_GL_PrintError("Failed to create shader program");
+    return GL_FALSE;
+  }
+
+  // Attach the shader objects to the program object
+  glAttachShader(shapeShaderProgram, shapeVertexShader);
+  glAttachShader(shapeShaderProgram, shapeFragmentShader);
+
+  // Bind the output color variable to the fragment shader color number
+  glBindFragDataLocation(shapeShaderProgram, 0, "outColor");
+
+  // Link the shader program
+  glLinkProgram(shapeShaderProgram);
+
+  // Check if linked
+  S2D_GL_CheckLinked(shapeShaderProgram, "GL3 shape shader");
+
+  // Shapes have their own vertex array and buffer, with a larger vertex
+  glGenVertexArrays(1, &shapeVao);
+  glBindVertexArray(shapeVao);
+  glGenBuffers(1, &shapeVbo);
+  glBindBuffer(GL_ARRAY_BUFFER, shapeVbo);
+
+  // Specify the layout of the position vertex data...
+  posAttrib = glGetAttribLocation(shapeShaderProgram, "position");
+  glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 12 * sizeof(GLfloat), 0);
+  glEnableVertexAttribArray(posAttrib);
+
+  // ...and the color vertex data...
+  colAttrib = glGetAttribLocation(shapeShaderProgram, "color");
+  glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 12 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+  glEnableVertexAttribArray(colAttrib);
+
+  // ...and the position relative to the center...
+  GLint localAttrib = glGetAttribLocation(shapeShaderProgram, "local");
+  glVertexAttribPointer(localAttrib, 2, GL_FLOAT, GL_FALSE, 12 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
+  glEnableVertexAttribArray(localAttrib);
+
+  // ...and the radii and angles
+  GLint shapeAttrib = glGetAttribLocation(shapeShaderProgram, "shape");
+  glVertexAttribPointer(shapeAttrib, 4, GL_FLOAT, GL_FALSE, 12 * sizeof(GLfloat), (void*)(8 * sizeof(GLfloat)));
+  glEnableVertexAttribArray(shapeAttrib);
+
+  // Go back to the primary buffer
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
   // Clean up
   glDeleteShader(vertexShader);
   glDeleteShader(fragmentShader);
   glDeleteShader(texFragmentShader);
+  glDeleteShader(sdfFragmentShader);
+  glDeleteShader(shapeVertexShader);
+  glDeleteShader(shapeFragmentShader);
 
   // If successful, return true
   return GL_TRUE;
 }
 
 
+/*
+ * Render the batched shapes and reset the batch
+ */
+static void S2D_GL3_FlushShapes() {
+
+  glUseProgram(shapeShaderProgram);
+  glBindVertexArray(shapeVao);
+  glBindBuffer(GL_ARRAY_BUFFER, shapeVbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * shapeCount * 6 * 12, shapeData, GL_STREAM_DRAW);
+
+  glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(shapeCount * 6));
+  S2D_GL_CountDrawCalls(1);
+  shapeCount = 0;
+
+  // Go back to the primary buffer
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+}
+
+
 /*
  * Render the vertex buffer and reset it
  */
 void S2D_GL3_FlushBuffers() {
 
-  // Use the triangle shader program
-  glUseProgram(shaderProgram);
+  // Shapes are batched apart, but only while nothing else is
+  if (shapeCount > 0) S2D_GL3_FlushShapes();
+
+  if (vboDataIndex == 0) return;
+
+  // Use the shader program for the triangles in the buffer
+  if (vboTexture) {
+    glUseProgram(texShaderProgram);
+    glBindTexture(GL_TEXTURE_2D, vboTexture);
+  } else {
+    glUseProgram(shaderProgram);
+  }
 
   // Bind to the vertex buffer object and update its data
   glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -222,6 +450,7 @@ void S2D_GL3_FlushBuffers() {
 #else
   glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(vboDataIndex * 3));
 #endif // DEBUG
+  S2D_GL_CountDrawCalls(1);
 
   // Reset the buffer object index and data pointer
   vboDataIndex = 0;
@@ -239,8 +468,9 @@ void S2D_GL3_DrawTriangle(GLfloat x1, GLfloat y1,
                           GLfloat x3, GLfloat y3,
                           GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3) {
 
-  // If buffer is full, flush it
-  if (vboDataIndex >= vboObjCapacity) S2D_GL3_FlushBuffers();
+  // If buffer is full or has textured triangles, flush it
+  if (vboDataIndex >= vboObjCapacity || vboTexture != 0 || shapeCount > 0) S2D_GL3_FlushBuffers();
+  vboTexture = 0;
 
   // Set the triangle data into a formatted array
   GLfloat vertices[] =
@@ -257,6 +487,63 @@ void S2D_GL3_DrawTriangle(GLfloat x1, GLfloat y1,
 }
 
 
+/*
+ * Draw triangles from an array of vertices, copying as many as fit into the
+ * buffer at a time
+ */
+void S2D_GL3_DrawTriangles(const S2D_Vertex *v, int count) {
+
+  if (vboTexture != 0 || shapeCount > 0) S2D_GL3_FlushBuffers();
+  vboTexture = 0;
+
+  int triangles = count / 3;
+  while (triangles > 0) {
+    if (vboDataIndex >= vboObjCapacity) S2D_GL3_FlushBuffers();
+
+    int n = vboObjCapacity - vboDataIndex;
+    if (n > triangles) n = triangles;
+
+    // Vertices in the buffer also have texture coordinates, unused here
+    GLfloat *out = vboDataCurrent;
+    for (int i = 0; i < n * 3; i++, v++, out += 8) {
+      memcpy(out, v, sizeof(S2D_Vertex));
+      out[6] = 0;
+      out[7] = 0;
+    }
+
+    vboDataIndex += n;
+    vboDataCurrent = out;
+    triangles -= n;
+  }
+}
+
+
+/*
+ * Draw a circle, ring, or arc as a quad around it, batched with other shapes
+ */
+void S2D_GL3_DrawShape(GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+                       GLfloat start, GLfloat end, S2D_Color c) {
+
+  // Flush other draws batched before, to keep the Z order
+  if (vboDataIndex > 0 || shapeCount == S2D_GL3_MAX_SHAPES) S2D_GL3_FlushBuffers();
+
+  // A pixel larger than the shape, for its smoothed edge
+  GLfloat e = radius + 1;
+
+  GLfloat vertices[] =
+  //  vertex coords  | colors            | local  | radii, angles
+    { x - e, y - e,    c.r, c.g, c.b, c.a,  -e, -e,   radius, inner, start, end,
+      x + e, y - e,    c.r, c.g, c.b, c.a,   e, -e,   radius, inner, start, end,
+      x + e, y + e,    c.r, c.g, c.b, c.a,   e,  e,   radius, inner, start, end,
+      x + e, y + e,    c.r, c.g, c.b, c.a,   e,  e,   radius, inner, start, end,
+      x - e, y + e,    c.r, c.g, c.b, c.a,  -e,  e,   radius, inner, start, end,
+      x - e, y - e,    c.r, c.g, c.b, c.a,  -e, -e,   radius, inner, start, end };
+
+  memcpy(&shapeData[shapeCount * 6 * 12], vertices, sizeof(vertices));
+  shapeCount++;
+}
+
+
 /*
  * Draw a texture
  */
@@ -267,9 +554,11 @@ static void S2D_GL3_DrawTexture(float x, float y, float w, float h,
                                 GLfloat tx3, GLfloat ty3, GLfloat tx4, GLfloat ty4,
                                 GLuint texture_id) {
 
-  // Currently, textures are not buffered, so we have to flush all buffers so
-  // textures get rendered in the correct Z order
-  S2D_GL3_FlushBuffers();
+  // Batch with the buffered triangles only if they use the same texture
+  if (vboDataIndex + 2 > vboObjCapacity || vboTexture != texture_id || shapeCount > 0) {
+    S2D_GL3_FlushBuffers();
+  }
+  vboTexture = texture_id;
 
   // Set up the vertex points
   S2D_GL_Point v1 = { .x = x,     .y = y     };
@@ -285,26 +574,263 @@ static void S2D_GL3_DrawTexture(float x, float y, float w, float h,
     v4 = S2D_RotatePoint(v4, angle, rx, ry);
   }
 
-  // Set the textured quad data into a formatted array
+  // Set the textured quad data into a formatted array, as two triangles
   GLfloat vertices[] =
   //  vertex coords | colors      | x, y texture coords
     { v1.x, v1.y,     r, g, b, a,   tx1, ty1,    // Top-left
       v2.x, v2.y,     r, g, b, a,   tx2, ty2,    // Top-right
       v3.x, v3.y,     r, g, b, a,   tx3, ty3,    // Bottom-right
-      v4.x, v4.y,     r, g, b, a,   tx4, ty4 };  // Bottom-left
+      v3.x, v3.y,     r, g, b, a,   tx3, ty3,    // Bottom-right
+      v4.x, v4.y,     r, g, b, a,   tx4, ty4,    // Bottom-left
+      v1.x, v1.y,     r, g, b, a,   tx1, ty1 };  // Top-left
+
+  // Copy the vertex data into the buffer
+  memcpy(vboDataCurrent, vertices, sizeof(vertices));
+  vboDataIndex += 2;
+  vboDataCurrent = (GLfloat *)((char *)vboDataCurrent + sizeof(vertices));
+}
+
+
+// Sprites whose vertices are written in parallel, into the mapped buffer
+typedef struct {
+  S2D_Sprite **sprites;
+  GLfloat *vertices;
+} S2D_GL3_SpriteRun;
+
+
+/*
+ * Write the vertices of a range of sprites in a run, as two triangles each
+ */
+static void S2D_GL3_WriteSpriteVertices(int first, int last, void *data) {
+  S2D_GL3_SpriteRun *run = (S2D_GL3_SpriteRun *) data;
+
+  // Transform the corners of a chunk of sprites at a time, from arrays of
+  // each attribute
+  enum { CHUNK = 64 };
+  GLfloat x[CHUNK], y[CHUNK], w[CHUNK], h[CHUNK], angle[CHUNK], rx[CHUNK], ry[CHUNK];
+  GLfloat corners[CHUNK * 8];
+  S2D_QuadArrays quads = { x, y, w, h, angle, rx, ry };
+
+  for (int chunk = first; chunk < last; chunk += CHUNK) {
+    int n = last - chunk < CHUNK ? last - chunk : CHUNK;
+
+    for (int i = 0; i < n; i++) {
+      const S2D_Sprite *spr = run->sprites[chunk + i];
+      x[i] = spr->x; y[i] = spr->y;
+      w[i] = spr->width; h[i] = spr->height;
+      angle[i] = spr->rotate; rx[i] = spr->rx; ry[i] = spr->ry;
+    }
+    S2D_TransformQuads(&quads, n, corners);
+
+    for (int i = 0; i < n; i++) {
+      const S2D_Sprite *spr = run->sprites[chunk + i];
+      const GLfloat *v = &corners[i * 8];
+      S2D_Color c = spr->color;
+
+      GLfloat vertices[] =
+        { v[0], v[1], c.r, c.g, c.b, c.a, spr->tx1, spr->ty1,
+          v[2], v[3], c.r, c.g, c.b, c.a, spr->tx2, spr->ty2,
+          v[4], v[5], c.r, c.g, c.b, c.a, spr->tx3, spr->ty3,
+          v[4], v[5], c.r, c.g, c.b, c.a, spr->tx3, spr->ty3,
+          v[6], v[7], c.r, c.g, c.b, c.a, spr->tx4, spr->ty4,
+          v[0], v[1], c.r, c.g, c.b, c.a, spr->tx1, spr->ty1 };
+
+      memcpy(run->vertices + (size_t)(chunk + i) * 48, vertices, sizeof(vertices));
+    }
+  }
+}
+
+
+/*
+ * Draw many sprites, with one draw call for each run of sprites using the
+ * same texture. The vertices of a run are written by the job workers, each
+ * into its own part of the mapped vertex buffer.
+ */
+void S2D_GL3_DrawSprites(S2D_Sprite **sprites, int count) {
+
+  // Draw what's been batched before the sprites
+  S2D_GL3_FlushBuffers();
 
-  // Use the texture shader program
   glUseProgram(texShaderProgram);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+  for (int first = 0; first < count; ) {
+    GLuint texture_id = sprites[first]->img->texture_id;
+    int last = first + 1;
+    while (last < count && sprites[last]->img->texture_id == texture_id) last++;
+    int n = last - first;
+
+    // Orphan the buffer so the GPU can keep drawing from the one before
+    GLsizeiptr size = (GLsizeiptr)n * 48 * sizeof(GLfloat);
+    glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+    S2D_GL3_SpriteRun run = {
+      .sprites = sprites + first,
+      .vertices = (GLfloat *) glMapBufferRange(GL_ARRAY_BUFFER, 0, size,
+                                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT)
+    };
+
+    // Fall back to batching the sprites one at a time
+    if (!run.vertices) {
+      for (int i = first; i < last; i++) S2D_GL3_DrawSprite(sprites[i]);
+      S2D_GL3_FlushBuffers();
+      glUseProgram(texShaderProgram);
+      first = last;
+      continue;
+    }
+
+    // Choose the quad kernel here, rather than on every worker at once
+    S2D_GetQuadKernel();
+
+    // A few thousand vertices per job, fewer aren't worth handing out
+    int grain = n / ((S2D_GetJobWorkers() + 1) * 4);
+    S2D_ParallelFor(n, grain < 256 ? 256 : grain, S2D_GL3_WriteSpriteVertices, &run);
+
+    // The buffer can be lost while mapped, e.g. on a mode change; skip the run
+    if (glUnmapBuffer(GL_ARRAY_BUFFER)) {
+      glBindTexture(GL_TEXTURE_2D, texture_id);
+#if defined(DEBUG)
+      glDrawArrays(GL_LINE_LOOP, 0, (GLsizei)(n * 6));
+#else
+      glDrawArrays(GL_TRIANGLES, 0, (GLsizei)(n * 6));
+#endif // DEBUG
+      S2D_GL_CountDrawCalls(1);
+    }
+
+    first = last;
+  }
+}
+
+
+/*
+ * Draw glyph quads from a distance field atlas
+ */
+void S2D_GL3_DrawGlyphs(GLuint texture_id, const GLfloat *quads, int count,
+                        GLfloat x, GLfloat y, GLfloat scale,
+                        GLfloat angle, GLfloat rx, GLfloat ry,
+                        S2D_Color color) {
+
+  if (count <= 0) return;
+
+  // Grow the glyph vertex and index arrays if needed
+  if (count > glyphCapacity) {
+    GLfloat *vertices = (GLfloat *) realloc(glyphVertices, count * 32 * sizeof(GLfloat));
+    GLuint *indices = (GLuint *) realloc(glyphIndices, count * 6 * sizeof(GLuint));
+    if (vertices) glyphVertices = vertices;
+    if (indices) glyphIndices = indices;
+    if (!vertices || !indices) {
+      S2D_Error("S2D_GL3_DrawGlyphs", "Out of memory!");
+      return;
+    }
+    for (int i = glyphCapacity; i < count; i++) {
+      GLuint v = i * 4;
+      GLuint *idx = &glyphIndices[i * 6];
+      idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+      idx[3] = v + 2; idx[4] = v + 3; idx[5] = v;
+    }
+    glyphCapacity = count;
+  }
+
+  // Textures are not buffered, so flush to keep the correct Z order
+  S2D_GL3_FlushBuffers();
+
+  GLfloat rad = angle * M_PI / 180.0;
+  GLfloat sa = sin(rad);
+  GLfloat ca = cos(rad);
+
+  GLfloat *v = glyphVertices;
+
+  for (int i = 0; i < count; i++) {
+    const GLfloat *q = &quads[i * 8];
+
+    GLfloat x1 = x + q[0] * scale, y1 = y + q[1] * scale;
+    GLfloat x2 = x + q[2] * scale, y2 = y + q[3] * scale;
+
+    // Corners in top-left, top-right, bottom-right, bottom-left order
+    GLfloat cx[4] = { x1, x2, x2, x1 };
+    GLfloat cy[4] = { y1, y1, y2, y2 };
+    GLfloat tx[4] = { q[4], q[6], q[6], q[4] };
+    GLfloat ty[4] = { q[5], q[5], q[7], q[7] };
+
+    for (int c = 0; c < 4; c++) {
+      GLfloat px = cx[c], py = cy[c];
+      if (angle != 0) {
+        px = (cx[c] - rx) * ca - (cy[c] - ry) * sa + rx;
+        py = (cx[c] - rx) * sa + (cy[c] - ry) * ca + ry;
+      }
+      v[0] = px; v[1] = py;
+      v[2] = color.r; v[3] = color.g; v[4] = color.b; v[5] = color.a;
+      v[6] = tx[c]; v[7] = ty[c];
+      v += 8;
+    }
+  }
 
-  // Bind the texture using the provided ID
+  // Use the distance field shader program
+  glUseProgram(sdfShaderProgram);
+
+  // Bind the atlas texture
   glBindTexture(GL_TEXTURE_2D, texture_id);
 
-  // Create and Initialize the vertex data and array indices
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+  // Upload the vertex data and array indices
+  glBufferData(GL_ARRAY_BUFFER, count * 32 * sizeof(GLfloat), glyphVertices, GL_STREAM_DRAW);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * 6 * sizeof(GLuint), glyphIndices, GL_STREAM_DRAW);
+
+  // Render all glyphs at once
+  glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT, 0);
+  S2D_GL_CountDrawCalls(1);
+}
 
-  // Render the textured quad
-  glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+/*
+ * Draw a mesh, uploading it first if needed
+ */
+void S2D_GL3_DrawMesh(S2D_Mesh *mesh, GLfloat mvpMatrix[16]) {
+
+  // Draw what's been batched before the mesh
+  S2D_GL3_FlushBuffers();
+
+  if (mesh->vao == 0) {
+    glGenVertexArrays(1, &mesh->vao);
+    glBindVertexArray(mesh->vao);
+
+    glGenBuffers(1, &mesh->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh->vertex_count * 8 * sizeof(GLfloat),
+                 mesh->vertices, GL_STATIC_DRAW);
+
+    // The same layout as the primary buffer
+    GLint posAttrib = glGetAttribLocation(texShaderProgram, "position");
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), 0);
+    glEnableVertexAttribArray(posAttrib);
+
+    GLint colAttrib = glGetAttribLocation(texShaderProgram, "color");
+    glVertexAttribPointer(colAttrib, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(2 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(colAttrib);
+
+    GLint texAttrib = glGetAttribLocation(texShaderProgram, "texcoord");
+    glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(GLfloat), (void*)(6 * sizeof(GLfloat)));
+    glEnableVertexAttribArray(texAttrib);
+  } else {
+    glBindVertexArray(mesh->vao);
+  }
+
+  // Apply the mesh transform to both programs
+  S2D_GL3_ApplyProjection(mvpMatrix);
+
+  for (int i = 0; i < mesh->batch_count; i++) {
+    S2D_MeshBatch *b = &mesh->batches[i];
+    if (b->texture_id) {
+      glUseProgram(texShaderProgram);
+      glBindTexture(GL_TEXTURE_2D, b->texture_id);
+    } else {
+      glUseProgram(shaderProgram);
+    }
+    glDrawArrays(GL_TRIANGLES, b->first, b->count);
+  }
+  S2D_GL_CountDrawCalls(mesh->batch_count);
+
+  // Go back to the primary buffer
+  glBindVertexArray(vao);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
 }
 
 
@@ -16,6 +16,36 @@ static GLuint texColorLocation;
 static GLuint texCoordLocation;
 static GLuint samplerLocation;
 
+// Distance field text shader
+static GLuint sdfShaderProgram;
+static GLuint sdfPositionLocation;
+static GLuint sdfColorLocation;
+static GLuint sdfCoordLocation;
+static GLuint sdfSamplerLocation;
+static GLuint sdfSmoothingLocation;
+
+// Vertex and index data for drawing glyphs
+static GLfloat *glyphVertices = NULL;
+static GLushort *glyphIndices = NULL;
+static int glyphCapacity = 0;
+
+// Glyphs per draw call, limited by 16-bit indices
+#define S2D_GLES_MAX_GLYPHS 16383
+
+// Circle, ring, and arc shader
+static GLuint shapeShaderProgram;
+static GLuint shapePositionLocation;
+static GLuint shapeColorLocation;
+static GLuint shapeLocalLocation;
+static GLuint shapeLocation;
+static GLint shapePixelLocation;
+
+// Shapes batched before they're drawn, as quads of 12 floats per vertex
+#define S2D_GLES_MAX_SHAPES 1024
+static GLfloat shapeVertices[S2D_GLES_MAX_SHAPES * 4 * 12];
+static GLushort shapeIndices[S2D_GLES_MAX_SHAPES * 6];
+static int shapeCount = 0;
+
 static GLushort indices[] =
   { 0, 1, 2,
     2, 3, 0 };
@@ -41,6 +71,22 @@ void S2D_GLES_ApplyProjection(GLfloat orthoMatrix[16]) {
     glGetUniformLocation(texShaderProgram, "u_mvpMatrix"),
     1, GL_FALSE, orthoMatrix
   );
+
+  // Use the distance field program object
+  glUseProgram(sdfShaderProgram);
+
+  glUniformMatrix4fv(
+    glGetUniformLocation(sdfShaderProgram, "u_mvpMatrix"),
+    1, GL_FALSE, orthoMatrix
+  );
+
+  // Use the shape program object
+  glUseProgram(shapeShaderProgram);
+
+  glUniformMatrix4fv(
+    glGetUniformLocation(shapeShaderProgram, "u_mvpMatrix"),
+    1, GL_FALSE, orthoMatrix
+  );
 }
 
 
@@ -98,10 +144,85 @@ int S2D_GLES_Init() {
     "  gl_FragColor = texture2D(s_texture, v_texcoord) * v_color;"
     "}";
 
+  // Fragment shader source string for distance field text
+  GLchar sdfFragmentSource[] =
+    "precision mediump float;"
+    // input vertex color from vertex shader
+    "varying vec4 v_color;"
+    "varying vec2 v_texcoord;"
+    "uniform sampler2D s_texture;"
+    // edge softness, since derivatives aren't available in ES 2.0
+    "uniform float u_smoothing;"
+
+    "void main()"
+    "{"
+    "  float dist = texture2D(s_texture, v_texcoord).a;"
+    "  float alpha = smoothstep(0.5 - u_smoothing, 0.5 + u_smoothing, dist);"
+    "  gl_FragColor = vec4(v_color.rgb, v_color.a * alpha);"
+    "}";
+
+  // Vertex shader source string for shapes, which are shaded by the distance
+  // of each fragment from the center, given in `a_local`
+  GLchar shapeVertexSource[] =
+    "uniform mat4 u_mvpMatrix;"
+    "attribute vec4 a_position;"
+    "attribute vec4 a_color;"
+    "attribute vec2 a_local;"  // position relative to the center
+    "attribute vec4 a_shape;"  // radius, inner radius, start and end angles in degrees
+
+    "varying vec4 v_color;"
+    "varying vec2 v_local;"
+    "varying vec2 v_radii;"
+    "varying vec4 v_edges;"  // directions of the start and end of an arc
+    "varying float v_arc;"   // 0 for the whole circle, 1 up to a half, 2 for more
+
+    "void main()"
+    "{"
+    "  v_color = a_color;"
+    "  v_local = a_local;"
+    "  v_radii = a_shape.xy;"
+    "  float span = a_shape.w - a_shape.z;"
+    "  v_arc = span >= 360.0 ? 0.0 : span <= 180.0 ? 1.0 : 2.0;"
+    "  vec2 a = radians(a_shape.zw);"
+    "  v_edges = vec4(cos(a.x), sin(a.x), cos(a.y), sin(a.y));"
+    "  gl_Position = u_mvpMatrix * a_position;"
+    "}";
+
+  // Fragment shader source string for shapes
+  GLchar shapeFragmentSource[] =
+    // distances in pixels need more precision than colors
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "varying vec4 v_color;"
+    "varying vec2 v_local;"
+    "varying vec2 v_radii;"
+    "varying vec4 v_edges;"
+    "varying float v_arc;"
+    "uniform float u_pixel;"  // width of a pixel in the world
+
+    "void main()"
+    "{"
+    // Edges are smoothed over a pixel, whose width is given since derivatives
+    // aren't available in ES 2.0
+    "  float d = length(v_local);"
+    "  float alpha = clamp((v_radii.x - d) / u_pixel + 0.5, 0.0, 1.0);"
+    "  if (v_radii.y > 0.0) alpha *= clamp((d - v_radii.y) / u_pixel + 0.5, 0.0, 1.0);"
+    "  if (v_arc > 0.5) {"
+    "    float s = (v_edges.x * v_local.y - v_edges.y * v_local.x) / u_pixel + 0.5;"
+    "    float e = (v_local.x * v_edges.w - v_local.y * v_edges.z) / u_pixel + 0.5;"
+    "    alpha *= clamp(v_arc < 1.5 ? min(s, e) : max(s, e), 0.0, 1.0);"
+    "  }"
+    "  gl_FragColor = vec4(v_color.rgb, v_color.a * alpha);"
+    "}";
+
   // Load the vertex and fragment shaders
   GLuint vertexShader      = S2D_GL_LoadShader(  GL_VERTEX_SHADER,      vertexSource, "GLES Vertex");
   GLuint fragmentShader    = S2D_GL_LoadShader(GL_FRAGMENT_SHADER,    fragmentSource, "GLES Fragment");
   GLuint texFragmentShader = S2D_GL_LoadShader(GL_FRAGMENT_SHADER, texFragmentSource, "GLES Texture Fragment");
+  GLuint sdfFragmentShader = S2D_GL_LoadShader(GL_FRAGMENT_SHADER, sdfFragmentSource, "GLES SDF Fragment");
 
   // Triangle Shader //
 
@@ -157,10 +278,82 @@ int S2D_GLES_Init() {
   // Get the sampler location
   samplerLocation = glGetUniformLocation(texShaderProgram, "s_texture");
 
+  // Distance Field Shader //
+
+  // Create the distance field shader program object
+  sdfShaderProgram = glCreateProgram();
+
+  // Check if program was created successfully
+  if (sdfShaderProgram == 0) {
+    S2D_GL_PrintError("Failed to create shader program");
+    return GL_FALSE;
+  }
+
+  // Attach the shader objects to the program object
+  glAttachShader(sdfShaderProgram, vertexShader);
+  glAttachShader(sdfShaderProgram, sdfFragmentShader);
+
+  // Link the shader program
+  glLinkProgram(sdfShaderProgram);
+
+  // Check if linked
+  S2D_GL_CheckLinked(sdfShaderProgram, "GLES SDF shader");
+
+  // Get the attribute locations
+  sdfPositionLocation = glGetAttribLocation(sdfShaderProgram, "a_position");
+  sdfColorLocation    = glGetAttribLocation(sdfShaderProgram, "a_color");
+  sdfCoordLocation    = glGetAttribLocation(sdfShaderProgram, "a_texcoord");
+
+  // Get the uniform locations
+  sdfSamplerLocation   = glGetUniformLocation(sdfShaderProgram, "s_texture");
+  sdfSmoothingLocation = glGetUniformLocation(sdfShaderProgram, "u_smoothing");
+
+  // Shape Shader //
+
+  GLuint shapeVertexShader   = S2D_GL_LoadShader(  GL_VERTEX_SHADER,   shapeVertexSource, "GLES Shape Vertex");
+  GLuint shapeFragmentShader = S2D_GL_LoadShader(GL_FRAGMENT_SHADER, shapeFragmentSource, "GLES Shape Fragment");
+
+  // Create the shape shader program object
+  shapeShaderProgram = glCreateProgram();
+
+  // Check if program was created successfully
+  if (shapeShaderProgram == 0) {
+    S2D_GL_PrintError("Failed to create shader program");
+    return GL_FALSE;
+  }
+
+  // Attach the shader objects to the program object
+  glAttachShader(shapeShaderProgram, shapeVertexShader);
+  glAttachShader(shapeShaderProgram, shapeFragmentShader);
+
+  // Link the shader program
+  glLinkProgram(shapeShaderProgram);
+
+  // Check if linked
+  S2D_GL_CheckLinked(shapeShaderProgram, "GLES shape shader");
+
+  // Get the attribute locations
+  shapePositionLocation = glGetAttribLocation(shapeShaderProgram, "a_position");
+  shapeColorLocation    = glGetAttribLocation(shapeShaderProgram, "a_color");
+  shapeLocalLocation    = glGetAttribLocation(shapeShaderProgram, "a_local");
+  shapeLocation         = glGetAttribLocation(shapeShaderProgram, "a_shape");
+  shapePixelLocation    = glGetUniformLocation(shapeShaderProgram, "u_pixel");
+
+  // Every shape is a quad of two triangles
+  for (int i = 0; i < S2D_GLES_MAX_SHAPES; i++) {
+    GLushort v = i * 4;
+    GLushort *idx = &shapeIndices[i * 6];
+    idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+    idx[3] = v + 2; idx[4] = v + 3; idx[5] = v;
+  }
+
   // Clean up
   glDeleteShader(vertexShader);
   glDeleteShader(fragmentShader);
   glDeleteShader(texFragmentShader);
+  glDeleteShader(sdfFragmentShader);
+  glDeleteShader(shapeVertexShader);
+  glDeleteShader(shapeFragmentShader);
 
   return GL_TRUE;
 }
@@ -176,6 +369,9 @@ void S2D_GLES_DrawTriangle(GLfloat x1, GLfloat y1,
                            GLfloat x3, GLfloat y3,
                            GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3) {
 
+  // Draw batched shapes first, to keep the Z order
+  S2D_GLES_FlushBuffers();
+
   GLfloat vertices[] =
     { x1, y1, 0.f,
       x2, y2, 0.f,
@@ -198,6 +394,67 @@ void S2D_GLES_DrawTriangle(GLfloat x1, GLfloat y1,
 
   // draw
   glDrawArrays(GL_TRIANGLES, 0, 3);
+  S2D_GL_CountDrawCalls(1);
+}
+
+
+/*
+ * Draw the batched shapes and reset the batch
+ */
+void S2D_GLES_FlushBuffers() {
+  if (shapeCount == 0) return;
+
+  glUseProgram(shapeShaderProgram);
+  glUniform1f(shapePixelLocation, S2D_GL_GetPixelSize());
+
+  // Load the vertex positions, colors, positions from the center, and shapes
+  glVertexAttribPointer(shapePositionLocation, 2, GL_FLOAT, GL_FALSE,
+                        12 * sizeof(GLfloat), shapeVertices);
+  glEnableVertexAttribArray(shapePositionLocation);
+
+  glVertexAttribPointer(shapeColorLocation, 4, GL_FLOAT, GL_FALSE,
+                        12 * sizeof(GLfloat), &shapeVertices[2]);
+  glEnableVertexAttribArray(shapeColorLocation);
+
+  glVertexAttribPointer(shapeLocalLocation, 2, GL_FLOAT, GL_FALSE,
+                        12 * sizeof(GLfloat), &shapeVertices[6]);
+  glEnableVertexAttribArray(shapeLocalLocation);
+
+  glVertexAttribPointer(shapeLocation, 4, GL_FLOAT, GL_FALSE,
+                        12 * sizeof(GLfloat), &shapeVertices[8]);
+  glEnableVertexAttribArray(shapeLocation);
+
+  glDrawElements(GL_TRIANGLES, shapeCount * 6, GL_UNSIGNED_SHORT, shapeIndices);
+  S2D_GL_CountDrawCalls(1);
+
+  // The other shaders don't use these
+  glDisableVertexAttribArray(shapeLocalLocation);
+  glDisableVertexAttribArray(shapeLocation);
+
+  shapeCount = 0;
+}
+
+
+/*
+ * Draw a circle, ring, or arc as a quad around it, batched with other shapes
+ */
+void S2D_GLES_DrawShape(GLfloat x, GLfloat y, GLfloat radius, GLfloat inner,
+                        GLfloat start, GLfloat end, S2D_Color c) {
+
+  if (shapeCount == S2D_GLES_MAX_SHAPES) S2D_GLES_FlushBuffers();
+
+  // A pixel larger than the shape, for its smoothed edge
+  GLfloat e = radius + S2D_GL_GetPixelSize();
+
+  GLfloat vertices[] =
+  //  vertex coords  | colors            | local  | radii, angles
+    { x - e, y - e,    c.r, c.g, c.b, c.a,  -e, -e,   radius, inner, start, end,
+      x + e, y - e,    c.r, c.g, c.b, c.a,   e, -e,   radius, inner, start, end,
+      x + e, y + e,    c.r, c.g, c.b, c.a,   e,  e,   radius, inner, start, end,
+      x - e, y + e,    c.r, c.g, c.b, c.a,  -e,  e,   radius, inner, start, end };
+
+  memcpy(&shapeVertices[shapeCount * 4 * 12], vertices, sizeof(vertices));
+  shapeCount++;
 }
 
 
@@ -211,6 +468,8 @@ static void S2D_GLES_DrawTexture(int x, int y, int w, int h,
                                  GLfloat tx3, GLfloat ty3, GLfloat tx4, GLfloat ty4,
                                  GLuint texture_id) {
 
+  S2D_GLES_FlushBuffers();
+
   S2D_GL_Point v1 = { .x = x,     .y = y     };
   S2D_GL_Point v2 = { .x = x + w, .y = y     };
   S2D_GL_Point v3 = { .x = x + w, .y = y + h };
@@ -261,6 +520,151 @@ static void S2D_GLES_DrawTexture(int x, int y, int w, int h,
   glUniform1i(samplerLocation, 0);
 
   glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, indices);
+  S2D_GL_CountDrawCalls(1);
+}
+
+
+/*
+ * Draw glyph quads from a distance field atlas
+ */
+void S2D_GLES_DrawGlyphs(GLuint texture_id, const GLfloat *quads, int count,
+                         GLfloat x, GLfloat y, GLfloat scale,
+                         GLfloat angle, GLfloat rx, GLfloat ry,
+                         S2D_Color color, GLfloat smoothing) {
+
+  if (count <= 0) return;
+  S2D_GLES_FlushBuffers();
+
+  int batch = count < S2D_GLES_MAX_GLYPHS ? count : S2D_GLES_MAX_GLYPHS;
+
+  // Grow the glyph vertex and index arrays if needed
+  if (batch > glyphCapacity) {
+    GLfloat *vertices = (GLfloat *) realloc(glyphVertices, batch * 32 * sizeof(GLfloat));
+    GLushort *indices = (GLushort *) realloc(glyphIndices, batch * 6 * sizeof(GLushort));
+    if (vertices) glyphVertices = vertices;
+    if (indices) glyphIndices = indices;
+    if (!vertices || !indices) {
+      S2D_Error("S2D_GLES_DrawGlyphs", "Out of memory!");
+      return;
+    }
+    for (int i = glyphCapacity; i < batch; i++) {
+      GLushort v = i * 4;
+      GLushort *idx = &glyphIndices[i * 6];
+      idx[0] = v; idx[1] = v + 1; idx[2] = v + 2;
+      idx[3] = v + 2; idx[4] = v + 3; idx[5] = v;
+    }
+    glyphCapacity = batch;
+  }
+
+  glUseProgram(sdfShaderProgram);
+
+  // Bind the atlas texture
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture_id);
+  glUniform1i(sdfSamplerLocation, 0);
+  glUniform1f(sdfSmoothingLocation, smoothing);
+
+  GLfloat rad = angle * M_PI / 180.0;
+  GLfloat sa = sin(rad);
+  GLfloat ca = cos(rad);
+
+  for (int first = 0; first < count; first += batch) {
+    int n = count - first < batch ? count - first : batch;
+    GLfloat *v = glyphVertices;
+
+    for (int i = first; i < first + n; i++) {
+      const GLfloat *q = &quads[i * 8];
+
+      GLfloat x1 = x + q[0] * scale, y1 = y + q[1] * scale;
+      GLfloat x2 = x + q[2] * scale, y2 = y + q[3] * scale;
+
+      // Corners in top-left, top-right, bottom-right, bottom-left order
+      GLfloat cx[4] = { x1, x2, x2, x1 };
+      GLfloat cy[4] = { y1, y1, y2, y2 };
+      GLfloat tx[4] = { q[4], q[6], q[6], q[4] };
+      GLfloat ty[4] = { q[5], q[5], q[7], q[7] };
+
+      for (int c = 0; c < 4; c++) {
+        GLfloat px = cx[c], py = cy[c];
+        if (angle != 0) {
+          px = (cx[c] - rx) * ca - (cy[c] - ry) * sa + rx;
+          py = (cx[c] - rx) * sa + (cy[c] - ry) * ca + ry;
+        }
+        v[0] = px; v[1] = py;
+        v[2] = color.r; v[3] = color.g; v[4] = color.b; v[5] = color.a;
+        v[6] = tx[c]; v[7] = ty[c];
+        v += 8;
+      }
+    }
+
+    // Load the vertex positions, colors, and texture coordinates
+    glVertexAttribPointer(sdfPositionLocation, 2, GL_FLOAT, GL_FALSE,
+                          8 * sizeof(GLfloat), glyphVertices);
+    glEnableVertexAttribArray(sdfPositionLocation);
+
+    glVertexAttribPointer(sdfColorLocation, 4, GL_FLOAT, GL_FALSE,
+                          8 * sizeof(GLfloat), &glyphVertices[2]);
+    glEnableVertexAttribArray(sdfColorLocation);
+
+    glVertexAttribPointer(sdfCoordLocation, 2, GL_FLOAT, GL_FALSE,
+                          8 * sizeof(GLfloat), &glyphVertices[6]);
+    glEnableVertexAttribArray(sdfCoordLocation);
+
+    glDrawElements(GL_TRIANGLES, n * 6, GL_UNSIGNED_SHORT, glyphIndices);
+    S2D_GL_CountDrawCalls(1);
+  }
+}
+
+
+/*
+ * Draw a mesh, uploading it first if needed
+ */
+void S2D_GLES_DrawMesh(S2D_Mesh *mesh, GLfloat mvpMatrix[16]) {
+
+  S2D_GLES_FlushBuffers();
+
+  if (mesh->vbo == 0) {
+    glGenBuffers(1, &mesh->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBufferData(GL_ARRAY_BUFFER, mesh->vertex_count * 8 * sizeof(GLfloat),
+                 mesh->vertices, GL_STATIC_DRAW);
+  } else {
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+  }
+
+  // Apply the mesh transform to both programs
+  S2D_GLES_ApplyProjection(mvpMatrix);
+
+  GLsizei stride = 8 * sizeof(GLfloat);
+
+  for (int i = 0; i < mesh->batch_count; i++) {
+    S2D_MeshBatch *b = &mesh->batches[i];
+
+    if (b->texture_id) {
+      glUseProgram(texShaderProgram);
+      glVertexAttribPointer(texPositionLocation, 2, GL_FLOAT, GL_FALSE, stride, 0);
+      glEnableVertexAttribArray(texPositionLocation);
+      glVertexAttribPointer(texColorLocation, 4, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(GLfloat)));
+      glEnableVertexAttribArray(texColorLocation);
+      glVertexAttribPointer(texCoordLocation, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(GLfloat)));
+      glEnableVertexAttribArray(texCoordLocation);
+      glActiveTexture(GL_TEXTURE0);
+      glBindTexture(GL_TEXTURE_2D, b->texture_id);
+      glUniform1i(samplerLocation, 0);
+    } else {
+      glUseProgram(shaderProgram);
+      glVertexAttribPointer(positionLocation, 2, GL_FLOAT, GL_FALSE, stride, 0);
+      glEnableVertexAttribArray(positionLocation);
+      glVertexAttribPointer(colorLocation, 4, GL_FLOAT, GL_FALSE, stride, (void*)(2 * sizeof(GLfloat)));
+      glEnableVertexAttribArray(colorLocation);
+    }
+
+    glDrawArrays(GL_TRIANGLES, b->first, b->count);
+  }
+  S2D_GL_CountDrawCalls(mesh->batch_count);
+
+  // Other draws use client-side arrays
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 
@@ -96,6 +96,47 @@ S2D_Image *S2D_CreateImage(const char *path) {
 }
 
 
+/*
+ * Arguments of S2D_CreateImageRange, for the images of a range of paths
+ */
+typedef struct {
+  const char **paths;
+  S2D_Image **images;
+} S2D_CreateImagesArgs;
+
+
+/*
+ * Create the images of a range of paths
+ */
+static void S2D_CreateImageRange(int first, int last, void *data) {
+  S2D_CreateImagesArgs *args = (S2D_CreateImagesArgs *) data;
+  for (int i = first; i < last; i++) {
+    args->images[i] = S2D_CreateImage(args->paths[i]);
+  }
+}
+
+
+/*
+ * Create images from files, decoding them in parallel
+ */
+int S2D_CreateImages(const char **paths, int count, S2D_Image **images) {
+  if (!paths || !images || count <= 0) return 0;
+  S2D_Init();
+
+  // Load the decoders before they're used from several threads
+  IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP);
+
+  S2D_CreateImagesArgs args = { paths, images };
+  S2D_ParallelFor(count, 1, S2D_CreateImageRange, &args);
+
+  int created = 0;
+  for (int i = 0; i < count; i++) {
+    if (images[i]) created++;
+  }
+  return created;
+}
+
+
 /*
  * Rotate an image
  */
@@ -46,3 +46,213 @@ void S2D_ShowCursor() {
 void S2D_HideCursor() {
   SDL_ShowCursor(SDL_DISABLE);
 }
+
+
+// Keys held down, as a bitset for lookups and a compact list for iterating
+static Uint32 held_bits[SDL_NUM_SCANCODES / 32];
+static int held_list[SDL_NUM_SCANCODES];
+static int held_index[SDL_NUM_SCANCODES];  // position of each key in the list
+static int held_count = 0;
+
+// Keys pressed and released since the last frame
+static Uint32 pressed_bits[SDL_NUM_SCANCODES / 32];
+static Uint32 released_bits[SDL_NUM_SCANCODES / 32];
+
+// Mouse buttons held down, pressed, and released, as bits by button number
+static Uint32 mouse_down = 0;
+static Uint32 mouse_pressed = 0;
+static Uint32 mouse_released = 0;
+
+// Polled controller state
+static S2D_ControllerState controllers[S2D_MAX_CONTROLLERS];
+
+
+/*
+ * Mark a key as held down or released
+ */
+void S2D_SetKeyHeld(int scancode, bool held) {
+  if (scancode < 0 || scancode >= SDL_NUM_SCANCODES) return;
+
+  Uint32 bit = 1u << (scancode % 32);
+  bool was_held = held_bits[scancode / 32] & bit;
+  if (held == was_held) return;
+
+  if (held) {
+    held_bits[scancode / 32] |= bit;
+    pressed_bits[scancode / 32] |= bit;
+    held_index[scancode] = held_count;
+    held_list[held_count++] = scancode;
+  } else {
+    // Move the last key into the released key's place
+    held_bits[scancode / 32] &= ~bit;
+    released_bits[scancode / 32] |= bit;
+    int last = held_list[--held_count];
+    held_list[held_index[scancode]] = last;
+    held_index[last] = held_index[scancode];
+  }
+}
+
+
+/*
+ * Get the keys held down, returning how many there are
+ */
+int S2D_GetHeldKeys(const int **scancodes) {
+  if (scancodes) *scancodes = held_list;
+  return held_count;
+}
+
+
+/*
+ * Start a new frame of polled input
+ */
+void S2D_BeginInputFrame() {
+  memset(pressed_bits, 0, sizeof(pressed_bits));
+  memset(released_bits, 0, sizeof(released_bits));
+  mouse_pressed = 0;
+  mouse_released = 0;
+  for (int i = 0; i < S2D_MAX_CONTROLLERS; i++) {
+    if (!controllers[i].connected) continue;
+    memset(controllers[i].pressed, 0, sizeof(controllers[i].pressed));
+    memset(controllers[i].released, 0, sizeof(controllers[i].released));
+  }
+}
+
+
+/*
+ * Get the state of a controller, adding it if it's new
+ */
+static S2D_ControllerState *S2D_ControllerSlot(int which, bool add) {
+  S2D_ControllerState *free_slot = NULL;
+  for (int i = 0; i < S2D_MAX_CONTROLLERS; i++) {
+    if (controllers[i].connected && controllers[i].which == which) return &controllers[i];
+    if (!controllers[i].connected && !free_slot) free_slot = &controllers[i];
+  }
+  if (!add || !free_slot) return NULL;
+
+  memset(free_slot, 0, sizeof(S2D_ControllerState));
+  free_slot->connected = true;
+  free_slot->which = which;
+  return free_slot;
+}
+
+
+/*
+ * Update polled input state from an event, and call the window's callback
+ */
+void S2D_DispatchInput(S2D_Window *window, int device, S2D_Event e) {
+  bool callbacks = window->input_callbacks;
+
+  if (window->replay) S2D_RecordInput(window, device, e);
+
+  switch (device) {
+
+    case S2D_KEYBOARD:
+      if (e.type == S2D_KEY_DOWN) S2D_SetKeyHeld(e.scancode, true);
+      else if (e.type == S2D_KEY_UP) S2D_SetKeyHeld(e.scancode, false);
+
+      if (window->on_key && callbacks) {
+        if (window->key_names && !e.key) e.key = SDL_GetScancodeName(e.scancode);
+        window->on_key(e);
+      }
+      break;
+
+    case S2D_MOUSE:
+      if (e.button > 0 && e.button <= 32) {
+        Uint32 bit = 1u << (e.button - 1);
+        if (e.type == S2D_MOUSE_DOWN) {
+          mouse_down |= bit;
+          mouse_pressed |= bit;
+        } else if (e.type == S2D_MOUSE_UP) {
+          mouse_down &= ~bit;
+          mouse_released |= bit;
+        }
+      }
+      if (window->on_mouse && callbacks) window->on_mouse(e);
+      break;
+
+    case S2D_CONTROLLER: {
+      S2D_ControllerState *c = S2D_ControllerSlot(e.which, true);
+      if (c && e.type == S2D_AXIS) {
+        if (e.axis >= 0 && e.axis < S2D_AXIS_MAX) c->axes[e.axis] = e.value;
+      } else if (c && e.button >= 0 && e.button < S2D_BUTTON_MAX) {
+        bool down = e.type == S2D_BUTTON_DOWN;
+        if (down && !c->buttons[e.button]) c->pressed[e.button] = true;
+        if (!down && c->buttons[e.button]) c->released[e.button] = true;
+        c->buttons[e.button] = down;
+      }
+      if (window->on_controller && callbacks) window->on_controller(e);
+      break;
+    }
+  }
+}
+
+
+/*
+ * Check if a key is held down
+ */
+bool S2D_IsKeyDown(int scancode) {
+  if (scancode < 0 || scancode >= SDL_NUM_SCANCODES) return false;
+  return held_bits[scancode / 32] & (1u << (scancode % 32));
+}
+
+
+/*
+ * Check if a key was pressed since the last frame
+ */
+bool S2D_WasKeyPressed(int scancode) {
+  if (scancode < 0 || scancode >= SDL_NUM_SCANCODES) return false;
+  return pressed_bits[scancode / 32] & (1u << (scancode % 32));
+}
+
+
+/*
+ * Check if a key was released since the last frame
+ */
+bool S2D_WasKeyReleased(int scancode) {
+  if (scancode < 0 || scancode >= SDL_NUM_SCANCODES) return false;
+  return released_bits[scancode / 32] & (1u << (scancode % 32));
+}
+
+
+/*
+ * Check if a mouse button is held down
+ */
+bool S2D_IsMouseButtonDown(int button) {
+  if (button <= 0 || button > 32) return false;
+  return mouse_down & (1u << (button - 1));
+}
+
+
+/*
+ * Check if a mouse button was pressed since the last frame
+ */
+bool S2D_WasMouseButtonPressed(int button) {
+  if (button <= 0 || button > 32) return false;
+  return mouse_pressed & (1u << (button - 1));
+}
+
+
+/*
+ * Check if a mouse button was released since the last frame
+ */
+bool S2D_WasMouseButtonReleased(int button) {
+  if (button <= 0 || button > 32) return false;
+  return mouse_released & (1u << (button - 1));
+}
+
+
+/*
+ * Get the polled state of a controller
+ */
+const S2D_ControllerState *S2D_GetControllerState(int which) {
+  return S2D_ControllerSlot(which, false);
+}
+
+
+/*
+ * Forget the state of a removed controller
+ */
+void S2D_RemoveControllerState(int which) {
+  S2D_ControllerState *c = S2D_ControllerSlot(which, false);
+  if (c) c->connected = false;
+}
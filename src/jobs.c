@@ -0,0 +1,410 @@
+// jobs.c
+
+#include "../include/simple2d.h"
+
+#define S2D_JOB_MAX_WORKERS 64
+
+// A job, run once by whichever thread takes it
+typedef struct S2D_Job {
+  S2D_JobFunc fn;
+  S2D_RangeFunc range_fn;  // called instead of `fn`, for a range of indices
+  void *data;
+  int first;
+  int last;
+  S2D_JobCounter *counter;  // decremented when done, or NULL
+  struct S2D_Job *next;  // in the jobs waiting on a counter
+} S2D_Job;
+
+// Jobs of a thread, pushed and popped at the bottom by the thread and stolen
+// from the top by others. Indices only grow, and wrap around the buffer.
+typedef struct {
+  S2D_Job **jobs;
+  int top;
+  int bottom;
+  int capacity;  // a power of two
+  SDL_SpinLock lock;
+} S2D_JobDeque;
+
+// Queues of the workers, then one shared by threads outside the pool
+static S2D_JobDeque deques[S2D_JOB_MAX_WORKERS + 1];
+static SDL_Thread *workers[S2D_JOB_MAX_WORKERS];
+static int worker_count = 0;
+static SDL_atomic_t jobs_initted;  // set once the workers are started
+static SDL_SpinLock init_lock = 0;
+
+static SDL_sem *work_sem = NULL;  // posted for each job queued
+static SDL_atomic_t jobs_quit;
+static SDL_TLSID worker_tls = 0;  // index of a worker thread, plus 1
+
+
+/*
+ * Get the index of the calling thread's queue
+ */
+static int S2D_JobQueueIndex() {
+  intptr_t index = (intptr_t)SDL_TLSGet(worker_tls);
+  return index > 0 ? (int)index - 1 : worker_count;
+}
+
+
+/*
+ * Push a job at the bottom of a queue
+ */
+static bool S2D_PushJob(S2D_JobDeque *d, S2D_Job *job) {
+  SDL_AtomicLock(&d->lock);
+
+  if (d->bottom - d->top == d->capacity) {
+    int capacity = d->capacity ? d->capacity * 2 : 64;
+    S2D_Job **jobs = (S2D_Job **) malloc(capacity * sizeof(S2D_Job *));
+    if (!jobs) {
+      SDL_AtomicUnlock(&d->lock);
+      return false;
+    }
+    for (int i = d->top; i != d->bottom; i++) {
+      jobs[i & (capacity - 1)] = d->jobs[i & (d->capacity - 1)];
+    }
+    free(d->jobs);
+    d->jobs = jobs;
+    d->capacity = capacity;
+  }
+
+  d->jobs[d->bottom & (d->capacity - 1)] = job;
+  d->bottom++;
+
+  SDL_AtomicUnlock(&d->lock);
+  return true;
+}
+
+
+/*
+ * Take a job from the bottom of a queue, the most recently pushed
+ */
+static S2D_Job *S2D_PopJob(S2D_JobDeque *d) {
+  S2D_Job *job = NULL;
+  SDL_AtomicLock(&d->lock);
+  if (d->bottom != d->top) {
+    d->bottom--;
+    job = d->jobs[d->bottom & (d->capacity - 1)];
+  }
+  SDL_AtomicUnlock(&d->lock);
+  return job;
+}
+
+
+/*
+ * Take a job from the top of another thread's queue, the oldest pushed
+ */
+static S2D_Job *S2D_StealJob(S2D_JobDeque *d) {
+  S2D_Job *job = NULL;
+  SDL_AtomicLock(&d->lock);
+  if (d->bottom != d->top) {
+    job = d->jobs[d->top & (d->capacity - 1)];
+    d->top++;
+  }
+  SDL_AtomicUnlock(&d->lock);
+  return job;
+}
+
+
+/*
+ * Find a job for a thread: its own newest, or the oldest of another
+ */
+static S2D_Job *S2D_FindJob(int self) {
+  S2D_Job *job = S2D_PopJob(&deques[self]);
+  if (job) return job;
+
+  // Start from the next queue, so threads don't all steal from the first
+  int queues = worker_count + 1;
+  for (int i = 1; i < queues; i++) {
+    job = S2D_StealJob(&deques[(self + i) % queues]);
+    if (job) return job;
+  }
+  return NULL;
+}
+
+
+static void S2D_QueueJob(S2D_Job *job);
+
+
+/*
+ * Count a job as done, starting the jobs waiting for the counter if it was
+ * the last
+ */
+static void S2D_FinishJob(S2D_JobCounter *counter) {
+  SDL_AtomicLock(&counter->lock);
+  S2D_Job *waiting = NULL;
+  if (SDL_AtomicAdd(&counter->count, -1) == 1) {
+    waiting = (S2D_Job *) counter->waiting;
+    counter->waiting = NULL;
+  }
+  SDL_AtomicUnlock(&counter->lock);
+
+  // The counter may be gone once unlocked, since its waiter can return
+  while (waiting) {
+    S2D_Job *next = waiting->next;
+    S2D_QueueJob(waiting);
+    waiting = next;
+  }
+}
+
+
+/*
+ * Run a job and free it
+ */
+static void S2D_RunJobNow(S2D_Job *job) {
+  if (job->range_fn) job->range_fn(job->first, job->last, job->data);
+  else job->fn(job->data);
+
+  S2D_JobCounter *counter = job->counter;
+  free(job);
+  if (counter) S2D_FinishJob(counter);
+}
+
+
+/*
+ * Queue a job on the calling thread's queue, or run it if it can't be queued
+ */
+static void S2D_QueueJob(S2D_Job *job) {
+  if (S2D_PushJob(&deques[S2D_JobQueueIndex()], job)) {
+    SDL_SemPost(work_sem);
+  } else {
+    S2D_RunJobNow(job);
+  }
+}
+
+
+/*
+ * Run jobs until told to quit, sleeping while there are none
+ */
+static int S2D_JobWorker(void *index) {
+  int self = (int)(intptr_t)index;
+  SDL_TLSSet(worker_tls, (void *)(intptr_t)(self + 1), NULL);
+
+  while (!SDL_AtomicGet(&jobs_quit)) {
+    S2D_Job *job = S2D_FindJob(self);
+    if (job) S2D_RunJobNow(job);
+    else SDL_SemWait(work_sem);
+  }
+
+  return 0;
+}
+
+
+/*
+ * Start the worker threads, with `init_lock` held
+ */
+static int S2D_StartJobWorkers(int count) {
+
+  // With none, jobs are run by the threads waiting for them
+  if (count == 0) count = SDL_GetCPUCount() - 1;
+  if (count < 0) count = 0;
+  if (count > S2D_JOB_MAX_WORKERS) count = S2D_JOB_MAX_WORKERS;
+
+  if (!worker_tls) worker_tls = SDL_TLSCreate();
+  work_sem = SDL_CreateSemaphore(0);
+  if (!worker_tls || !work_sem) {
+    S2D_Error("S2D_InitJobs", SDL_GetError());
+    if (work_sem) SDL_DestroySemaphore(work_sem);
+    work_sem = NULL;
+    return 1;
+  }
+
+  SDL_AtomicSet(&jobs_quit, 0);
+  worker_count = count;
+  for (int i = 0; i < count; i++) {
+    workers[i] = SDL_CreateThread(S2D_JobWorker, "S2D_JobWorker", (void *)(intptr_t)i);
+    if (!workers[i]) {
+      S2D_Log(S2D_WARN, "Could not start job worker (%s)", SDL_GetError());
+    }
+  }
+
+  SDL_AtomicSet(&jobs_initted, 1);
+  S2D_Log(S2D_INFO, "Started %i job worker(s)", count);
+  return 0;
+}
+
+
+/*
+ * Start a pool of worker threads
+ */
+int S2D_InitJobs(int count) {
+  SDL_AtomicLock(&init_lock);
+
+  if (SDL_AtomicGet(&jobs_initted)) {
+    SDL_AtomicUnlock(&init_lock);
+    S2D_Error("S2D_InitJobs", "Jobs already started");
+    return 1;
+  }
+
+  int result = S2D_StartJobWorkers(count);
+  SDL_AtomicUnlock(&init_lock);
+  return result;
+}
+
+
+/*
+ * Start the pool with the default number of workers, if it isn't yet
+ */
+static void S2D_EnsureJobs() {
+  if (SDL_AtomicGet(&jobs_initted)) return;
+  SDL_AtomicLock(&init_lock);
+  if (!SDL_AtomicGet(&jobs_initted)) S2D_StartJobWorkers(0);
+  SDL_AtomicUnlock(&init_lock);
+}
+
+
+/*
+ * Stop the worker threads
+ */
+void S2D_QuitJobs() {
+  SDL_AtomicLock(&init_lock);
+
+  if (!SDL_AtomicGet(&jobs_initted)) {
+    SDL_AtomicUnlock(&init_lock);
+    return;
+  }
+
+  SDL_AtomicSet(&jobs_quit, 1);
+  for (int i = 0; i < worker_count; i++) SDL_SemPost(work_sem);
+  for (int i = 0; i < worker_count; i++) {
+    if (workers[i]) SDL_WaitThread(workers[i], NULL);
+    workers[i] = NULL;
+  }
+
+  // Finish what the workers left, including the jobs those start
+  for (bool ran = true; ran; ) {
+    ran = false;
+    for (int i = 0; i <= worker_count; i++) {
+      S2D_Job *job;
+      while ((job = S2D_StealJob(&deques[i]))) {
+        S2D_RunJobNow(job);
+        ran = true;
+      }
+    }
+  }
+
+  for (int i = 0; i <= worker_count; i++) {
+    free(deques[i].jobs);
+    deques[i] = (S2D_JobDeque){ 0 };
+  }
+
+  SDL_DestroySemaphore(work_sem);
+  work_sem = NULL;
+  worker_count = 0;
+  SDL_AtomicSet(&jobs_initted, 0);
+  SDL_AtomicUnlock(&init_lock);
+}
+
+
+/*
+ * Get the number of worker threads
+ */
+int S2D_GetJobWorkers() {
+  return worker_count;
+}
+
+
+/*
+ * Create a job, counted in `counter` until it's done
+ */
+static S2D_Job *S2D_CreateJob(S2D_JobFunc fn, S2D_RangeFunc range_fn, void *data,
+                              S2D_JobCounter *counter) {
+  S2D_EnsureJobs();
+
+  S2D_Job *job = (S2D_Job *) malloc(sizeof(S2D_Job));
+  if (!job) {
+    S2D_Error("S2D_RunJob", "Out of memory!");
+    return NULL;
+  }
+
+  *job = (S2D_Job){ .fn = fn, .range_fn = range_fn, .data = data, .counter = counter };
+  if (counter) SDL_AtomicAdd(&counter->count, 1);
+  return job;
+}
+
+
+/*
+ * Run a job on the pool
+ */
+void S2D_RunJob(S2D_JobFunc fn, void *data, S2D_JobCounter *counter) {
+  S2D_RunJobAfter(NULL, fn, data, counter);
+}
+
+
+/*
+ * Run a job once the jobs counted in `after` are done
+ */
+void S2D_RunJobAfter(S2D_JobCounter *after, S2D_JobFunc fn, void *data, S2D_JobCounter *counter) {
+  S2D_Job *job = S2D_CreateJob(fn, NULL, data, counter);
+  if (!job) {
+    // Run it here rather than not at all
+    if (after) S2D_WaitJobs(after);
+    fn(data);
+    return;
+  }
+
+  if (after) {
+    SDL_AtomicLock(&after->lock);
+    if (SDL_AtomicGet(&after->count) > 0) {
+      job->next = (S2D_Job *) after->waiting;
+      after->waiting = job;
+      SDL_AtomicUnlock(&after->lock);
+      return;
+    }
+    SDL_AtomicUnlock(&after->lock);
+  }
+
+  S2D_QueueJob(job);
+}
+
+
+/*
+ * Wait for the jobs counted in `counter` to be done
+ */
+void S2D_WaitJobs(S2D_JobCounter *counter) {
+  if (!counter) return;
+
+  while (SDL_AtomicGet(&counter->count) > 0) {
+    S2D_Job *job = SDL_AtomicGet(&jobs_initted) ? S2D_FindJob(S2D_JobQueueIndex()) : NULL;
+    if (job) S2D_RunJobNow(job);
+    else SDL_Delay(0);  // the last jobs are running elsewhere
+  }
+
+  // Let the thread finishing the last job let go of the counter
+  SDL_AtomicLock(&counter->lock);
+  SDL_AtomicUnlock(&counter->lock);
+}
+
+
+/*
+ * Call `fn` for ranges of indices in parallel, and wait for all of them
+ */
+void S2D_ParallelFor(int count, int grain, S2D_RangeFunc fn, void *data) {
+  if (count <= 0) return;
+  S2D_EnsureJobs();
+
+  // A few ranges for each thread, so threads finishing early can steal
+  if (grain <= 0) grain = count / ((worker_count + 1) * 4);
+  if (grain < 1) grain = 1;
+
+  if (worker_count == 0 || count <= grain) {
+    fn(0, count, data);
+    return;
+  }
+
+  // Queue all but the first range, which is run here
+  S2D_JobCounter counter = { { 0 } };
+  for (int first = grain; first < count; first += grain) {
+    S2D_Job *job = S2D_CreateJob(NULL, fn, data, &counter);
+    int last = count - first > grain ? first + grain : count;
+    if (!job) {
+      fn(first, last, data);
+      continue;
+    }
+    job->first = first;
+    job->last = last;
+    S2D_QueueJob(job);
+  }
+
+  fn(0, grain, data);
+  S2D_WaitJobs(&counter);
+}
@@ -0,0 +1,116 @@
+// mesh.c
+
+#include "../include/simple2d.h"
+
+
+/*
+ * Create an empty mesh
+ */
+S2D_Mesh *S2D_CreateMesh() {
+  S2D_Init();
+
+  S2D_Mesh *mesh = (S2D_Mesh *) calloc(1, sizeof(S2D_Mesh));
+  if (!mesh) {
+    S2D_Error("S2D_CreateMesh", "Out of memory!");
+    return NULL;
+  }
+
+  mesh->scale = 1.f;
+  return mesh;
+}
+
+
+/*
+ * Begin recording draws into a mesh
+ */
+void S2D_BeginMesh(S2D_Mesh *mesh) {
+  if (!mesh) return;
+
+  // Replace what was recorded before, including the uploaded copy
+  S2D_GL_FreeMesh(mesh);
+  mesh->vertex_count = 0;
+  mesh->batch_count = 0;
+  mesh->recording = true;
+
+  S2D_GL_RecordMesh(mesh);
+}
+
+
+/*
+ * End recording draws into a mesh
+ */
+void S2D_EndMesh(S2D_Mesh *mesh) {
+  if (!mesh || !mesh->recording) return;
+  mesh->recording = false;
+  S2D_GL_RecordMesh(NULL);
+}
+
+
+/*
+ * Add vertices to the mesh being recorded
+ */
+void S2D_AddMeshVertices(S2D_Mesh *mesh, GLuint texture_id, const GLfloat *vertices, int count) {
+
+  if (mesh->vertex_count + count > mesh->vertex_capacity) {
+    int capacity = mesh->vertex_capacity ? mesh->vertex_capacity * 2 : 96;
+    while (capacity < mesh->vertex_count + count) capacity *= 2;
+    GLfloat *v = (GLfloat *) realloc(mesh->vertices, capacity * 8 * sizeof(GLfloat));
+    if (!v) {
+      S2D_Error("S2D_AddMeshVertices", "Out of memory!");
+      return;
+    }
+    mesh->vertices = v;
+    mesh->vertex_capacity = capacity;
+  }
+
+  // Extend the last batch if it uses the same texture
+  S2D_MeshBatch *last = mesh->batch_count ? &mesh->batches[mesh->batch_count - 1] : NULL;
+  if (last && last->texture_id == texture_id) {
+    last->count += count;
+  } else {
+    if (mesh->batch_count == mesh->batch_capacity) {
+      int capacity = mesh->batch_capacity ? mesh->batch_capacity * 2 : 8;
+      S2D_MeshBatch *b = (S2D_MeshBatch *) realloc(mesh->batches, capacity * sizeof(S2D_MeshBatch));
+      if (!b) {
+        S2D_Error("S2D_AddMeshVertices", "Out of memory!");
+        return;
+      }
+      mesh->batches = b;
+      mesh->batch_capacity = capacity;
+    }
+    mesh->batches[mesh->batch_count++] = (S2D_MeshBatch){
+      texture_id, mesh->vertex_count, count
+    };
+  }
+
+  memcpy(mesh->vertices + mesh->vertex_count * 8, vertices, count * 8 * sizeof(GLfloat));
+  mesh->vertex_count += count;
+}
+
+
+/*
+ * Draw a mesh
+ */
+void S2D_DrawMesh(S2D_Mesh *mesh) {
+  if (!mesh || mesh->vertex_count == 0) return;
+
+  if (mesh->recording) {
+    S2D_Error("S2D_DrawMesh", "Can't draw a mesh while recording it");
+    return;
+  }
+
+  S2D_GL_DrawMesh(mesh);
+}
+
+
+/*
+ * Free a mesh
+ */
+void S2D_FreeMesh(S2D_Mesh *mesh) {
+  if (!mesh) return;
+  S2D_EndMesh(mesh);
+  S2D_GL_FreeMesh(mesh);
+  free(mesh->vertices);
+  free(mesh->batches);
+  free(mesh);
+}
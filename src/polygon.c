@@ -0,0 +1,651 @@
+// polygon.c
+
+#include "../include/simple2d.h"
+
+// Polygons with more vertices are split into monotone pieces before being
+// triangulated, since ear clipping takes time growing with the square
+#define S2D_EAR_CLIPPING_MAX 64
+
+// Working memory of the tessellator, grown as needed
+static double *px, *py;   // points, y flipped and wound counterclockwise
+static int *order;        // index of each working point in the polygon given
+static int *next, *prev;  // neighbors along the boundary
+static int *kinds;        // S2D_SWEEP_* kind of each point
+static int *helper;       // of the edge starting at each point, in the sweep
+static int *active;       // edges crossing the sweep line, from left to right
+static int *sorted;       // points in sweep order
+static int *diagonals;    // pairs of points
+static int *slots;        // first outgoing edge of each point, then the end
+static int *ends;         // of the outgoing edges
+static bool *visited;
+static int *piece;        // points of a monotone piece
+static int *chain, *chain_side;  // a piece's points from the top, and their side
+static int *stack, *stack_side;
+static int *tess_end;     // end of the indices being written
+static int tess_capacity = 0;
+
+// Indices and vertices of polygons drawn with S2D_DrawPolygon
+static int *draw_indices;
+static S2D_Vertex *draw_vertices;
+static int draw_capacity = 0;  // in points
+
+// Kinds of points in the sweep
+#define S2D_SWEEP_START   0
+#define S2D_SWEEP_END     1
+#define S2D_SWEEP_SPLIT   2
+#define S2D_SWEEP_MERGE   3
+#define S2D_SWEEP_REGULAR 4
+
+
+/*
+ * Make room in the working memory for a polygon of `count` points
+ */
+static bool S2D_ReservePolygon(int count) {
+  if (count <= tess_capacity) return true;
+
+  int capacity = tess_capacity ? tess_capacity : 64;
+  while (capacity < count) capacity *= 2;
+
+  // A simple polygon splits along at most count - 3 diagonals, each an edge
+  // both ways, so pieces have fewer than count * 3 edges
+  free(px); free(py); free(order); free(next); free(prev); free(kinds);
+  free(helper); free(active); free(sorted); free(diagonals); free(slots);
+  free(ends); free(visited); free(piece); free(chain); free(chain_side);
+  free(stack); free(stack_side);
+  px         = (double *) malloc(capacity * sizeof(double));
+  py         = (double *) malloc(capacity * sizeof(double));
+  order      = (int *) malloc(capacity * sizeof(int));
+  next       = (int *) malloc(capacity * sizeof(int));
+  prev       = (int *) malloc(capacity * sizeof(int));
+  kinds      = (int *) malloc(capacity * sizeof(int));
+  helper     = (int *) malloc(capacity * sizeof(int));
+  active     = (int *) malloc(capacity * sizeof(int));
+  sorted     = (int *) malloc(capacity * sizeof(int));
+  diagonals  = (int *) malloc(capacity * 2 * sizeof(int));
+  slots      = (int *) malloc((capacity + 1) * sizeof(int));
+  ends       = (int *) malloc(capacity * 3 * sizeof(int));
+  visited    = (bool *) malloc(capacity * 3 * sizeof(bool));
+  piece      = (int *) malloc(capacity * sizeof(int));
+  chain      = (int *) malloc(capacity * sizeof(int));
+  chain_side = (int *) malloc(capacity * sizeof(int));
+  stack      = (int *) malloc(capacity * sizeof(int));
+  stack_side = (int *) malloc(capacity * sizeof(int));
+
+  if (!px || !py || !order || !next || !prev || !kinds || !helper || !active ||
+      !sorted || !diagonals || !slots || !ends || !visited || !piece || !chain ||
+      !chain_side || !stack || !stack_side) {
+    S2D_Error("S2D_TessellatePolygon", "Out of memory!");
+    tess_capacity = 0;
+    return false;
+  }
+
+  tess_capacity = capacity;
+  return true;
+}
+
+
+/*
+ * Get twice the signed area of a triangle of working points, positive when
+ * they turn counterclockwise
+ */
+static double S2D_PolygonCross(int a, int b, int c) {
+  return (px[b] - px[a]) * (py[c] - py[a]) - (py[b] - py[a]) * (px[c] - px[a]);
+}
+
+
+/*
+ * Check if working point `a` comes before `b` in the sweep, from the top
+ */
+static bool S2D_PolygonAbove(int a, int b) {
+  return py[a] > py[b] || (py[a] == py[b] && px[a] < px[b]);
+}
+
+
+/*
+ * Add a triangle of working points to the indices, unless there are already
+ * as many as a simple polygon has
+ */
+static void S2D_PolygonTriangle(int **out, int a, int b, int c) {
+  if (*out == tess_end) return;
+  int *t = *out;
+  t[0] = order[a];
+  t[1] = order[b];
+  t[2] = order[c];
+  *out += 3;
+}
+
+
+/*
+ * Check if a point is inside a triangle, or on its edges
+ */
+static bool S2D_PolygonInTriangle(int p, int a, int b, int c) {
+  return S2D_PolygonCross(a, b, p) >= 0 &&
+         S2D_PolygonCross(b, c, p) >= 0 &&
+         S2D_PolygonCross(c, a, p) >= 0;
+}
+
+
+/*
+ * Triangulate the working points by clipping ears, triangles at convex points
+ * with no other points inside
+ */
+static void S2D_ClipEars(int count, int **out) {
+
+  for (int i = 0; i < count; i++) {
+    next[i] = (i + 1) % count;
+    prev[i] = (i + count - 1) % count;
+  }
+
+  int v = 0, remaining = count, tries = 0;
+  while (remaining > 3) {
+    int a = prev[v], c = next[v];
+    bool ear = S2D_PolygonCross(a, v, c) > 0;
+
+    // Only concave points can be inside an ear
+    for (int p = next[c]; ear && p != a; p = next[p]) {
+      if (S2D_PolygonCross(prev[p], p, next[p]) <= 0 &&
+          S2D_PolygonInTriangle(p, a, v, c) &&
+          (px[p] != px[a] || py[p] != py[a]) &&
+          (px[p] != px[c] || py[p] != py[c])) ear = false;
+    }
+
+    // Without an ear all the way around, the polygon isn't simple, so clip
+    // anyway rather than never finish
+    if (ear || tries > remaining) {
+      S2D_PolygonTriangle(out, a, v, c);
+      next[a] = c;
+      prev[c] = a;
+      remaining--;
+      tries = 0;
+      v = c;
+    } else {
+      tries++;
+      v = c;
+    }
+  }
+
+  S2D_PolygonTriangle(out, prev[v], v, next[v]);
+}
+
+
+/*
+ * Sort the working points in sweep order, merging runs of doubling length
+ * between `sorted` and `temp`
+ */
+static void S2D_SortPolygonPoints(int count, int *temp) {
+  int *from = sorted, *to = temp;
+
+  for (int width = 1; width < count; width *= 2) {
+    for (int first = 0; first < count; first += width * 2) {
+      int mid = first + width < count ? first + width : count;
+      int last = mid + width < count ? mid + width : count;
+      int a = first, b = mid, k = first;
+      while (a < mid && b < last) to[k++] = S2D_PolygonAbove(from[b], from[a]) ? from[b++] : from[a++];
+      while (a < mid) to[k++] = from[a++];
+      while (b < last) to[k++] = from[b++];
+    }
+    int *t = from; from = to; to = t;
+  }
+
+  if (from != sorted) memcpy(sorted, from, count * sizeof(int));
+}
+
+
+/*
+ * Get the x coordinate where an edge crosses the sweep line, at point `v`
+ */
+static double S2D_PolygonEdgeX(int e, int v) {
+  int f = next[e];
+  if (py[e] == py[f]) return fmax(fmin(px[v], fmax(px[e], px[f])), fmin(px[e], px[f]));
+  return px[e] + (py[v] - py[e]) * (px[f] - px[e]) / (py[f] - py[e]);
+}
+
+
+/*
+ * Find how many active edges are to the left of point `v`. Edges crossing the
+ * sweep line don't cross each other, so they stay in order.
+ */
+static int S2D_PolygonEdgesLeft(int v, int active_count) {
+  int low = 0, high = active_count;
+  while (low < high) {
+    int mid = (low + high) / 2;
+    if (S2D_PolygonEdgeX(active[mid], v) <= px[v]) low = mid + 1;
+    else high = mid;
+  }
+  return low;
+}
+
+
+/*
+ * Find the active edge closest to the left of a point
+ */
+static int S2D_PolygonLeftEdge(int v, int active_count) {
+  int left = S2D_PolygonEdgesLeft(v, active_count);
+  return left > 0 ? active[left - 1] : -1;
+}
+
+
+/*
+ * Add the edge starting at point `v` to those crossing the sweep line
+ */
+static void S2D_PolygonActivate(int v, int *active_count) {
+  int i = S2D_PolygonEdgesLeft(v, *active_count);
+  memmove(&active[i + 1], &active[i], (*active_count - i) * sizeof(int));
+  active[i] = v;
+  (*active_count)++;
+  helper[v] = v;
+}
+
+
+/*
+ * Remove an edge from those crossing the sweep line
+ */
+static void S2D_PolygonDeactivate(int e, int *active_count) {
+  for (int i = 0; i < *active_count; i++) {
+    if (active[i] == e) {
+      memmove(&active[i], &active[i + 1], (*active_count - i - 1) * sizeof(int));
+      (*active_count)--;
+      return;
+    }
+  }
+}
+
+
+/*
+ * Find the diagonals splitting the working points into pieces which are
+ * monotone in y, sweeping from the top. Returns the number of diagonals.
+ */
+static int S2D_FindMonotonePieces(int count) {
+
+  for (int i = 0; i < count; i++) {
+    next[i] = (i + 1) % count;
+    prev[i] = (i + count - 1) % count;
+    sorted[i] = i;
+    helper[i] = i;
+
+    int a = prev[i], b = next[i];
+    bool convex = S2D_PolygonCross(a, i, b) > 0;
+    if (S2D_PolygonAbove(i, a) && S2D_PolygonAbove(i, b)) {
+      kinds[i] = convex ? S2D_SWEEP_START : S2D_SWEEP_SPLIT;
+    } else if (S2D_PolygonAbove(a, i) && S2D_PolygonAbove(b, i)) {
+      kinds[i] = convex ? S2D_SWEEP_END : S2D_SWEEP_MERGE;
+    } else {
+      kinds[i] = S2D_SWEEP_REGULAR;
+    }
+  }
+
+  S2D_SortPolygonPoints(count, stack);
+
+  int active_count = 0, diagonal_count = 0;
+
+  #define S2D_DIAGONAL(a, b) \
+    diagonals[diagonal_count * 2] = (a); \
+    diagonals[diagonal_count * 2 + 1] = (b); \
+    diagonal_count++;
+
+  for (int s = 0; s < count; s++) {
+    int v = sorted[s], e = prev[v], left;
+
+    switch (kinds[v]) {
+      case S2D_SWEEP_START:
+        S2D_PolygonActivate(v, &active_count);
+        break;
+
+      case S2D_SWEEP_END:
+        if (kinds[helper[e]] == S2D_SWEEP_MERGE) { S2D_DIAGONAL(v, helper[e]); }
+        S2D_PolygonDeactivate(e, &active_count);
+        break;
+
+      case S2D_SWEEP_SPLIT:
+        left = S2D_PolygonLeftEdge(v, active_count);
+        if (left >= 0) {
+          S2D_DIAGONAL(v, helper[left]);
+          helper[left] = v;
+        }
+        S2D_PolygonActivate(v, &active_count);
+        break;
+
+      case S2D_SWEEP_MERGE:
+        if (kinds[helper[e]] == S2D_SWEEP_MERGE) { S2D_DIAGONAL(v, helper[e]); }
+        S2D_PolygonDeactivate(e, &active_count);
+        left = S2D_PolygonLeftEdge(v, active_count);
+        if (left >= 0) {
+          if (kinds[helper[left]] == S2D_SWEEP_MERGE) { S2D_DIAGONAL(v, helper[left]); }
+          helper[left] = v;
+        }
+        break;
+
+      case S2D_SWEEP_REGULAR:
+        // Going down the left side, with the inside to the right
+        if (S2D_PolygonAbove(e, v)) {
+          if (kinds[helper[e]] == S2D_SWEEP_MERGE) { S2D_DIAGONAL(v, helper[e]); }
+          S2D_PolygonDeactivate(e, &active_count);
+          S2D_PolygonActivate(v, &active_count);
+        } else {
+          left = S2D_PolygonLeftEdge(v, active_count);
+          if (left >= 0) {
+            if (kinds[helper[left]] == S2D_SWEEP_MERGE) { S2D_DIAGONAL(v, helper[left]); }
+            helper[left] = v;
+          }
+        }
+        break;
+    }
+
+    // More diagonals than a simple polygon can have
+    if (diagonal_count > count - 3) return count - 3;
+  }
+
+  #undef S2D_DIAGONAL
+  return diagonal_count;
+}
+
+
+/*
+ * Triangulate a piece of the polygon monotone in y, from its points wound
+ * counterclockwise, by walking down both sides at once
+ */
+static void S2D_TriangulateMonotone(int *points, int count, int **out) {
+  if (count < 3) return;
+  if (count == 3) {
+    S2D_PolygonTriangle(out, points[0], points[1], points[2]);
+    return;
+  }
+
+  int top = 0, bottom = 0;
+  for (int i = 1; i < count; i++) {
+    if (S2D_PolygonAbove(points[i], points[top])) top = i;
+    if (S2D_PolygonAbove(points[bottom], points[i])) bottom = i;
+  }
+
+  // Merge the left side, following the winding from the top, with the right,
+  // against it, marking which side each point is on
+  int l = (top + 1) % count, r = (top + count - 1) % count, m = 0;
+  chain[m] = points[top]; chain_side[m++] = 0;
+  while ((l != bottom || r != bottom) && m < count - 1) {
+    if (r == bottom || (l != bottom && S2D_PolygonAbove(points[l], points[r]))) {
+      chain[m] = points[l]; chain_side[m++] = -1;
+      l = (l + 1) % count;
+    } else {
+      chain[m] = points[r]; chain_side[m++] = 1;
+      r = (r + count - 1) % count;
+    }
+  }
+  chain[m] = points[bottom]; chain_side[m++] = 0;
+
+  // Points are kept on a stack until they can be joined to a point below
+  int size = 0;
+  stack[size] = chain[0]; stack_side[size++] = chain_side[0];
+  stack[size] = chain[1]; stack_side[size++] = chain_side[1];
+
+  for (int j = 2; j < m - 1; j++) {
+    int u = chain[j];
+
+    if (chain_side[j] != stack_side[size - 1]) {
+      // Across from the points on the stack, so it can be joined to them all
+      for (int i = 0; i < size - 1; i++) S2D_PolygonTriangle(out, u, stack[i], stack[i + 1]);
+      stack[0] = chain[j - 1]; stack_side[0] = chain_side[j - 1];
+      size = 1;
+    } else {
+      // On the same side, joined to those it can see past the last
+      int last = stack[--size];
+      while (size > 0) {
+        int t = stack[size - 1];
+        double turn = chain_side[j] < 0 ? S2D_PolygonCross(t, last, u) : S2D_PolygonCross(u, last, t);
+        if (turn <= 0) break;
+        S2D_PolygonTriangle(out, u, t, last);
+        last = t;
+        size--;
+      }
+      stack[size] = last; stack_side[size++] = chain_side[j];
+    }
+
+    stack[size] = u; stack_side[size++] = chain_side[j];
+  }
+
+  // Join the bottom to everything left
+  for (int i = 0; i < size - 1; i++) S2D_PolygonTriangle(out, chain[m - 1], stack[i], stack[i + 1]);
+}
+
+
+/*
+ * Get the direction from working point `w` to `p`, as a number from 0 to 4
+ * growing with the angle, counterclockwise from the right
+ */
+static double S2D_PolygonAngle(int p, int w) {
+  double dx = px[p] - px[w], dy = py[p] - py[w];
+  double a = dy / (fabs(dx) + fabs(dy));
+  if (dx < 0) return 2 - a;
+  return dy < 0 ? 4 + a : a;
+}
+
+
+/*
+ * Split the working points into monotone pieces along diagonals, and
+ * triangulate each piece
+ */
+static void S2D_TriangulateMonotonePieces(int count, int diagonal_count, int **out) {
+
+  // Outgoing edges of each point: along the boundary, then the diagonals
+  for (int i = 0; i <= count; i++) slots[i] = 0;
+  for (int i = 0; i < count; i++) slots[i + 1]++;
+  for (int d = 0; d < diagonal_count * 2; d++) slots[diagonals[d] + 1]++;
+  for (int i = 0; i < count; i++) slots[i + 1] += slots[i];
+
+  int *fill = sorted;  // done with sweep order
+  for (int i = 0; i < count; i++) {
+    fill[i] = slots[i];
+    ends[fill[i]++] = next[i];
+  }
+  for (int d = 0; d < diagonal_count; d++) {
+    int a = diagonals[d * 2], b = diagonals[d * 2 + 1];
+    ends[fill[a]++] = b;
+    ends[fill[b]++] = a;
+  }
+
+  int edges = slots[count];
+  for (int e = 0; e < edges; e++) visited[e] = false;
+
+  // Walk around each piece, keeping it on the left by taking the first edge
+  // clockwise from the one arrived on
+  for (int i = 0; i < count; i++) {
+    for (int e = slots[i]; e < slots[i + 1]; e++) {
+      if (visited[e]) continue;
+
+      int n = 0, from = i, edge = e;
+      while (!visited[edge] && n < count) {
+        visited[edge] = true;
+        piece[n++] = from;
+
+        // Most points have only the edge along the boundary
+        int w = ends[edge], best = slots[w];
+        if (slots[w + 1] - slots[w] > 1) {
+          double back = S2D_PolygonAngle(from, w), best_turn = 5;
+          for (int f = slots[w]; f < slots[w + 1]; f++) {
+            if (ends[f] == from) continue;
+            double turn = back - S2D_PolygonAngle(ends[f], w);
+            if (turn <= 0) turn += 4;
+            if (turn < best_turn) {
+              best = f;
+              best_turn = turn;
+            }
+          }
+        }
+
+        from = w;
+        edge = best;
+      }
+
+      S2D_TriangulateMonotone(piece, n, out);
+    }
+  }
+}
+
+
+/*
+ * Triangulate a simple polygon
+ */
+int S2D_TessellatePolygon(const S2D_Vec2f *points, int count, int *indices) {
+  if (!points || !indices || count < 3) return 0;
+  if (!S2D_ReservePolygon(count)) return 0;
+
+  // Flip y, so the sweep goes down the window from the top, and wind the
+  // points counterclockwise
+  double area = 0;
+  for (int i = 0, j = count - 1; i < count; j = i++) {
+    area += (double)points[j].x * -points[i].y - (double)points[i].x * -points[j].y;
+  }
+  for (int i = 0; i < count; i++) {
+    order[i] = area >= 0 ? i : count - 1 - i;
+    px[i] = points[order[i]].x;
+    py[i] = -points[order[i]].y;
+  }
+
+  int *out = indices;
+  tess_end = indices + (count - 2) * 3;
+  if (count <= S2D_EAR_CLIPPING_MAX) {
+    S2D_ClipEars(count, &out);
+  } else {
+    S2D_TriangulateMonotonePieces(count, S2D_FindMonotonePieces(count), &out);
+  }
+
+  return (int)(out - indices) / 3;
+}
+
+
+/*
+ * Make vertices of the triangles of a polygon, from its indices
+ */
+static void S2D_PolygonVertices(const S2D_Vec2f *points, const int *indices, int count,
+                                S2D_Color color, S2D_Vertex *vertices) {
+  for (int i = 0; i < count; i++) {
+    S2D_Vec2f p = points[indices[i]];
+    vertices[i] = (S2D_Vertex){ p.x, p.y, color };
+  }
+}
+
+
+/*
+ * Draw a filled polygon, tessellated for this draw only
+ */
+void S2D_DrawPolygon(const S2D_Vec2f *points, int count, S2D_Color color) {
+  if (!points || count < 3) return;
+
+  if (count > draw_capacity) {
+    int capacity = draw_capacity ? draw_capacity : 64;
+    while (capacity < count) capacity *= 2;
+    free(draw_indices);
+    free(draw_vertices);
+    draw_indices = (int *) malloc((capacity - 2) * 3 * sizeof(int));
+    draw_vertices = (S2D_Vertex *) malloc((capacity - 2) * 3 * sizeof(S2D_Vertex));
+    if (!draw_indices || !draw_vertices) {
+      S2D_Error("S2D_DrawPolygon", "Out of memory!");
+      draw_capacity = 0;
+      return;
+    }
+    draw_capacity = capacity;
+  }
+
+  int triangles = S2D_TessellatePolygon(points, count, draw_indices);
+  S2D_PolygonVertices(points, draw_indices, triangles * 3, color, draw_vertices);
+  S2D_GL_DrawTriangles(draw_vertices, triangles * 3);
+}
+
+
+/*
+ * Create a polygon
+ */
+S2D_Polygon *S2D_CreatePolygon(const S2D_Vec2f *points, int count, S2D_Color color) {
+  S2D_Init();
+
+  S2D_Polygon *polygon = (S2D_Polygon *) calloc(1, sizeof(S2D_Polygon));
+  if (!polygon) {
+    S2D_Error("S2D_CreatePolygon", "Out of memory!");
+    return NULL;
+  }
+
+  polygon->color = color;
+  S2D_SetPolygonPoints(polygon, points, count);
+  return polygon;
+}
+
+
+/*
+ * Replace the points of a polygon
+ */
+void S2D_SetPolygonPoints(S2D_Polygon *polygon, const S2D_Vec2f *points, int count) {
+  if (!polygon) return;
+  if (!points || count < 0) count = 0;
+
+  if (count > polygon->capacity) {
+    S2D_Vec2f *p = (S2D_Vec2f *) realloc(polygon->points, count * sizeof(S2D_Vec2f));
+    if (!p) {
+      S2D_Error("S2D_SetPolygonPoints", "Out of memory!");
+      return;
+    }
+    polygon->points = p;
+    polygon->capacity = count;
+  }
+
+  if (count) memcpy(polygon->points, points, count * sizeof(S2D_Vec2f));
+  polygon->count = count;
+  polygon->version++;
+}
+
+
+/*
+ * Tessellate a polygon if its points changed since it last was, and make its
+ * vertices if they or its color changed
+ */
+static bool S2D_UpdatePolygon(S2D_Polygon *polygon) {
+
+  bool tessellate = polygon->tessellated_version != polygon->version;
+  S2D_Color c = polygon->color, tc = polygon->tessellated_color;
+  if (!tessellate && polygon->vertex_count > 0 &&
+      c.r == tc.r && c.g == tc.g && c.b == tc.b && c.a == tc.a) return true;
+
+  int count = (polygon->count - 2) * 3;
+  if (count > polygon->vertex_capacity) {
+    int *indices = (int *) realloc(polygon->indices, count * sizeof(int));
+    if (indices) polygon->indices = indices;
+    S2D_Vertex *vertices = (S2D_Vertex *) realloc(polygon->vertices, count * sizeof(S2D_Vertex));
+    if (vertices) polygon->vertices = vertices;
+    if (!indices || !vertices) {
+      S2D_Error("S2D_DrawCachedPolygon", "Out of memory!");
+      return false;
+    }
+    polygon->vertex_capacity = count;
+    tessellate = true;
+  }
+
+  if (tessellate) {
+    polygon->vertex_count = S2D_TessellatePolygon(polygon->points, polygon->count, polygon->indices) * 3;
+    polygon->tessellated_version = polygon->version;
+  }
+
+  S2D_PolygonVertices(polygon->points, polygon->indices, polygon->vertex_count,
+                      polygon->color, polygon->vertices);
+  polygon->tessellated_color = polygon->color;
+  return true;
+}
+
+
+/*
+ * Draw a polygon, tessellating it first if its points changed
+ */
+void S2D_DrawCachedPolygon(S2D_Polygon *polygon) {
+  if (!polygon || polygon->count < 3) return;
+  if (!S2D_UpdatePolygon(polygon)) return;
+  S2D_GL_DrawTriangles(polygon->vertices, polygon->vertex_count);
+}
+
+
+/*
+ * Free a polygon
+ */
+void S2D_FreePolygon(S2D_Polygon *polygon) {
+  if (!polygon) return;
+  free(polygon->points);
+  free(polygon->indices);
+  free(polygon->vertices);
+  free(polygon);
+}
@@ -0,0 +1,322 @@
+// polyline.c
+
+#include "../include/simple2d.h"
+
+
+/*
+ * Create a polyline with no points, mitered with butt caps
+ */
+S2D_Polyline *S2D_CreatePolyline(GLfloat width, S2D_Color color) {
+  S2D_Init();
+
+  S2D_Polyline *line = (S2D_Polyline *) calloc(1, sizeof(S2D_Polyline));
+  if (!line) {
+    S2D_Error("S2D_CreatePolyline", "Out of memory!");
+    return NULL;
+  }
+
+  line->width = width;
+  line->color = color;
+  line->join = S2D_JOIN_MITER;
+  line->cap = S2D_CAP_BUTT;
+  line->miter_limit = 4;
+  line->version = 1;
+  return line;
+}
+
+
+/*
+ * Add points to the end of a polyline, skipping those repeating the point
+ * before, which have no direction
+ */
+static bool S2D_AddPolylinePoints(S2D_Polyline *line, const S2D_Vec2f *points, int count) {
+
+  if (line->count + count > line->capacity) {
+    int capacity = line->capacity ? line->capacity * 2 : 64;
+    while (capacity < line->count + count) capacity *= 2;
+    S2D_Vec2f *p = (S2D_Vec2f *) realloc(line->points, capacity * sizeof(S2D_Vec2f));
+    if (!p) {
+      S2D_Error("S2D_AppendPolylinePoints", "Out of memory!");
+      return false;
+    }
+    line->points = p;
+    line->capacity = capacity;
+  }
+
+  for (int i = 0; i < count; i++) {
+    S2D_Vec2f *last = line->count ? &line->points[line->count - 1] : NULL;
+    if (last && last->x == points[i].x && last->y == points[i].y) continue;
+    line->points[line->count++] = points[i];
+  }
+  return true;
+}
+
+
+/*
+ * Replace the points of a polyline
+ */
+void S2D_SetPolylinePoints(S2D_Polyline *line, const S2D_Vec2f *points, int count) {
+  if (!line) return;
+  line->count = 0;
+  line->version++;
+  if (points && count > 0) S2D_AddPolylinePoints(line, points, count);
+}
+
+
+/*
+ * Add points to the end of a polyline, tessellating only what they change
+ * when it's drawn next
+ */
+void S2D_AppendPolylinePoints(S2D_Polyline *line, const S2D_Vec2f *points, int count) {
+  if (!line || !points || count <= 0) return;
+
+  // Tessellate from where the points start changing: the appended ones, unless
+  // others changed since the line was tessellated
+  if (line->version == line->tessellated_version) {
+    line->append_from = line->count;
+  } else if (line->version != line->appended_version) {
+    line->append_from = 0;
+  }
+
+  S2D_AddPolylinePoints(line, points, count);
+  line->version++;
+  line->appended_version = line->version;
+}
+
+
+/*
+ * Add a triangle to the tessellated polyline
+ */
+static bool S2D_PolylineTriangle(S2D_Polyline *line, S2D_Vec2f a, S2D_Vec2f b, S2D_Vec2f c) {
+
+  if (line->vertex_count + 3 > line->vertex_capacity) {
+    int capacity = line->vertex_capacity ? line->vertex_capacity * 2 : 192;
+    S2D_Vertex *v = (S2D_Vertex *) realloc(line->vertices, capacity * sizeof(S2D_Vertex));
+    if (!v) {
+      S2D_Error("S2D_DrawPolyline", "Out of memory!");
+      return false;
+    }
+    line->vertices = v;
+    line->vertex_capacity = capacity;
+  }
+
+  S2D_Vertex *v = &line->vertices[line->vertex_count];
+  v[0] = (S2D_Vertex){ a.x, a.y, line->color };
+  v[1] = (S2D_Vertex){ b.x, b.y, line->color };
+  v[2] = (S2D_Vertex){ c.x, c.y, line->color };
+  line->vertex_count += 3;
+  return true;
+}
+
+
+/*
+ * Add triangles fanning around `center`, from offset `from` turned by `angle`
+ * radians, in about as many steps as a circle of the line's width would have
+ */
+static bool S2D_PolylineFan(S2D_Polyline *line, S2D_Vec2f center, S2D_Vec2f from, GLfloat angle) {
+
+  GLfloat h = line->width / 2;
+  int sectors = h < 4 ? 8 : h > 480 ? 128 : 8 + (int)(h / 4);
+  int steps = (int)ceilf(fabsf(angle) / (2 * M_PI) * sectors);
+  if (steps < 1) steps = 1;
+
+  GLfloat step = angle / steps, ss = sinf(step), cs = cosf(step);
+  S2D_Vec2f a = from;
+  for (int i = 0; i < steps; i++) {
+    S2D_Vec2f b = { a.x * cs - a.y * ss, a.x * ss + a.y * cs };
+    if (!S2D_PolylineTriangle(line, center,
+          (S2D_Vec2f){ center.x + a.x, center.y + a.y },
+          (S2D_Vec2f){ center.x + b.x, center.y + b.y })) return false;
+    a = b;
+  }
+  return true;
+}
+
+
+/*
+ * Get the direction of a segment, from point `seg` to the next
+ */
+static S2D_Vec2f S2D_PolylineDirection(const S2D_Polyline *line, int seg) {
+  S2D_Vec2f p1 = line->points[seg], p2 = line->points[seg + 1];
+  GLfloat dx = p2.x - p1.x, dy = p2.y - p1.y;
+  GLfloat length = sqrtf(dx * dx + dy * dy);
+  return (S2D_Vec2f){ dx / length, dy / length };
+}
+
+
+/*
+ * Get the offset of the left side of a join at inner point `k`, along the
+ * miter, if the join is mitered
+ */
+static bool S2D_PolylineMiter(const S2D_Polyline *line, int k, S2D_Vec2f *offset) {
+  if (line->join != S2D_JOIN_MITER) return false;
+
+  S2D_Vec2f d1 = S2D_PolylineDirection(line, k - 1), d2 = S2D_PolylineDirection(line, k);
+  S2D_Vec2f m = { -(d1.y + d2.y), d1.x + d2.x };
+  GLfloat length = sqrtf(m.x * m.x + m.y * m.y);
+  if (length < 0.0001) return false;  // turning back on itself
+
+  // Longer the sharper the turn, up to the limit
+  GLfloat cos_half = length / 2;
+  if (1 / cos_half > line->miter_limit) return false;
+
+  GLfloat scale = line->width / 2 / cos_half / length;
+  *offset = (S2D_Vec2f){ m.x * scale, m.y * scale };
+  return true;
+}
+
+
+/*
+ * Get the offset of the left side of a segment where it meets point `k`,
+ * and extend a square cap at the ends of the line
+ */
+static S2D_Vec2f S2D_PolylineSide(const S2D_Polyline *line, int seg, int k, S2D_Vec2f *p) {
+  S2D_Vec2f d = S2D_PolylineDirection(line, seg);
+  GLfloat h = line->width / 2;
+  *p = line->points[k];
+
+  if (k == 0 || k == line->count - 1) {
+    if (line->cap == S2D_CAP_SQUARE) {
+      GLfloat s = k == 0 ? -h : h;
+      p->x += d.x * s;
+      p->y += d.y * s;
+    }
+  } else {
+    S2D_Vec2f miter;
+    if (S2D_PolylineMiter(line, k, &miter)) return miter;
+  }
+
+  return (S2D_Vec2f){ -d.y * h, d.x * h };
+}
+
+
+/*
+ * Add the triangles of a segment, from point `seg` to the next
+ */
+static bool S2D_PolylineSegment(S2D_Polyline *line, int seg) {
+  S2D_Vec2f p1, p2;
+  S2D_Vec2f o1 = S2D_PolylineSide(line, seg, seg, &p1);
+  S2D_Vec2f o2 = S2D_PolylineSide(line, seg, seg + 1, &p2);
+
+  S2D_Vec2f l1 = { p1.x + o1.x, p1.y + o1.y }, r1 = { p1.x - o1.x, p1.y - o1.y };
+  S2D_Vec2f l2 = { p2.x + o2.x, p2.y + o2.y }, r2 = { p2.x - o2.x, p2.y - o2.y };
+
+  return S2D_PolylineTriangle(line, l1, r1, r2) &&
+         S2D_PolylineTriangle(line, r2, l2, l1);
+}
+
+
+/*
+ * Add the triangles filling the outside of a bevelled or round join at inner
+ * point `k`, where segments not mitered leave a gap
+ */
+static bool S2D_PolylineJoin(S2D_Polyline *line, int k) {
+  S2D_Vec2f miter;
+  if (S2D_PolylineMiter(line, k, &miter)) return true;
+
+  S2D_Vec2f d1 = S2D_PolylineDirection(line, k - 1), d2 = S2D_PolylineDirection(line, k);
+  GLfloat cross = d1.x * d2.y - d1.y * d2.x;
+  GLfloat dot = d1.x * d2.x + d1.y * d2.y;
+
+  // The outside of the turn is the side the line turns away from
+  GLfloat h = cross > 0 ? -line->width / 2 : line->width / 2;
+  S2D_Vec2f o1 = { -d1.y * h, d1.x * h }, o2 = { -d2.y * h, d2.x * h };
+  S2D_Vec2f p = line->points[k];
+
+  if (line->join == S2D_JOIN_ROUND) {
+    return S2D_PolylineFan(line, p, o1, atan2f(cross, dot));
+  }
+  return S2D_PolylineTriangle(line, p,
+                              (S2D_Vec2f){ p.x + o1.x, p.y + o1.y },
+                              (S2D_Vec2f){ p.x + o2.x, p.y + o2.y });
+}
+
+
+/*
+ * Add a round cap at the start or end of the line
+ */
+static bool S2D_PolylineCap(S2D_Polyline *line, bool start) {
+  if (line->cap != S2D_CAP_ROUND) return true;
+
+  int seg = start ? 0 : line->count - 2;
+  S2D_Vec2f d = S2D_PolylineDirection(line, seg);
+  GLfloat h = start ? line->width / 2 : -line->width / 2;
+
+  // Half turn from one side, around the back of the start or the front of the end
+  return S2D_PolylineFan(line, line->points[start ? 0 : line->count - 1],
+                         (S2D_Vec2f){ -d.y * h, d.x * h }, M_PI);
+}
+
+
+/*
+ * Tessellate a polyline into triangles, if its points or style changed since
+ * it was last tessellated, only redoing the end of the line if points were
+ * appended
+ */
+static bool S2D_TessellatePolyline(S2D_Polyline *line) {
+
+  S2D_Color c = line->color, tc = line->tessellated_style.color;
+  bool same_style = line->width == line->tessellated_style.width &&
+                    line->join == line->tessellated_style.join &&
+                    line->cap == line->tessellated_style.cap &&
+                    line->miter_limit == line->tessellated_style.miter_limit &&
+                    c.r == tc.r && c.g == tc.g && c.b == tc.b && c.a == tc.a;
+
+  if (same_style && line->version == line->tessellated_version) return true;
+
+  // Appended points change the end of the line from the last segment before
+  int first = 0;
+  if (same_style && line->version == line->appended_version &&
+      line->append_from >= 2 && line->append_from == line->tessellated_count) {
+    first = line->append_from - 2;
+    line->vertex_count = line->stable_vertices;
+  } else {
+    line->vertex_count = 0;
+    if (!S2D_PolylineCap(line, true)) goto error;
+  }
+
+  int last = line->count - 2;
+  for (int seg = first; seg <= last; seg++) {
+    if (seg == last) line->stable_vertices = line->vertex_count;
+    if (!S2D_PolylineSegment(line, seg)) goto error;
+    if (seg < last && !S2D_PolylineJoin(line, seg + 1)) goto error;
+  }
+  if (!S2D_PolylineCap(line, false)) goto error;
+
+  line->tessellated_version = line->version;
+  line->tessellated_count = line->count;
+  line->tessellated_style.width = line->width;
+  line->tessellated_style.join = line->join;
+  line->tessellated_style.cap = line->cap;
+  line->tessellated_style.miter_limit = line->miter_limit;
+  line->tessellated_style.color = line->color;
+  return true;
+
+error:
+  // Start over next time
+  line->vertex_count = 0;
+  line->tessellated_count = 0;
+  line->tessellated_version = line->version - 1;
+  return false;
+}
+
+
+/*
+ * Draw a polyline, tessellating it first if it changed
+ */
+void S2D_DrawPolyline(S2D_Polyline *line) {
+  if (!line || line->count < 2 || line->width <= 0) return;
+  if (!S2D_TessellatePolyline(line)) return;
+  S2D_GL_DrawTriangles(line->vertices, line->vertex_count);
+}
+
+
+/*
+ * Free a polyline
+ */
+void S2D_FreePolyline(S2D_Polyline *line) {
+  if (!line) return;
+  free(line->points);
+  free(line->vertices);
+  free(line);
+}
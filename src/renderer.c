@@ -0,0 +1,216 @@
+// renderer.c
+
+#include "../include/simple2d.h"
+
+// Thread frames are drawn on, which the OpenGL context is current on
+static SDL_Thread *render_thread = NULL;
+static SDL_threadID render_thread_id = 0;
+static S2D_Window *render_window = NULL;
+
+static SDL_mutex *render_lock = NULL;  // guards everything below
+static SDL_cond *work_cond = NULL;  // signalled when there's a frame or call
+static SDL_cond *done_cond = NULL;  // signalled when one is finished
+static bool frame_ready = false;  // a frame is handed over, until it's drawn
+static bool render_quit = false;
+
+// Call from another thread to run between frames
+static S2D_RenderCall invoke_fn = NULL;
+static void *invoke_args = NULL;
+static Uint32 invokes_started = 0;
+static Uint32 invokes_done = 0;
+
+
+/*
+ * Draw frames and run calls handed to the render thread until told to quit
+ */
+static int S2D_RenderThread(void *unused) {
+  S2D_Window *window = render_window;
+
+  if (SDL_GL_MakeCurrent(window->sdl, window->glcontext) != 0) {
+    S2D_Error("SDL_GL_MakeCurrent", SDL_GetError());
+  }
+
+  SDL_LockMutex(render_lock);
+
+  for (;;) {
+    while (!frame_ready && !invoke_fn && !render_quit) {
+      SDL_CondWait(work_cond, render_lock);
+    }
+
+    // Draw a frame handed over before running calls, which were made after it
+    // and may change or free what it draws with
+    if (frame_ready) {
+      SDL_UnlockMutex(render_lock);
+      S2D_PresentFrame(window);
+      SDL_LockMutex(render_lock);
+      frame_ready = false;
+      SDL_CondBroadcast(done_cond);
+
+    } else if (invoke_fn) {
+      S2D_RenderCall fn = invoke_fn;
+      SDL_UnlockMutex(render_lock);
+      fn(invoke_args);
+      SDL_LockMutex(render_lock);
+      invoke_fn = NULL;
+      invokes_done++;
+      SDL_CondBroadcast(done_cond);
+
+    // Quit once the last frame is drawn
+    } else {
+      break;
+    }
+  }
+
+  SDL_UnlockMutex(render_lock);
+  SDL_GL_MakeCurrent(window->sdl, NULL);
+  return 0;
+}
+
+
+/*
+ * Start drawing frames of the window on a render thread
+ */
+int S2D_StartRenderThread(S2D_Window *window) {
+  if (render_thread) {
+    S2D_Error("S2D_StartRenderThread", "A render thread is already running");
+    return 1;
+  }
+
+  render_lock = SDL_CreateMutex();
+  work_cond = SDL_CreateCond();
+  done_cond = SDL_CreateCond();
+  if (!render_lock || !work_cond || !done_cond) {
+    S2D_Error("S2D_StartRenderThread", SDL_GetError());
+    S2D_StopRenderThread(window);
+    return 1;
+  }
+
+  render_window = window;
+  frame_ready = false;
+  render_quit = false;
+
+  // A context can only be current on one thread at a time
+  SDL_GL_MakeCurrent(window->sdl, NULL);
+
+  render_thread = SDL_CreateThread(S2D_RenderThread, "S2D_RenderThread", NULL);
+  if (!render_thread) {
+    S2D_Error("SDL_CreateThread", SDL_GetError());
+    S2D_StopRenderThread(window);
+    return 1;
+  }
+  render_thread_id = SDL_GetThreadID(render_thread);
+
+  // Keep the list draws are queued into apart from the one submitted from the
+  // start, since calls run between frames may submit
+  S2D_SwapDrawLists(true);
+
+  S2D_Log(S2D_INFO, "Drawing frames on a render thread");
+  return 0;
+}
+
+
+/*
+ * Draw the last frame and stop the render thread
+ */
+void S2D_StopRenderThread(S2D_Window *window) {
+  if (!render_lock) return;
+
+  if (render_thread) {
+    SDL_LockMutex(render_lock);
+    render_quit = true;
+    SDL_CondSignal(work_cond);
+    SDL_UnlockMutex(render_lock);
+
+    SDL_WaitThread(render_thread, NULL);
+    render_thread = NULL;
+    render_thread_id = 0;
+    S2D_SwapDrawLists(false);
+  }
+
+  SDL_GL_MakeCurrent(window->sdl, window->glcontext);
+
+  if (done_cond) SDL_DestroyCond(done_cond);
+  if (work_cond) SDL_DestroyCond(work_cond);
+  if (render_lock) SDL_DestroyMutex(render_lock);
+  done_cond = NULL;
+  work_cond = NULL;
+  render_lock = NULL;
+}
+
+
+/*
+ * Hand the frame made to the render thread, after waiting for the one before
+ */
+void S2D_SubmitFrame(S2D_Window *window) {
+  if (!render_thread) return;
+
+  SDL_LockMutex(render_lock);
+
+  // The draw list of the frame before is reused once it's drawn
+  while (frame_ready) SDL_CondWait(done_cond, render_lock);
+
+  S2D_GL_EndFrame(window);
+  S2D_SwapDrawLists(true);
+  frame_ready = true;
+  SDL_CondSignal(work_cond);
+
+  SDL_UnlockMutex(render_lock);
+}
+
+
+/*
+ * Check if the calling thread makes frames for a render thread
+ */
+bool S2D_RecordingFrame() {
+  return render_thread && SDL_ThreadID() != render_thread_id;
+}
+
+
+/*
+ * Check if the calling thread is the render thread
+ */
+bool S2D_OnRenderThread() {
+  return render_thread && SDL_ThreadID() == render_thread_id;
+}
+
+
+/*
+ * Queue a call to run on the render thread, in order with the frame's draws
+ */
+bool S2D_DeferRenderCall(S2D_RenderCall fn, const void *args, int size) {
+  if (!S2D_RecordingFrame()) return false;
+
+  if (size > (int)sizeof(((S2D_DrawCommand *)0)->call.args)) {
+    S2D_Error("S2D_DeferRenderCall", "Arguments of %i bytes don't fit", size);
+    return true;
+  }
+
+  S2D_DrawCommand *cmd = S2D_QueueDraw(S2D_DRAW_CALL, 0);
+  if (!cmd) return true;
+
+  cmd->call.fn = fn;
+  if (size > 0) memcpy(cmd->call.args, args, size);
+  return true;
+}
+
+
+/*
+ * Run a call on the render thread between frames and wait for it
+ */
+bool S2D_InvokeRenderCall(S2D_RenderCall fn, void *args) {
+  if (!S2D_RecordingFrame()) return false;
+
+  SDL_LockMutex(render_lock);
+
+  // One call at a time, from any thread
+  while (invoke_fn) SDL_CondWait(done_cond, render_lock);
+  invoke_fn = fn;
+  invoke_args = args;
+  Uint32 ticket = ++invokes_started;
+  SDL_CondSignal(work_cond);
+
+  while ((Sint32)(invokes_done - ticket) < 0) SDL_CondWait(done_cond, render_lock);
+
+  SDL_UnlockMutex(render_lock);
+  return true;
+}
@@ -0,0 +1,222 @@
+// replay.c
+
+#include "../include/simple2d.h"
+
+// Identifies replay files, followed by the format version
+static const char replay_magic[4] = { 'S', '2', 'D', 'R' };
+#define S2D_REPLAY_VERSION 1
+
+
+/*
+ * Write and read little-endian 32-bit values
+ */
+static void S2D_WriteU32(Uint8 **p, Uint32 v) {
+  (*p)[0] = v; (*p)[1] = v >> 8; (*p)[2] = v >> 16; (*p)[3] = v >> 24;
+  *p += 4;
+}
+
+static Uint32 S2D_ReadU32(const Uint8 **p) {
+  Uint32 v = (*p)[0] | ((*p)[1] << 8) | ((*p)[2] << 16) | ((Uint32)(*p)[3] << 24);
+  *p += 4;
+  return v;
+}
+
+
+/*
+ * Open the replay file of a window for recording or playback
+ */
+bool S2D_OpenReplay(S2D_Window *window) {
+
+  const char *path = window->replay_path ? window->replay_path : window->record_path;
+  if (!path) return false;
+
+  if (window->replay_path && window->record_path) {
+    S2D_Log(S2D_WARN, "Both recording and replaying input, only replaying `%s`", path);
+  }
+
+  S2D_Replay *replay = (S2D_Replay *) calloc(1, sizeof(S2D_Replay));
+  if (!replay) {
+    S2D_Error("S2D_OpenReplay", "Out of memory!");
+    return false;
+  }
+  replay->playing = window->replay_path != NULL;
+
+  replay->file = fopen(path, replay->playing ? "rb" : "wb");
+  if (!replay->file) {
+    S2D_Error("S2D_OpenReplay", "Could not open `%s`", path);
+    free(replay);
+    return false;
+  }
+
+  Uint8 header[8], *p = header;
+  memcpy(header, replay_magic, 4);
+  p += 4;
+
+  if (replay->playing) {
+    const Uint8 *r = header + 4;
+    if (fread(header, 1, 8, replay->file) != 8 || memcmp(header, replay_magic, 4) != 0 ||
+        S2D_ReadU32(&r) != S2D_REPLAY_VERSION) {
+      S2D_Error("S2D_OpenReplay", "`%s` is not a replay file", path);
+      fclose(replay->file);
+      free(replay);
+      return false;
+    }
+    S2D_Log(S2D_INFO, "Replaying input from `%s`", path);
+  } else {
+    S2D_WriteU32(&p, S2D_REPLAY_VERSION);
+    fwrite(header, 1, 8, replay->file);
+    S2D_Log(S2D_INFO, "Recording input to `%s`", path);
+  }
+
+  replay->start = SDL_GetPerformanceCounter();
+  window->replay = replay;
+  return true;
+}
+
+
+/*
+ * Add an input event to the frame being recorded
+ */
+void S2D_RecordInput(S2D_Window *window, int device, S2D_Event e) {
+  S2D_Replay *replay = window->replay;
+  if (!replay || replay->playing) return;
+
+  if (replay->event_count == replay->event_capacity) {
+    int capacity = replay->event_capacity ? replay->event_capacity * 2 : 32;
+    S2D_ReplayEvent *events = (S2D_ReplayEvent *) realloc(
+      replay->events, capacity * sizeof(S2D_ReplayEvent)
+    );
+    if (!events) {
+      S2D_Error("S2D_RecordInput", "Out of memory!");
+      return;
+    }
+    replay->events = events;
+    replay->event_capacity = capacity;
+  }
+
+  replay->events[replay->event_count].device = device;
+  replay->events[replay->event_count].event = e;
+  replay->event_count++;
+}
+
+
+/*
+ * Write the recorded frame: its number, delta time, mouse position, and events
+ */
+void S2D_WriteReplayFrame(S2D_Window *window, float dt) {
+  S2D_Replay *replay = window->replay;
+  if (!replay || replay->playing) return;
+
+  // Each event is 3 bytes of flags followed by 10 values
+  Uint8 frame[18 + S2D_REPLAY_EVENT_SIZE * 32];
+  Uint8 *p = frame;
+  union { float f; Uint32 u; } bits = { .f = dt };
+
+  S2D_WriteU32(&p, replay->frames);
+  S2D_WriteU32(&p, bits.u);
+  S2D_WriteU32(&p, window->mouse.x);
+  S2D_WriteU32(&p, window->mouse.y);
+  *p++ = replay->event_count & 0xFF;
+  *p++ = replay->event_count >> 8;
+
+  for (int i = 0; i < replay->event_count; i++) {
+    // Flush the buffer when it can't fit another event
+    if (p + S2D_REPLAY_EVENT_SIZE > frame + sizeof(frame)) {
+      fwrite(frame, 1, p - frame, replay->file);
+      p = frame;
+    }
+    S2D_Event *e = &replay->events[i].event;
+    *p++ = replay->events[i].device;
+    *p++ = e->type;
+    *p++ = e->dblclick;
+    S2D_WriteU32(&p, e->which);
+    S2D_WriteU32(&p, e->button);
+    S2D_WriteU32(&p, e->scancode);
+    S2D_WriteU32(&p, e->x);
+    S2D_WriteU32(&p, e->y);
+    S2D_WriteU32(&p, e->delta_x);
+    S2D_WriteU32(&p, e->delta_y);
+    S2D_WriteU32(&p, e->direction);
+    S2D_WriteU32(&p, e->axis);
+    S2D_WriteU32(&p, e->value);
+  }
+
+  fwrite(frame, 1, p - frame, replay->file);
+  replay->event_count = 0;
+  replay->frames++;
+}
+
+
+/*
+ * Read the next recorded frame and dispatch its events, closing the window at
+ * the end of the replay
+ */
+bool S2D_ReadReplayFrame(S2D_Window *window) {
+  S2D_Replay *replay = window->replay;
+  if (!replay || !replay->playing) return false;
+
+  Uint8 head[18];
+  const Uint8 *p = head;
+  if (fread(head, 1, sizeof(head), replay->file) != sizeof(head)) {
+    S2D_Close(window);
+    return false;
+  }
+
+  S2D_ReadU32(&p);  // frame number, for inspecting files
+  union { Uint32 u; float f; } bits = { .u = S2D_ReadU32(&p) };
+  replay->dt = bits.f;
+  window->mouse.x = (Sint32)S2D_ReadU32(&p);
+  window->mouse.y = (Sint32)S2D_ReadU32(&p);
+  int count = p[0] | (p[1] << 8);
+
+  for (int i = 0; i < count; i++) {
+    Uint8 data[S2D_REPLAY_EVENT_SIZE];
+    if (fread(data, 1, sizeof(data), replay->file) != sizeof(data)) {
+      S2D_Log(S2D_WARN, "Replay file ends in the middle of a frame");
+      S2D_Close(window);
+      return false;
+    }
+    p = data + 3;
+    S2D_Event e = {
+      .type = data[1], .dblclick = data[2]
+    };
+    e.which     = (Sint32)S2D_ReadU32(&p);
+    e.button    = (Sint32)S2D_ReadU32(&p);
+    e.scancode  = (Sint32)S2D_ReadU32(&p);
+    e.x         = (Sint32)S2D_ReadU32(&p);
+    e.y         = (Sint32)S2D_ReadU32(&p);
+    e.delta_x   = (Sint32)S2D_ReadU32(&p);
+    e.delta_y   = (Sint32)S2D_ReadU32(&p);
+    e.direction = (Sint32)S2D_ReadU32(&p);
+    e.axis      = (Sint32)S2D_ReadU32(&p);
+    e.value     = (Sint32)S2D_ReadU32(&p);
+    S2D_DispatchInput(window, data[0], e);
+  }
+
+  replay->frames++;
+  return true;
+}
+
+
+/*
+ * Close the replay file, logging the frame rate of a replay
+ */
+void S2D_CloseReplay(S2D_Window *window) {
+  S2D_Replay *replay = window->replay;
+  if (!replay) return;
+
+  double seconds = (SDL_GetPerformanceCounter() - replay->start) /
+                   (double)SDL_GetPerformanceFrequency();
+
+  if (replay->playing) {
+    S2D_Log(S2D_INFO, "Replayed %u frames in %.3fs (%.1f fps)",
+            replay->frames, seconds, seconds > 0 ? replay->frames / seconds : 0);
+  } else {
+    S2D_Log(S2D_INFO, "Recorded %u frames of input", replay->frames);
+  }
+
+  fclose(replay->file);
+  free(replay->events);
+  free(replay);
+  window->replay = NULL;
+}
@@ -2,6 +2,22 @@
 
 #include "../include/simple2d.h"
 
+// Rectangles and lines made into vertices at a time, for S2D_GL_DrawTriangles
+#define S2D_SHAPES_CHUNK 128
+
+// Points of the most sided shape with smoothed edges
+#define S2D_FEATHERED_MAX 4
+
+// Unit circles kept, by number of sectors
+#define S2D_UNIT_CIRCLES 32
+
+static struct {
+  int sectors;
+  GLfloat *points;
+} unit_circles[S2D_UNIT_CIRCLES];
+static int unit_circle_last = 0;  // most recently used
+static int unit_circle_next = 0;  // replaced next
+
 
 /*
  * Rotate a point around a given point
@@ -156,6 +172,81 @@ void S2D_DrawRect(S2D_FRect rect, S2D_Color color, bool filled) {
 };
 
 
+/*
+ * Draw triangles from an array of vertices
+ */
+void S2D_DrawTriangles(const S2D_Vertex *vertices, int count) {
+  if (!vertices || count < 3) return;
+  S2D_GL_DrawTriangles(vertices, count);
+}
+
+
+/*
+ * Draw an array of filled rectangles, two triangles each
+ */
+void S2D_DrawRects(const S2D_FRect *rects, const S2D_Color *colors, int count) {
+  if (!rects || !colors) return;
+
+  S2D_Vertex v[S2D_SHAPES_CHUNK * 6];
+
+  for (int first = 0; first < count; first += S2D_SHAPES_CHUNK) {
+    int n = count - first < S2D_SHAPES_CHUNK ? count - first : S2D_SHAPES_CHUNK;
+
+    for (int i = 0; i < n; i++) {
+      const S2D_FRect *r = &rects[first + i];
+      S2D_Color c = colors[first + i];
+      S2D_Vertex *q = &v[i * 6];
+      q[0] = (S2D_Vertex){ r->x,            r->y,             c };
+      q[1] = (S2D_Vertex){ r->x + r->width, r->y,             c };
+      q[2] = (S2D_Vertex){ r->x + r->width, r->y + r->height, c };
+      q[3] = q[2];
+      q[4] = (S2D_Vertex){ r->x,            r->y + r->height, c };
+      q[5] = q[0];
+    }
+
+    S2D_GL_DrawTriangles(v, n * 6);
+  }
+}
+
+
+/*
+ * Draw an array of lines, each from a quad
+ */
+void S2D_DrawLines(const S2D_Vec2f *points, const S2D_Color *colors, int count, GLfloat width) {
+  if (!points || !colors) return;
+
+  S2D_Vertex v[S2D_SHAPES_CHUNK * 6];
+
+  for (int first = 0; first < count; first += S2D_SHAPES_CHUNK) {
+    int n = count - first < S2D_SHAPES_CHUNK ? count - first : S2D_SHAPES_CHUNK;
+    int drawn = 0;
+
+    for (int i = 0; i < n; i++) {
+      S2D_Vec2f p1 = points[(first + i) * 2], p2 = points[(first + i) * 2 + 1];
+      GLfloat dx = p2.x - p1.x, dy = p2.y - p1.y;
+      GLfloat length = sqrtf(dx * dx + dy * dy);
+      if (length == 0) continue;
+
+      // Half the width, across the line
+      GLfloat x = dx / length * width / 2;
+      GLfloat y = dy / length * width / 2;
+
+      S2D_Color c = colors[first + i];
+      S2D_Vertex *q = &v[drawn * 6];
+      q[0] = (S2D_Vertex){ p1.x - y, p1.y + x, c };
+      q[1] = (S2D_Vertex){ p1.x + y, p1.y - x, c };
+      q[2] = (S2D_Vertex){ p2.x + y, p2.y - x, c };
+      q[3] = q[2];
+      q[4] = (S2D_Vertex){ p2.x - y, p2.y + x, c };
+      q[5] = q[0];
+      drawn++;
+    }
+
+    S2D_GL_DrawTriangles(v, drawn * 6);
+  }
+}
+
+
 /*
  * Draw a line from a quad
  */
@@ -166,9 +257,10 @@ void S2D_DrawLine(GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2,
                   GLfloat r3, GLfloat g3, GLfloat b3, GLfloat a3,
                   GLfloat r4, GLfloat g4, GLfloat b4, GLfloat a4) {
 
-  double length = sqrt(powf(x1 - x2, 2) + powf(y1 - y2, 2));
-  double x = ((x2 - x1) / length) * width / 2;
-  double y = ((y2 - y1) / length) * width / 2;
+  GLfloat dx = x2 - x1, dy = y2 - y1;
+  GLfloat length = sqrtf(dx * dx + dy * dy);
+  GLfloat x = dx / length * width / 2;
+  GLfloat y = dy / length * width / 2;
 
   S2D_DrawQuad(
     x1 - y, y1 + x, r1, g1, b1, a1,
@@ -179,24 +271,215 @@ void S2D_DrawLine(GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2,
 };
 
 
+/*
+ * Draw a convex polygon of up to four points, wound either way, with its edges
+ * fading out over about a pixel: solid inside them by half a pixel, fading to
+ * clear half a pixel outside
+ */
+static void S2D_DrawFeathered(const S2D_Vec2f *p, int count, S2D_Color color) {
+
+  GLfloat h = S2D_GL_GetPixelSize() / 2;
+  S2D_Color clear = { color.r, color.g, color.b, 0 };
+
+  // Which way the points wind, to know which side of each edge is outside
+  GLfloat area = 0;
+  for (int i = 0; i < count; i++) {
+    S2D_Vec2f a = p[i], b = p[(i + 1) % count];
+    area += a.x * b.y - b.x * a.y;
+  }
+  GLfloat side = area < 0 ? -1 : 1;
+
+  // Outward normals of the edges, from each point to the next
+  S2D_Vec2f n[S2D_FEATHERED_MAX];
+  for (int i = 0; i < count; i++) {
+    S2D_Vec2f a = p[i], b = p[(i + 1) % count];
+    GLfloat dx = b.x - a.x, dy = b.y - a.y;
+    GLfloat length = sqrtf(dx * dx + dy * dy);
+    n[i] = length > 0 ? (S2D_Vec2f){ side * dy / length, -side * dx / length }
+                      : (S2D_Vec2f){ 0, 0 };
+  }
+
+  // Move each point `h` from both edges it's on, in and out
+  S2D_Vec2f in[S2D_FEATHERED_MAX], out[S2D_FEATHERED_MAX];
+  for (int i = 0; i < count; i++) {
+    S2D_Vec2f n1 = n[(i + count - 1) % count], n2 = n[i];
+    GLfloat d = 1 + n1.x * n2.x + n1.y * n2.y;
+    GLfloat s = d > 0.25 ? h / d : h * 4;  // no further than a sharp corner's
+    S2D_Vec2f o = { (n1.x + n2.x) * s, (n1.y + n2.y) * s };
+    in[i]  = (S2D_Vec2f){ p[i].x - o.x, p[i].y - o.y };
+    out[i] = (S2D_Vec2f){ p[i].x + o.x, p[i].y + o.y };
+  }
+
+  S2D_Vertex v[(S2D_FEATHERED_MAX - 2) * 3 + S2D_FEATHERED_MAX * 6];
+  int k = 0;
+
+  for (int i = 2; i < count; i++) {
+    v[k++] = (S2D_Vertex){ in[0].x,     in[0].y,     color };
+    v[k++] = (S2D_Vertex){ in[i - 1].x, in[i - 1].y, color };
+    v[k++] = (S2D_Vertex){ in[i].x,     in[i].y,     color };
+  }
+
+  for (int i = 0; i < count; i++) {
+    int j = (i + 1) % count;
+    v[k++] = (S2D_Vertex){ in[i].x,  in[i].y,  color };
+    v[k++] = (S2D_Vertex){ out[i].x, out[i].y, clear };
+    v[k++] = (S2D_Vertex){ out[j].x, out[j].y, clear };
+    v[k++] = (S2D_Vertex){ out[j].x, out[j].y, clear };
+    v[k++] = (S2D_Vertex){ in[j].x,  in[j].y,  color };
+    v[k++] = (S2D_Vertex){ in[i].x,  in[i].y,  color };
+  }
+
+  S2D_GL_DrawTriangles(v, k);
+}
+
+
+/*
+ * Draw a line with its edges smoothed, from a quad and a fringe around it
+ */
+void S2D_DrawSmoothLine(GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2,
+                        GLfloat width, S2D_Color color) {
+
+  GLfloat dx = x2 - x1, dy = y2 - y1;
+  GLfloat length = sqrtf(dx * dx + dy * dy);
+  if (length == 0 || width <= 0) return;
+
+  // Lines thinner than a pixel are drawn a pixel wide and fainter instead
+  GLfloat pixel = S2D_GL_GetPixelSize();
+  if (width < pixel) {
+    color.a *= width / pixel;
+    width = pixel;
+  }
+
+  GLfloat x = dx / length * width / 2;
+  GLfloat y = dy / length * width / 2;
+
+  S2D_Vec2f p[4] = {
+    { x1 - y, y1 + x },
+    { x1 + y, y1 - x },
+    { x2 + y, y2 - x },
+    { x2 - y, y2 + x }
+  };
+  S2D_DrawFeathered(p, 4, color);
+}
+
+
+/*
+ * Draw a filled rectangle with its edges smoothed, from a quad and a fringe
+ * around it
+ */
+void S2D_DrawSmoothRect(S2D_FRect rect, S2D_Color color) {
+  if (rect.width <= 0 || rect.height <= 0) return;
+
+  // Sides shorter than a pixel are drawn a pixel long and fainter instead
+  GLfloat pixel = S2D_GL_GetPixelSize();
+  if (rect.width < pixel) {
+    color.a *= rect.width / pixel;
+    rect.x -= (pixel - rect.width) / 2;
+    rect.width = pixel;
+  }
+  if (rect.height < pixel) {
+    color.a *= rect.height / pixel;
+    rect.y -= (pixel - rect.height) / 2;
+    rect.height = pixel;
+  }
+
+  S2D_Vec2f p[4] = {
+    { rect.x,              rect.y },
+    { rect.x + rect.width, rect.y },
+    { rect.x + rect.width, rect.y + rect.height },
+    { rect.x,              rect.y + rect.height }
+  };
+  S2D_DrawFeathered(p, 4, color);
+}
+
+
+/*
+ * Get the points of a unit circle divided into a number of sectors
+ */
+const GLfloat *S2D_GetUnitCircle(int sectors) {
+  if (sectors < 1) return NULL;
+
+  // Start from the last one used, since the same size is often drawn in a row
+  for (int i = 0; i < S2D_UNIT_CIRCLES; i++) {
+    int c = (unit_circle_last + S2D_UNIT_CIRCLES - i) % S2D_UNIT_CIRCLES;
+    if (unit_circles[c].sectors == sectors) {
+      unit_circle_last = c;
+      return unit_circles[c].points;
+    }
+  }
+
+  GLfloat *points = (GLfloat *) malloc((sectors + 1) * 2 * sizeof(GLfloat));
+  if (!points) {
+    S2D_Error("S2D_GetUnitCircle", "Out of memory!");
+    return NULL;
+  }
+
+  double angle = 2 * M_PI / sectors;
+  for (int i = 0; i < sectors; i++) {
+    points[i * 2]     = cos(i * angle);
+    points[i * 2 + 1] = sin(i * angle);
+  }
+  points[sectors * 2]     = points[0];
+  points[sectors * 2 + 1] = points[1];
+
+  // Replace the least recently added
+  int c = unit_circle_next;
+  unit_circle_next = (unit_circle_next + 1) % S2D_UNIT_CIRCLES;
+  free(unit_circles[c].points);
+  unit_circles[c].sectors = sectors;
+  unit_circles[c].points = points;
+  unit_circle_last = c;
+  return points;
+}
+
+
 /*
  * Draw a circle from triangles
  */
 void S2D_DrawCircle(GLfloat x, GLfloat y, GLfloat radius, int sectors,
                     GLfloat r, GLfloat g, GLfloat b, GLfloat a) {
 
-  double angle = 2 * M_PI / sectors;
+  const GLfloat *unit = S2D_GetUnitCircle(sectors);
+  if (!unit) return;
 
   for (int i = 0; i < sectors; i++) {
 
-    GLfloat x1 = x + radius * cos(i * angle);
-    GLfloat y1 = y + radius * sin(i * angle);
+    GLfloat x1 = x + radius * unit[i * 2 + 2];
+    GLfloat y1 = y + radius * unit[i * 2 + 3];
 
-    GLfloat x2 = x + radius * cos((i - 1) * angle);
-    GLfloat y2 = y + radius * sin((i - 1) * angle);
+    GLfloat x2 = x + radius * unit[i * 2];
+    GLfloat y2 = y + radius * unit[i * 2 + 1];
 
     S2D_GL_DrawTriangle( x,  y, r, g, b, a,
                         x1, y1, r, g, b, a,
                         x2, y2, r, g, b, a);
   }
 }
+
+
+/*
+ * Draw a filled circle as a single quad
+ */
+void S2D_DrawDisc(GLfloat x, GLfloat y, GLfloat radius, S2D_Color color) {
+  S2D_GL_DrawShape(x, y, radius, 0, 0, 360, color);
+}
+
+
+/*
+ * Draw a ring as a single quad
+ */
+void S2D_DrawRing(GLfloat x, GLfloat y, GLfloat radius, GLfloat thickness, S2D_Color color) {
+  S2D_DrawArc(x, y, radius, thickness, 0, 360, color);
+}
+
+
+/*
+ * Draw an arc of a ring as a single quad
+ */
+void S2D_DrawArc(GLfloat x, GLfloat y, GLfloat radius, GLfloat thickness,
+                 GLfloat start, GLfloat end, S2D_Color color) {
+  if (radius <= 0 || end <= start) return;
+
+  GLfloat inner = thickness > 0 && thickness < radius ? radius - thickness : 0;
+  S2D_GL_DrawShape(x, y, radius, inner, start, end, color);
+}
@@ -119,11 +119,17 @@ bool S2D_Init() {
   S2D_Log(S2D_INFO, "Initializing Simple 2D");
 
   // Initialize SDL
-  if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+  if (SDL_Init(SDL_INIT_EVERYTHING & ~SDL_INIT_VIDEO) != 0) {
     S2D_Error("SDL_Init", SDL_GetError());
     return false;
   }
 
+  // Without a display, only headless windows can be shown, which initialize
+  // video themselves
+  if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+    S2D_Log(S2D_WARN, "Video not available (%s), only headless windows can be shown", SDL_GetError());
+  }
+
   // Initialize SDL_ttf
   if (TTF_Init() != 0) {
     S2D_Error("TTF_Init", TTF_GetError());
@@ -176,6 +182,7 @@ void S2D_GetDisplayDimensions(int *w, int *h) {
  * Quits Simple 2D subsystems
  */
 void S2D_Quit() {
+  S2D_QuitJobs();
   IMG_Quit();
   Mix_CloseAudio();
   Mix_Quit();
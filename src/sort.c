@@ -0,0 +1,196 @@
+// sort.c
+
+#include "../include/simple2d.h"
+
+// Queued draws, with their sort keys and the data they reference
+typedef struct {
+  S2D_DrawCommand *commands;
+  Uint64 *keys;
+  int count;
+  int capacity;
+  GLfloat *data;
+  int data_count;
+  int data_capacity;
+} S2D_DrawList;
+
+// The list draws are queued into, and the one submitted. They're the same
+// one, unless a render thread submits a frame while the next is queued.
+static S2D_DrawList lists[2];
+static S2D_DrawList *queued = &lists[0];
+static S2D_DrawList *submitted = &lists[0];
+
+// Set while submitting, since calls may flush what's drawn
+static bool submitting = false;
+
+// Scratch space for sorting, as key and index pairs
+static Uint64 *sort_keys = NULL;
+static int *sort_order = NULL;
+static Uint64 *tmp_keys = NULL;
+static int *tmp_order = NULL;
+static int sort_capacity = 0;
+
+// Layer and depth of draws being queued
+static Uint64 draw_layer = 0;
+static Uint64 draw_depth = 0;
+
+
+/*
+ * Set the layer and depth of later draws
+ */
+void S2D_SetDrawLayer(int layer, int depth) {
+  draw_layer = layer < 0 ? 0 : layer > 255 ? 255 : layer;
+  draw_depth = depth < 0 ? 0 : depth > 65535 ? 65535 : depth;
+}
+
+
+/*
+ * Add a draw to be sorted, returning it to be filled in
+ */
+S2D_DrawCommand *S2D_QueueDraw(int type, GLuint texture_id) {
+  S2D_DrawList *list = queued;
+
+  if (list->count == list->capacity) {
+    int c = list->capacity ? list->capacity * 2 : 1024;
+    S2D_DrawCommand *cmds = (S2D_DrawCommand *) realloc(list->commands, c * sizeof(S2D_DrawCommand));
+    if (cmds) list->commands = cmds;
+    Uint64 *k = (Uint64 *) realloc(list->keys, c * sizeof(Uint64));
+    if (k) list->keys = k;
+    if (!cmds || !k) {
+      S2D_Error("S2D_QueueDraw", "Out of memory!");
+      return NULL;
+    }
+    list->capacity = c;
+  }
+
+  // Layer, depth, and shader, then texture so equal textures end up adjacent
+  list->keys[list->count] = draw_layer << 56 | draw_depth << 40 | (Uint64)type << 32 | texture_id;
+
+  S2D_DrawCommand *cmd = &list->commands[list->count++];
+  cmd->type = type;
+  cmd->texture_id = texture_id;
+  return cmd;
+}
+
+
+/*
+ * Add data to the queued draws, returning its offset
+ */
+int S2D_QueueDrawData(const GLfloat *values, int n) {
+  S2D_DrawList *list = queued;
+
+  if (list->data_count + n > list->data_capacity) {
+    int c = list->data_capacity ? list->data_capacity * 2 : 4096;
+    while (c < list->data_count + n) c *= 2;
+    GLfloat *d = (GLfloat *) realloc(list->data, c * sizeof(GLfloat));
+    if (!d) {
+      S2D_Error("S2D_QueueDrawData", "Out of memory!");
+      return -1;
+    }
+    list->data = d;
+    list->data_capacity = c;
+  }
+
+  int first = list->data_count;
+  memcpy(list->data + first, values, n * sizeof(GLfloat));
+  list->data_count += n;
+  return first;
+}
+
+
+/*
+ * Sort `count` draws of a list by key, a byte at a time from the lowest,
+ * leaving their indices in `sort_order`. Each pass is stable, so draws with
+ * equal keys keep their order. Bytes which are the same in every key are
+ * skipped.
+ */
+static bool S2D_RadixSortDraws(const Uint64 *keys, int first, int count) {
+
+  if (count > sort_capacity) {
+    Uint64 *k = (Uint64 *) realloc(sort_keys, count * sizeof(Uint64));
+    if (k) sort_keys = k;
+    int *o = (int *) realloc(sort_order, count * sizeof(int));
+    if (o) sort_order = o;
+    Uint64 *tk = (Uint64 *) realloc(tmp_keys, count * sizeof(Uint64));
+    if (tk) tmp_keys = tk;
+    int *to = (int *) realloc(tmp_order, count * sizeof(int));
+    if (to) tmp_order = to;
+    if (!k || !o || !tk || !to) {
+      S2D_Error("S2D_SubmitDraws", "Out of memory!");
+      return false;
+    }
+    sort_capacity = count;
+  }
+
+  memcpy(sort_keys, keys + first, count * sizeof(Uint64));
+  for (int i = 0; i < count; i++) sort_order[i] = first + i;
+
+  for (int shift = 0; shift < 64; shift += 8) {
+    int offsets[256] = { 0 };
+    for (int i = 0; i < count; i++) offsets[(sort_keys[i] >> shift) & 0xFF]++;
+    if (offsets[(sort_keys[0] >> shift) & 0xFF] == count) continue;
+
+    int sum = 0;
+    for (int b = 0; b < 256; b++) {
+      int n = offsets[b];
+      offsets[b] = sum;
+      sum += n;
+    }
+
+    for (int i = 0; i < count; i++) {
+      int dst = offsets[(sort_keys[i] >> shift) & 0xFF]++;
+      tmp_keys[dst] = sort_keys[i];
+      tmp_order[dst] = sort_order[i];
+    }
+
+    Uint64 *swap_keys = sort_keys; sort_keys = tmp_keys; tmp_keys = swap_keys;
+    int *swap_order = sort_order; sort_order = tmp_order; tmp_order = swap_order;
+  }
+
+  return true;
+}
+
+
+/*
+ * Submit the queued draws, sorted if `sort` is true, then clear the queue
+ */
+void S2D_SubmitDraws(S2D_SubmitDraw submit, bool sort) {
+  S2D_DrawList *list = submitted;
+  if (submitting || list->count == 0) return;
+  submitting = true;
+
+  int first = 0;
+  while (first < list->count) {
+
+    // Draws are sorted up to the next call, which must run where it was queued
+    int end = first;
+    while (end < list->count && list->commands[end].type != S2D_DRAW_CALL) end++;
+
+    int n = end - first;
+    if (sort && n > 1 && S2D_RadixSortDraws(list->keys, first, n)) {
+      for (int i = 0; i < n; i++) submit(&list->commands[sort_order[i]], list->data);
+    } else {
+      // Draw in the order queued rather than not at all
+      for (int i = first; i < end; i++) submit(&list->commands[i], list->data);
+    }
+
+    if (end < list->count) submit(&list->commands[end], list->data);
+    first = end + 1;
+  }
+
+  list->count = 0;
+  list->data_count = 0;
+  submitting = false;
+}
+
+
+/*
+ * Queue later draws into the other draw list, or the one submitted
+ */
+void S2D_SwapDrawLists(bool double_buffered) {
+  if (double_buffered) {
+    submitted = queued;
+    queued = queued == &lists[0] ? &lists[1] : &lists[0];
+  } else {
+    submitted = queued;
+  }
+}
@@ -121,22 +121,42 @@ void S2D_RotateSprite(S2D_Sprite *spr, GLfloat angle, int position) {
 
 
 /*
- * Draw a sprite
+ * Create the texture of a sprite's image, the first time it's drawn
  */
-void S2D_DrawSprite(S2D_Sprite *spr) {
-  if (!spr) return;
-
+static void S2D_CreateSpriteTexture(S2D_Sprite *spr) {
   if (spr->img->texture_id == 0) {
     S2D_GL_CreateTexture(&spr->img->texture_id, spr->img->format,
                          spr->img->width, spr->img->height,
                          spr->img->surface->pixels, GL_NEAREST);
     SDL_FreeSurface(spr->img->surface);
   }
+}
 
+
+/*
+ * Draw a sprite
+ */
+void S2D_DrawSprite(S2D_Sprite *spr) {
+  if (!spr) return;
+  S2D_CreateSpriteTexture(spr);
   S2D_GL_DrawSprite(spr);
 }
 
 
+/*
+ * Draw many sprites at once
+ */
+void S2D_DrawSprites(S2D_Sprite **sprites, int count) {
+  if (!sprites || count <= 0) return;
+
+  for (int i = 0; i < count; i++) {
+    if (sprites[i]) S2D_CreateSpriteTexture(sprites[i]);
+  }
+
+  S2D_GL_DrawSprites(sprites, count);
+}
+
+
 /*
  * Free a sprite
  */
@@ -0,0 +1,135 @@
+// stats.c
+
+#include "../include/simple2d.h"
+
+
+/*
+ * Record the times of a frame
+ */
+void S2D_RecordFrame(S2D_Window *window, const Uint64 t[S2D_STAGE_COUNT]) {
+  S2D_FrameRing *ring = window->frame_ring;
+  if (!ring) return;
+
+  double to_ms = 1000.0 / SDL_GetPerformanceFrequency();
+  int count = SDL_AtomicGet(&ring->count);
+  float *ms = ring->ms[count % S2D_FRAME_HISTORY];
+
+  for (int i = 0; i < S2D_STAGE_FRAME; i++) {
+    ms[i] = (float)((t[i + 1] - t[i]) * to_ms);
+  }
+
+  // The first frame has nothing to measure from, so use its own time
+  Uint64 start = ring->last_start ? ring->last_start : t[0];
+  ms[S2D_STAGE_FRAME] = (float)((ring->last_start ? t[0] - start : t[S2D_STAGE_FRAME] - start) * to_ms);
+  ring->last_start = t[0];
+
+  // Publish the frame after its times are written
+  SDL_AtomicAdd(&ring->count, 1);
+}
+
+
+/*
+ * Copy the times of a stage for up to the last `frames` frames, returning the
+ * number copied. Frames overwritten while copying are left out.
+ */
+static int S2D_CopyFrameTimes(S2D_FrameRing *ring, int stage, int frames, float *out) {
+  int count = SDL_AtomicGet(&ring->count);
+  int available = count < S2D_FRAME_HISTORY ? count : S2D_FRAME_HISTORY;
+  if (frames <= 0 || frames > available) frames = available;
+
+  int first = count - frames;
+  for (int i = 0; i < frames; i++) {
+    out[i] = ring->ms[(first + i) % S2D_FRAME_HISTORY][stage];
+  }
+
+  // The writer may have lapped the oldest frames, so drop them
+  int oldest = SDL_AtomicGet(&ring->count) - S2D_FRAME_HISTORY + 1;
+  if (oldest > first) {
+    int lapped = oldest - first;
+    if (lapped >= frames) return 0;
+    memmove(out, out + lapped, (frames - lapped) * sizeof(float));
+    frames -= lapped;
+  }
+
+  return frames;
+}
+
+
+/*
+ * Compare frame times for sorting
+ */
+static int S2D_CompareFrameTimes(const void *a, const void *b) {
+  float x = *(const float *)a, y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+
+/*
+ * Get stats of a frame stage over recent frames
+ */
+int S2D_GetFrameStats(S2D_Window *window, int stage, int frames, S2D_FrameStats *stats) {
+  if (!window || !stats) return 0;
+  memset(stats, 0, sizeof(S2D_FrameStats));
+
+  if (stage < 0 || stage >= S2D_STAGE_COUNT) {
+    S2D_Error("S2D_GetFrameStats", "Invalid frame stage %i", stage);
+    return 0;
+  }
+  if (!window->frame_ring) return 0;
+
+  float *times = (float *) malloc(S2D_FRAME_HISTORY * sizeof(float));
+  if (!times) {
+    S2D_Error("S2D_GetFrameStats", "Out of memory!");
+    return 0;
+  }
+
+  int n = S2D_CopyFrameTimes(window->frame_ring, stage, frames, times);
+  if (n == 0) {
+    free(times);
+    return 0;
+  }
+
+  double sum = 0;
+  for (int i = 0; i < n; i++) sum += times[i];
+
+  // Percentiles by nearest rank
+  qsort(times, n, sizeof(float), S2D_CompareFrameTimes);
+  stats->frames = n;
+  stats->mean = sum / n;
+  stats->p50 = times[(int)ceil(0.50 * n) - 1];
+  stats->p95 = times[(int)ceil(0.95 * n) - 1];
+  stats->p99 = times[(int)ceil(0.99 * n) - 1];
+  stats->max = times[n - 1];
+
+  free(times);
+  return n;
+}
+
+
+/*
+ * Write the times of recent frames to a CSV file
+ */
+int S2D_DumpFrameStats(S2D_Window *window, const char *path) {
+  if (!window || !window->frame_ring) return 1;
+  S2D_FrameRing *ring = window->frame_ring;
+
+  FILE *f = fopen(path, "w");
+  if (!f) {
+    S2D_Error("S2D_DumpFrameStats", "Could not open `%s`", path);
+    return 1;
+  }
+
+  int count = SDL_AtomicGet(&ring->count);
+  int first = count > S2D_FRAME_HISTORY ? count - S2D_FRAME_HISTORY : 0;
+
+  fprintf(f, "frame,update_ms,render_ms,flush_ms,swap_ms,frame_ms\n");
+  for (int i = first; i < count; i++) {
+    float *ms = ring->ms[i % S2D_FRAME_HISTORY];
+    fprintf(f, "%i,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+            i + 1, ms[0], ms[1], ms[2], ms[3], ms[4]);
+  }
+
+  fclose(f);
+  S2D_Log(S2D_INFO, "Wrote %i frame times to `%s`", count - first, path);
+  return 0;
+}
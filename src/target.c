@@ -0,0 +1,183 @@
+// target.c
+
+#include "../include/simple2d.h"
+
+// A freed framebuffer, kept for targets of the same size
+typedef struct {
+  GLuint fbo;
+  GLuint texture_id;
+  int width;
+  int height;
+} S2D_PooledTarget;
+
+static S2D_PooledTarget pool[S2D_TARGET_POOL_SIZE];
+static int pool_count = 0;
+
+// The target being drawn to, if any
+static S2D_RenderTarget *current = NULL;
+
+
+/*
+ * Check if a render target is being drawn to, including by nesting
+ */
+static bool S2D_IsDrawingTo(S2D_RenderTarget *target) {
+  for (S2D_RenderTarget *t = current; t; t = t->prev) {
+    if (t == target) return true;
+  }
+  return false;
+}
+
+
+/*
+ * Create a render target of the given size in pixels
+ */
+S2D_RenderTarget *S2D_CreateRenderTarget(int width, int height) {
+  S2D_Init();
+
+  if (width <= 0 || height <= 0) {
+    S2D_Error("S2D_CreateRenderTarget", "Invalid size %ix%i", width, height);
+    return NULL;
+  }
+
+  S2D_RenderTarget *target = (S2D_RenderTarget *) calloc(1, sizeof(S2D_RenderTarget));
+  if (!target) {
+    S2D_Error("S2D_CreateRenderTarget", "Out of memory!");
+    return NULL;
+  }
+
+  target->color.r = 1.f;
+  target->color.g = 1.f;
+  target->color.b = 1.f;
+  target->color.a = 1.f;
+  target->orig_width  = width;
+  target->orig_height = height;
+  target->width  = width;
+  target->height = height;
+  target->dirty = true;
+
+  // Reuse a framebuffer of the same size; its contents are stale, so the
+  // target stays dirty
+  for (int i = pool_count - 1; i >= 0; i--) {
+    if (pool[i].width == width && pool[i].height == height) {
+      target->fbo = pool[i].fbo;
+      target->texture_id = pool[i].texture_id;
+      pool[i] = pool[--pool_count];
+      break;
+    }
+  }
+
+  return target;
+}
+
+
+/*
+ * Begin drawing to a render target
+ */
+void S2D_BeginRenderTarget(S2D_RenderTarget *target) {
+  if (!target) return;
+
+  if (S2D_IsDrawingTo(target)) {
+    S2D_Error("S2D_BeginRenderTarget", "Already drawing to this render target");
+    return;
+  }
+
+  // The framebuffer is created when first drawn to, once there's a context
+  if (target->fbo == 0 &&
+      S2D_GL_CreateFramebuffer(&target->fbo, &target->texture_id,
+                               target->orig_width, target->orig_height) != 0) {
+    return;
+  }
+
+  target->prev = current;
+  current = target;
+
+  S2D_GL_BindFramebuffer(target->fbo, target->orig_width, target->orig_height);
+  S2D_GL_Clear((S2D_Color){ 0, 0, 0, 0 });
+}
+
+
+/*
+ * End drawing to a render target
+ */
+void S2D_EndRenderTarget(S2D_RenderTarget *target) {
+  if (!target) return;
+
+  if (target != current) {
+    S2D_Error("S2D_EndRenderTarget", "Not drawing to this render target");
+    return;
+  }
+
+  current = target->prev;
+  target->prev = NULL;
+  target->dirty = false;
+
+  if (current) {
+    S2D_GL_BindFramebuffer(current->fbo, current->orig_width, current->orig_height);
+  } else {
+    S2D_GL_BindFramebuffer(0, 0, 0);
+  }
+}
+
+
+/*
+ * Draw a render target
+ */
+void S2D_DrawRenderTarget(S2D_RenderTarget *target) {
+  if (!target || target->texture_id == 0) return;
+
+  if (S2D_IsDrawingTo(target)) {
+    S2D_Error("S2D_DrawRenderTarget", "Can't draw a render target into itself");
+    return;
+  }
+
+  // Framebuffer rows start at the bottom, so flip the texture coordinates
+  S2D_Image img = { .texture_id = target->texture_id };
+  S2D_Sprite spr = {
+    .img = &img, .color = target->color,
+    .x = target->x, .y = target->y,
+    .width = target->width, .height = target->height,
+    .rotate = target->rotate, .rx = target->rx, .ry = target->ry,
+    .tx1 = 0.f, .ty1 = 1.f, .tx2 = 1.f, .ty2 = 1.f,
+    .tx3 = 1.f, .ty3 = 0.f, .tx4 = 0.f, .ty4 = 0.f
+  };
+
+  S2D_GL_DrawSprite(&spr);
+}
+
+
+/*
+ * Free a render target, returning its framebuffer to the pool
+ */
+void S2D_FreeRenderTarget(S2D_RenderTarget *target) {
+  if (!target) return;
+
+  if (S2D_IsDrawingTo(target)) {
+    S2D_Error("S2D_FreeRenderTarget", "Can't free a render target being drawn to");
+    return;
+  }
+
+  if (target->fbo != 0) {
+    // Make room by freeing the oldest framebuffer in the pool
+    if (pool_count == S2D_TARGET_POOL_SIZE) {
+      S2D_GL_FreeFramebuffer(&pool[0].fbo, &pool[0].texture_id);
+      memmove(pool, pool + 1, (pool_count - 1) * sizeof(S2D_PooledTarget));
+      pool_count--;
+    }
+    pool[pool_count++] = (S2D_PooledTarget){
+      target->fbo, target->texture_id, target->orig_width, target->orig_height
+    };
+  }
+
+  free(target);
+}
+
+
+/*
+ * Free the framebuffers in the render target pool
+ */
+void S2D_ClearRenderTargetPool() {
+  for (int i = 0; i < pool_count; i++) {
+    S2D_GL_FreeFramebuffer(&pool[i].fbo, &pool[i].texture_id);
+  }
+  pool_count = 0;
+}
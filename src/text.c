@@ -2,6 +2,329 @@
 
 #include "../include/simple2d.h"
 
+// Distance field fonts loaded so far, shared between text objects
+static S2D_SDFFont *sdf_fonts = NULL;
+
+
+/*
+ * Compute the signed distance field of a glyph's coverage into an atlas cell
+ */
+static void S2D_ComputeGlyphSDF(SDL_Surface *glyph, Uint8 *cell, int pitch) {
+
+  const int spread = S2D_SDF_SPREAD;
+  int w = glyph->w + spread * 2;
+  int h = glyph->h + spread * 2;
+
+  // Build an inside/outside mask of the glyph, padded by the spread
+  Uint8 *mask = (Uint8 *) calloc(w * h, 1);
+  if (!mask) return;
+
+  for (int y = 0; y < glyph->h; y++) {
+    Uint32 *row = (Uint32 *)((Uint8 *)glyph->pixels + y * glyph->pitch);
+    for (int x = 0; x < glyph->w; x++) {
+      Uint32 alpha = (row[x] & glyph->format->Amask) >> glyph->format->Ashift;
+      mask[(y + spread) * w + x + spread] = alpha >= 128;
+    }
+  }
+
+  // For each pixel, find the nearest pixel on the other side of the edge
+  // within the spread, and map the signed distance to 0..255, edge at 127.5
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      Uint8 inside = mask[y * w + x];
+      int best = (spread + 1) * (spread + 1);
+
+      int y1 = y - spread < 0 ? 0 : y - spread;
+      int y2 = y + spread >= h ? h - 1 : y + spread;
+      int x1 = x - spread < 0 ? 0 : x - spread;
+      int x2 = x + spread >= w ? w - 1 : x + spread;
+
+      for (int sy = y1; sy <= y2; sy++) {
+        int dy = (sy - y) * (sy - y);
+        if (dy >= best) continue;
+        for (int sx = x1; sx <= x2; sx++) {
+          if (mask[sy * w + sx] != inside) {
+            int d = dy + (sx - x) * (sx - x);
+            if (d < best) best = d;
+          }
+        }
+      }
+
+      float dist = sqrtf((float)best) - 0.5f;
+      if (dist > spread) dist = spread;
+      if (!inside) dist = -dist;
+
+      float value = 0.5f + dist / (2.0f * spread);
+      cell[y * pitch + x] = (Uint8)(value * 255.0f + 0.5f);
+    }
+  }
+
+  free(mask);
+}
+
+
+/*
+ * Render a glyph and pack its distance field into the atlas
+ */
+static void S2D_AddSDFGlyph(S2D_SDFFont *sdf, Uint16 ch, S2D_SDFGlyph *g) {
+
+  const int size = S2D_SDF_ATLAS_SIZE;
+  SDL_Color white = { 255, 255, 255, 255 };
+
+  g->provided = false;
+  if (!TTF_GlyphIsProvided(sdf->font_data, ch)) return;
+
+  int minx, maxx, miny, maxy, advance;
+  if (TTF_GlyphMetrics(sdf->font_data, ch, &minx, &maxx, &miny, &maxy, &advance) != 0) return;
+
+  SDL_Surface *glyph = TTF_RenderGlyph_Blended(sdf->font_data, ch, white);
+  if (!glyph) return;
+
+  int w = glyph->w + S2D_SDF_SPREAD * 2;
+  int h = glyph->h + S2D_SDF_SPREAD * 2;
+
+  // Pack cells into rows of the atlas, leaving a pixel between them
+  if (sdf->pen_x + w + 1 > size) {
+    sdf->pen_x = 1;
+    sdf->pen_y += sdf->row_height + 1;
+    sdf->row_height = 0;
+  }
+  if (sdf->pen_y + h + 1 > size) {
+    S2D_Log(S2D_WARN, "Glyph atlas for `%s` is full", sdf->path);
+    SDL_FreeSurface(glyph);
+    return;
+  }
+
+  S2D_ComputeGlyphSDF(glyph, &sdf->pixels[sdf->pen_y * size + sdf->pen_x], size);
+  SDL_FreeSurface(glyph);
+
+  g->provided = true;
+  g->width    = w;
+  g->height   = h;
+  g->advance  = advance;
+  g->tx1 = sdf->pen_x / (GLfloat)size;
+  g->ty1 = sdf->pen_y / (GLfloat)size;
+  g->tx2 = (sdf->pen_x + w) / (GLfloat)size;
+  g->ty2 = (sdf->pen_y + h) / (GLfloat)size;
+
+  sdf->pen_x += w + 1;
+  if (h > sdf->row_height) sdf->row_height = h;
+  sdf->dirty = true;
+}
+
+
+/*
+ * Get a glyph from a distance field font, adding it to the atlas if it's not
+ * Latin-1 and used for the first time. Returns NULL if the font doesn't have it.
+ */
+static S2D_SDFGlyph *S2D_GetSDFGlyph(S2D_SDFFont *sdf, Uint32 ch) {
+
+  if (ch < 256) {
+    return sdf->glyphs[ch].provided ? &sdf->glyphs[ch] : NULL;
+  }
+
+  // Glyphs can only be rendered from the Basic Multilingual Plane
+  if (ch > 0xFFFF) return NULL;
+
+  // Look up the glyph in the hash table, using linear probing
+  if (sdf->extra_capacity > 0) {
+    for (int i = ch & (sdf->extra_capacity - 1); sdf->extra_codes[i];
+         i = (i + 1) & (sdf->extra_capacity - 1)) {
+      if (sdf->extra_codes[i] == ch) {
+        return sdf->extra_glyphs[i].provided ? &sdf->extra_glyphs[i] : NULL;
+      }
+    }
+  }
+
+  // Not seen yet; grow the table to keep it at most half full
+  if ((sdf->extra_count + 1) * 2 > sdf->extra_capacity) {
+    int capacity = sdf->extra_capacity ? sdf->extra_capacity * 2 : 64;
+    Uint16 *codes = (Uint16 *) calloc(capacity, sizeof(Uint16));
+    S2D_SDFGlyph *glyphs = (S2D_SDFGlyph *) calloc(capacity, sizeof(S2D_SDFGlyph));
+    if (!codes || !glyphs) {
+      S2D_Error("S2D_GetSDFGlyph", "Out of memory!");
+      free(codes);
+      free(glyphs);
+      return NULL;
+    }
+    for (int i = 0; i < sdf->extra_capacity; i++) {
+      if (!sdf->extra_codes[i]) continue;
+      int j = sdf->extra_codes[i] & (capacity - 1);
+      while (codes[j]) j = (j + 1) & (capacity - 1);
+      codes[j] = sdf->extra_codes[i];
+      glyphs[j] = sdf->extra_glyphs[i];
+    }
+    free(sdf->extra_codes);
+    free(sdf->extra_glyphs);
+    sdf->extra_codes = codes;
+    sdf->extra_glyphs = glyphs;
+    sdf->extra_capacity = capacity;
+  }
+
+  int i = ch & (sdf->extra_capacity - 1);
+  while (sdf->extra_codes[i]) i = (i + 1) & (sdf->extra_capacity - 1);
+
+  // Missing glyphs are stored too, so they're only looked for once
+  sdf->extra_codes[i] = ch;
+  sdf->extra_count++;
+  S2D_AddSDFGlyph(sdf, ch, &sdf->extra_glyphs[i]);
+
+  return sdf->extra_glyphs[i].provided ? &sdf->extra_glyphs[i] : NULL;
+}
+
+
+/*
+ * Get the distance field font for a font file, creating the atlas if needed
+ */
+static S2D_SDFFont *S2D_LoadSDFFont(const char *path) {
+
+  // Reuse the atlas if this font was already loaded
+  for (S2D_SDFFont *f = sdf_fonts; f; f = f->next) {
+    if (strcmp(f->path, path) == 0) {
+      f->refs++;
+      return f;
+    }
+  }
+
+  TTF_Font *font = TTF_OpenFont(path, S2D_SDF_BASE_SIZE);
+  if (!font) {
+    S2D_Error("TTF_OpenFont", TTF_GetError());
+    return NULL;
+  }
+
+  S2D_SDFFont *sdf = (S2D_SDFFont *) calloc(1, sizeof(S2D_SDFFont));
+  const int size = S2D_SDF_ATLAS_SIZE;
+  if (sdf) {
+    sdf->pixels = (Uint8 *) calloc(size * size, 1);
+    sdf->path = (char *) malloc(strlen(path) + 1);
+  }
+  if (!sdf || !sdf->pixels || !sdf->path) {
+    S2D_Error("S2D_LoadSDFFont", "Out of memory!");
+    if (sdf) {
+      free(sdf->pixels);
+      free(sdf->path);
+      free(sdf);
+    }
+    TTF_CloseFont(font);
+    return NULL;
+  }
+
+  // Keep a copy of the path, which the caller may not
+  strcpy(sdf->path, path);
+  sdf->font_data = font;
+  sdf->line_height = TTF_FontHeight(font);
+  sdf->pen_x = 1;
+  sdf->pen_y = 1;
+
+  // Latin-1 glyphs are added up front, skipping control characters
+  for (int ch = 32; ch < 256; ch++) {
+    if (ch >= 127 && ch < 160) continue;
+    S2D_AddSDFGlyph(sdf, ch, &sdf->glyphs[ch]);
+  }
+
+  sdf->refs = 1;
+  sdf->next = sdf_fonts;
+  sdf_fonts = sdf;
+
+  return sdf;
+}
+
+
+/*
+ * Release a distance field font, freeing it when no text uses it anymore
+ */
+static void S2D_ReleaseSDFFont(S2D_SDFFont *sdf) {
+  if (!sdf || --sdf->refs > 0) return;
+
+  for (S2D_SDFFont **f = &sdf_fonts; *f; f = &(*f)->next) {
+    if (*f == sdf) {
+      *f = sdf->next;
+      break;
+    }
+  }
+
+  S2D_GL_FreeTexture(&sdf->texture_id);
+  TTF_CloseFont(sdf->font_data);
+  free(sdf->extra_codes);
+  free(sdf->extra_glyphs);
+  free(sdf->pixels);
+  free(sdf->path);
+  free(sdf);
+}
+
+
+/*
+ * Upload the atlas texture of a distance field font, if it changed
+ */
+static void S2D_UploadSDFFont(S2D_SDFFont *sdf) {
+  if (sdf->texture_id != 0 && !sdf->dirty) return;
+  S2D_GL_CreateAlphaTexture(&sdf->texture_id,
+                            S2D_SDF_ATLAS_SIZE, S2D_SDF_ATLAS_SIZE,
+                            sdf->pixels);
+  sdf->dirty = false;
+}
+
+
+/*
+ * Lay out glyph quads of distance field text, and measure it
+ */
+static void S2D_LayoutSDFText(S2D_Text *txt) {
+
+  int len = strlen(txt->msg);
+
+  if (len > txt->quad_capacity) {
+    GLfloat *quads = (GLfloat *) realloc(txt->quads, len * 8 * sizeof(GLfloat));
+    if (!quads) {
+      S2D_Error("S2D_LayoutSDFText", "Out of memory!");
+      return;
+    }
+    txt->quads = quads;
+    txt->quad_capacity = len;
+  }
+
+  const GLfloat spread = S2D_SDF_SPREAD;
+  GLfloat pen_x = 0;
+  int count = 0;
+
+  for (int i = 0; i < len; i++) {
+    S2D_SDFGlyph *g = S2D_GetSDFGlyph(txt->sdf, (Uint8)txt->msg[i]);
+    if (!g) g = S2D_GetSDFGlyph(txt->sdf, '?');
+    if (!g) continue;
+
+    GLfloat *q = &txt->quads[count * 8];
+    q[0] = pen_x - spread;
+    q[1] = -spread;
+    q[2] = pen_x - spread + g->width;
+    q[3] = -spread + g->height;
+    q[4] = g->tx1; q[5] = g->ty1;
+    q[6] = g->tx2; q[7] = g->ty2;
+
+    pen_x += g->advance;
+    count++;
+  }
+
+  txt->quad_count = count;
+
+  // Save the width and height of the text at its size
+  GLfloat scale = txt->size / S2D_SDF_BASE_SIZE;
+  txt->width  = pen_x * scale + 0.5f;
+  txt->height = txt->sdf->line_height * scale + 0.5f;
+}
+
+
+/*
+ * Copy a font file path, which the caller may not keep
+ */
+static char *S2D_CopyFontPath(const char *path, const char *caller) {
+  char *copy = (char *) malloc(strlen(path) + 1);
+  if (!copy) {
+    S2D_Error(caller, "Out of memory!");
+    return NULL;
+  }
+  strcpy(copy, path);
+  return copy;
+}
+
 
 /*
  * Create text, given a font file path, the message, and size
@@ -25,18 +348,28 @@ S2D_Text *S2D_CreateText(const char *font, const char *msg, int size) {
     return NULL;
   }
 
+  txt->font = S2D_CopyFontPath(font, "S2D_CreateText");
+  if (!txt->font) {
+    free(txt);
+    return NULL;
+  }
+
   // Open the font
   txt->font_data = TTF_OpenFont(font, size);
   if (!txt->font_data) {
     S2D_Error("TTF_OpenFont", TTF_GetError());
+    free(txt->font);
     free(txt);
     return NULL;
   }
 
   // Initialize values
-  txt->font = font;
-  txt->msg = (char *) malloc(strlen(msg) + 1 * sizeof(char));
+  txt->msg_capacity = strlen(msg) + 1;
+  txt->msg = (char *) malloc(txt->msg_capacity * sizeof(char));
   strcpy(txt->msg, msg);
+  txt->next_msg = NULL;
+  txt->next_msg_capacity = 0;
+  txt->renders_skipped = 0;
   txt->x = 0;
   txt->y = 0;
   txt->color.r = 1.f;
@@ -47,6 +380,11 @@ S2D_Text *S2D_CreateText(const char *font, const char *msg, int size) {
   txt->rx = 0;
   txt->ry = 0;
   txt->texture_id = 0;
+  txt->sdf = NULL;
+  txt->quads = NULL;
+  txt->quad_count = 0;
+  txt->quad_capacity = 0;
+  txt->size = size;
 
   // Save the width and height of the text
   TTF_SizeText(txt->font_data, txt->msg, &txt->width, &txt->height);
@@ -55,6 +393,99 @@ S2D_Text *S2D_CreateText(const char *font, const char *msg, int size) {
 }
 
 
+/*
+ * Create text rendered from a signed distance field glyph atlas
+ */
+S2D_Text *S2D_CreateSDFText(const char *font, const char *msg, int size) {
+  S2D_Init();
+
+  // Check if font file exists
+  if (!S2D_FileExists(font)) {
+    S2D_Error("S2D_CreateSDFText", "Font file `%s` not found", font);
+    return NULL;
+  }
+
+  if (msg == NULL || strlen(msg) == 0) msg = " ";
+
+  // Allocate the text structure
+  S2D_Text *txt = (S2D_Text *) malloc(sizeof(S2D_Text));
+  if (!txt) {
+    S2D_Error("S2D_CreateSDFText", "Out of memory!");
+    return NULL;
+  }
+
+  txt->font = S2D_CopyFontPath(font, "S2D_CreateSDFText");
+  if (!txt->font) {
+    free(txt);
+    return NULL;
+  }
+
+  // Get the shared glyph atlas
+  txt->sdf = S2D_LoadSDFFont(font);
+  if (!txt->sdf) {
+    free(txt->font);
+    free(txt);
+    return NULL;
+  }
+
+  // Initialize values
+  txt->font_data = NULL;
+  txt->surface = NULL;
+  txt->msg_capacity = strlen(msg) + 1;
+  txt->msg = (char *) malloc(txt->msg_capacity * sizeof(char));
+  strcpy(txt->msg, msg);
+  txt->next_msg = NULL;
+  txt->next_msg_capacity = 0;
+  txt->renders_skipped = 0;
+  txt->x = 0;
+  txt->y = 0;
+  txt->color.r = 1.f;
+  txt->color.g = 1.f;
+  txt->color.b = 1.f;
+  txt->color.a = 1.f;
+  txt->rotate = 0;
+  txt->rx = 0;
+  txt->ry = 0;
+  txt->texture_id = 0;
+  txt->quads = NULL;
+  txt->quad_count = 0;
+  txt->quad_capacity = 0;
+  txt->size = size;
+
+  S2D_LayoutSDFText(txt);
+
+  return txt;
+}
+
+
+/*
+ * Set the text size in pixels
+ */
+void S2D_SetTextSize(S2D_Text *txt, GLfloat size) {
+  if (!txt || size <= 0 || size == txt->size) return;
+
+  txt->size = size;
+
+  // Distance field text only needs to be measured again
+  if (txt->sdf) {
+    S2D_LayoutSDFText(txt);
+    return;
+  }
+
+  // Otherwise, the font has to be opened at the new size
+  TTF_Font *font_data = TTF_OpenFont(txt->font, (int)size);
+  if (!font_data) {
+    S2D_Error("TTF_OpenFont", TTF_GetError());
+    return;
+  }
+  TTF_CloseFont(txt->font_data);
+  txt->font_data = font_data;
+
+  TTF_SizeText(txt->font_data, txt->msg, &txt->width, &txt->height);
+  S2D_GL_FreeTexture(&txt->texture_id);
+}
+
+
 /*
  * Set the text message
  */
@@ -64,12 +495,48 @@ void S2D_SetText(S2D_Text *txt, const char *msg, ...) {
   // `msg` cannot be an empty string or NULL for TTF_SizeText
   if (msg == NULL || strlen(msg) == 0) msg = " ";
 
-  // Format and store new text string
+  // Format into the text's spare buffer, growing it only when a longer
+  // message comes along
   va_list args;
   va_start(args, msg);
-  free(txt->msg);
-  vasprintf(&txt->msg, msg, args);
+  va_list args_copy;
+  va_copy(args_copy, args);
+  int len = vsnprintf(txt->next_msg, txt->next_msg_capacity, msg, args);
+  if (len >= 0 && (size_t)len >= txt->next_msg_capacity) {
+    char *tmp = (char *) realloc(txt->next_msg, len + 1);
+    if (!tmp) {
+      S2D_Error("S2D_SetText", "Out of memory!");
+      va_end(args_copy);
+      va_end(args);
+      return;
+    }
+    txt->next_msg = tmp;
+    txt->next_msg_capacity = len + 1;
+    vsnprintf(txt->next_msg, txt->next_msg_capacity, msg, args_copy);
+  }
+  va_end(args_copy);
   va_end(args);
+  if (len < 0) return;
+
+  // Nothing changed, keep the current texture
+  if (strcmp(txt->next_msg, txt->msg) == 0) {
+    txt->renders_skipped++;
+    return;
+  }
+
+  // Swap in the new message, keeping the old buffer for next time
+  char *old_msg = txt->msg;
+  size_t old_capacity = txt->msg_capacity;
+  txt->msg = txt->next_msg;
+  txt->msg_capacity = txt->next_msg_capacity;
+  txt->next_msg = old_msg;
+  txt->next_msg_capacity = old_capacity;
+
+  // Distance field text just needs its glyph quads laid out again
+  if (txt->sdf) {
+    S2D_LayoutSDFText(txt);
+    return;
+  }
 
   // Save the width and height of the text
   TTF_SizeText(txt->font_data, txt->msg, &txt->width, &txt->height);
@@ -100,6 +567,17 @@ void S2D_RotateText(S2D_Text *txt, GLfloat angle, int position) {
 void S2D_DrawText(S2D_Text *txt) {
   if (!txt) return;
 
+  if (txt->sdf) {
+    S2D_SDFFont *sdf = txt->sdf;
+    S2D_UploadSDFFont(sdf);
+    GLfloat scale = txt->size / S2D_SDF_BASE_SIZE;
+    S2D_GL_DrawGlyphs(sdf->texture_id, txt->quads, txt->quad_count,
+                      txt->x, txt->y, scale,
+                      txt->rotate, txt->rx, txt->ry,
+                      txt->color, 0.25f / (S2D_SDF_SPREAD * scale));
+    return;
+  }
+
   if (txt->texture_id == 0) {
     SDL_Color color = { 255, 255, 255 };
     txt->surface = TTF_RenderText_Blended(txt->font_data, txt->msg, color);
@@ -122,8 +600,445 @@ void S2D_DrawText(S2D_Text *txt) {
  */
 void S2D_FreeText(S2D_Text *txt) {
   if (!txt) return;
+  free(txt->font);
   free(txt->msg);
+  free(txt->next_msg);
+  free(txt->quads);
   S2D_GL_FreeTexture(&txt->texture_id);
-  TTF_CloseFont(txt->font_data);
+  if (txt->sdf) {
+    S2D_ReleaseSDFFont(txt->sdf);
+  } else {
+    TTF_CloseFont(txt->font_data);
+  }
   free(txt);
 }
+
+
+/*
+ * Decode the UTF-8 character at byte `*i` of a string, moving `*i` past it.
+ * Invalid bytes are decoded as the replacement character.
+ */
+static Uint32 S2D_DecodeUTF8(const char *s, int len, int *i) {
+  const Uint8 *u = (const Uint8 *)s;
+  Uint32 c = u[*i];
+  int n = 0;
+
+  if      (c < 0x80)           { (*i)++; return c; }
+  else if ((c & 0xE0) == 0xC0) { n = 1; c &= 0x1F; }
+  else if ((c & 0xF0) == 0xE0) { n = 2; c &= 0x0F; }
+  else if ((c & 0xF8) == 0xF0) { n = 3; c &= 0x07; }
+  else                         { (*i)++; return 0xFFFD; }
+
+  if (*i + n >= len) {
+    (*i)++;
+    return 0xFFFD;
+  }
+  for (int k = 1; k <= n; k++) {
+    if ((u[*i + k] & 0xC0) != 0x80) {
+      (*i)++;
+      return 0xFFFD;
+    }
+    c = (c << 6) | (u[*i + k] & 0x3F);
+  }
+  *i += n + 1;
+  return c;
+}
+
+
+/*
+ * Find the paragraph containing a byte offset of the layout text
+ */
+static int S2D_FindParagraph(S2D_TextLayout *layout, int pos) {
+  int lo = 0, hi = layout->paragraph_count - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (layout->paragraphs[mid].start <= pos) lo = mid;
+    else hi = mid - 1;
+  }
+  return lo;
+}
+
+
+/*
+ * Shift the quads of a finished line by its alignment offset
+ */
+static void S2D_AlignLine(S2D_TextLayout *layout, GLfloat *quads, int count,
+                          GLfloat line_width, GLfloat wrap) {
+  GLfloat offset;
+  switch (layout->align) {
+    case S2D_ALIGN_CENTER: offset = ((wrap > 0 ? wrap : 0) - line_width) / 2; break;
+    case S2D_ALIGN_RIGHT:  offset =  (wrap > 0 ? wrap : 0) - line_width;      break;
+    default: return;
+  }
+  for (int i = 0; i < count; i++) {
+    quads[i * 8]     += offset;
+    quads[i * 8 + 2] += offset;
+  }
+}
+
+
+/*
+ * Lay out the glyph quads of a paragraph, wrapping it into lines
+ */
+static void S2D_LayoutParagraph(S2D_TextLayout *layout, S2D_TextParagraph *p) {
+  S2D_SDFFont *sdf = layout->sdf;
+
+  // There's at most one quad for each byte
+  if (p->length > p->quad_capacity) {
+    GLfloat *quads = (GLfloat *) realloc(p->quads, p->length * 8 * sizeof(GLfloat));
+    if (!quads) {
+      S2D_Error("S2D_LayoutParagraph", "Out of memory!");
+      return;
+    }
+    p->quads = quads;
+    p->quad_capacity = p->length;
+  }
+
+  const GLfloat spread = S2D_SDF_SPREAD;
+  const GLfloat line_height = sdf->line_height;
+  GLfloat wrap = layout->wrap_width > 0 ?
+    layout->wrap_width / (layout->size / S2D_SDF_BASE_SIZE) : 0;
+
+  S2D_SDFGlyph *space = S2D_GetSDFGlyph(sdf, ' ');
+  GLfloat space_advance = space ? space->advance : S2D_SDF_BASE_SIZE / 4;
+
+  const char *s = &layout->text[p->start];
+  int count = 0;
+  int line = 0;
+  int line_start = 0;       // first quad of the current line
+  GLfloat pen_x = 0;
+  GLfloat line_width = 0;   // right edge of the last glyph on the line
+  int word_start = -1;      // first quad after the last space on the line
+  GLfloat word_x = 0;       // pen position after that space
+  GLfloat word_width = 0;   // line width before that space
+  p->width = 0;
+
+  for (int i = 0; i < p->length;) {
+    Uint32 c = S2D_DecodeUTF8(s, p->length, &i);
+
+    if (c == '\r') continue;
+
+    // Spaces don't have quads, but are where lines can be wrapped
+    if (c == ' ' || c == '\t') {
+      pen_x += c == '\t' ? space_advance * 4 : space_advance;
+      word_start = count;
+      word_x = pen_x;
+      word_width = line_width;
+      continue;
+    }
+
+    S2D_SDFGlyph *g = S2D_GetSDFGlyph(sdf, c);
+    if (!g) g = S2D_GetSDFGlyph(sdf, '?');
+    if (!g) continue;
+
+    // Wrap the line if this glyph doesn't fit
+    if (wrap > 0 && count > line_start && pen_x + g->advance > wrap) {
+      int moved = 0;
+      if (word_start > line_start) {
+        // Move the word being written to the next line
+        moved = count - word_start;
+        S2D_AlignLine(layout, &p->quads[line_start * 8], word_start - line_start, word_width, wrap);
+        if (word_width > p->width) p->width = word_width;
+        for (int q = word_start; q < count; q++) {
+          p->quads[q * 8]     -= word_x;
+          p->quads[q * 8 + 1] += line_height;
+          p->quads[q * 8 + 2] -= word_x;
+          p->quads[q * 8 + 3] += line_height;
+        }
+        pen_x -= word_x;
+        line_width -= word_x;
+      } else {
+        // The word is longer than the line, so break it here
+        S2D_AlignLine(layout, &p->quads[line_start * 8], count - line_start, line_width, wrap);
+        if (line_width > p->width) p->width = line_width;
+        pen_x = 0;
+        line_width = 0;
+      }
+      line++;
+      line_start = count - moved;
+      word_start = -1;
+    }
+
+    GLfloat *q = &p->quads[count * 8];
+    q[0] = pen_x - spread;
+    q[1] = line * line_height - spread;
+    q[2] = pen_x - spread + g->width;
+    q[3] = line * line_height - spread + g->height;
+    q[4] = g->tx1; q[5] = g->ty1;
+    q[6] = g->tx2; q[7] = g->ty2;
+
+    pen_x += g->advance;
+    line_width = pen_x;
+    count++;
+  }
+
+  S2D_AlignLine(layout, &p->quads[line_start * 8], count - line_start, line_width, wrap);
+  if (line_width > p->width) p->width = line_width;
+
+  p->quad_count = count;
+  p->lines = line + 1;
+  p->dirty = false;
+  layout->paragraphs_laid_out++;
+}
+
+
+/*
+ * Create a text layout
+ */
+S2D_TextLayout *S2D_CreateTextLayout(const char *font, int size, GLfloat wrap_width, int align) {
+  S2D_Init();
+
+  // Check if font file exists
+  if (!S2D_FileExists(font)) {
+    S2D_Error("S2D_CreateTextLayout", "Font file `%s` not found", font);
+    return NULL;
+  }
+
+  S2D_TextLayout *layout = (S2D_TextLayout *) calloc(1, sizeof(S2D_TextLayout));
+  if (layout) {
+    layout->text = (char *) malloc(64);
+    layout->paragraphs = (S2D_TextParagraph *) calloc(16, sizeof(S2D_TextParagraph));
+  }
+  if (!layout || !layout->text || !layout->paragraphs) {
+    S2D_Error("S2D_CreateTextLayout", "Out of memory!");
+    if (layout) {
+      free(layout->text);
+      free(layout->paragraphs);
+      free(layout);
+    }
+    return NULL;
+  }
+
+  // Get the shared glyph atlas
+  layout->font = S2D_CopyFontPath(font, "S2D_CreateTextLayout");
+  layout->sdf = layout->font ? S2D_LoadSDFFont(font) : NULL;
+  if (!layout->sdf) {
+    free(layout->font);
+    free(layout->text);
+    free(layout->paragraphs);
+    free(layout);
+    return NULL;
+  }
+
+  // Start with a single empty paragraph
+  layout->text[0] = '\0';
+  layout->capacity = 64;
+  layout->paragraph_count = 1;
+  layout->paragraph_capacity = 16;
+  layout->paragraphs[0].dirty = true;
+  layout->size = size;
+  layout->wrap_width = wrap_width;
+  layout->align = align;
+  layout->color.r = 1.f;
+  layout->color.g = 1.f;
+  layout->color.b = 1.f;
+  layout->color.a = 1.f;
+  layout->dirty = true;
+
+  return layout;
+}
+
+
+/*
+ * Replace a range of the layout text
+ */
+void S2D_EditLayoutText(S2D_TextLayout *layout, int start, int length, const char *text) {
+  if (!layout) return;
+  if (!text) text = "";
+
+  if (start < 0) start = 0;
+  if (start > layout->length) start = layout->length;
+  if (length < 0) length = 0;
+  if (length > layout->length - start) length = layout->length - start;
+
+  int text_len = strlen(text);
+  int delta = text_len - length;
+
+  // Find the paragraphs the edit touches
+  int a = S2D_FindParagraph(layout, start);
+  int b = S2D_FindParagraph(layout, start + length);
+  int region_start = layout->paragraphs[a].start;
+  int region_end = layout->paragraphs[b].start + layout->paragraphs[b].length + delta;
+
+  // Splice the text
+  if (layout->length + delta + 1 > layout->capacity) {
+    int capacity = layout->capacity * 2;
+    if (capacity < layout->length + delta + 1) capacity = layout->length + delta + 1;
+    char *tmp = (char *) realloc(layout->text, capacity);
+    if (!tmp) {
+      S2D_Error("S2D_EditLayoutText", "Out of memory!");
+      return;
+    }
+    layout->text = tmp;
+    layout->capacity = capacity;
+  }
+  memmove(&layout->text[start + text_len], &layout->text[start + length],
+          layout->length - start - length + 1);
+  memcpy(&layout->text[start], text, text_len);
+  layout->length += delta;
+
+  // Count the paragraphs which replace the touched ones
+  int count = 1;
+  for (int i = region_start; i < region_end; i++) {
+    if (layout->text[i] == '\n') count++;
+  }
+
+  int old_count = b - a + 1;
+  int new_total = layout->paragraph_count - old_count + count;
+  if (new_total > layout->paragraph_capacity) {
+    int capacity = layout->paragraph_capacity * 2;
+    if (capacity < new_total) capacity = new_total;
+    S2D_TextParagraph *tmp = (S2D_TextParagraph *) realloc(
+      layout->paragraphs, capacity * sizeof(S2D_TextParagraph)
+    );
+    if (!tmp) {
+      S2D_Error("S2D_EditLayoutText", "Out of memory!");
+      return;
+    }
+    layout->paragraphs = tmp;
+    layout->paragraph_capacity = capacity;
+  }
+
+  for (int i = a; i <= b; i++) free(layout->paragraphs[i].quads);
+
+  // Move the following paragraphs into place, shifting their offsets
+  S2D_TextParagraph *ps = layout->paragraphs;
+  memmove(&ps[a + count], &ps[b + 1],
+          (layout->paragraph_count - b - 1) * sizeof(S2D_TextParagraph));
+  layout->paragraph_count = new_total;
+  for (int i = a + count; i < new_total; i++) ps[i].start += delta;
+
+  // Split the edited region into new paragraphs
+  int pos = region_start;
+  for (int i = a; i < a + count; i++) {
+    int end = pos;
+    while (end < region_end && layout->text[end] != '\n') end++;
+    memset(&ps[i], 0, sizeof(S2D_TextParagraph));
+    ps[i].start = pos;
+    ps[i].length = end - pos;
+    ps[i].dirty = true;
+    pos = end + 1;
+  }
+
+  layout->dirty = true;
+}
+
+
+/*
+ * Replace all text in a layout
+ */
+void S2D_SetLayoutText(S2D_TextLayout *layout, const char *text) {
+  if (!layout) return;
+  S2D_EditLayoutText(layout, 0, layout->length, text);
+}
+
+
+/*
+ * Append text to the end of a layout
+ */
+void S2D_AppendLayoutText(S2D_TextLayout *layout, const char *text) {
+  if (!layout) return;
+  S2D_EditLayoutText(layout, layout->length, 0, text);
+}
+
+
+/*
+ * Set the size, wrap width, and alignment of a layout
+ */
+void S2D_SetLayoutStyle(S2D_TextLayout *layout, int size, GLfloat wrap_width, int align) {
+  if (!layout || size <= 0) return;
+
+  // Quads are stored at the base size, so changing only the size of unwrapped
+  // text doesn't need them laid out again
+  bool relayout = wrap_width != layout->wrap_width || align != layout->align ||
+                  (wrap_width > 0 && size != layout->size);
+
+  layout->size = size;
+  layout->wrap_width = wrap_width;
+  layout->align = align;
+  layout->dirty = true;
+
+  if (relayout) {
+    for (int i = 0; i < layout->paragraph_count; i++) {
+      layout->paragraphs[i].dirty = true;
+    }
+  }
+}
+
+
+/*
+ * Lay out changed paragraphs and measure the layout
+ */
+void S2D_UpdateTextLayout(S2D_TextLayout *layout) {
+  if (!layout || !layout->dirty) return;
+
+  GLfloat y = 0, width = 0;
+  for (int i = 0; i < layout->paragraph_count; i++) {
+    S2D_TextParagraph *p = &layout->paragraphs[i];
+    if (p->dirty) S2D_LayoutParagraph(layout, p);
+    p->y = y;
+    y += p->lines * layout->sdf->line_height;
+    if (p->width > width) width = p->width;
+  }
+
+  GLfloat scale = layout->size / S2D_SDF_BASE_SIZE;
+  layout->width = width * scale;
+  layout->height = y * scale;
+  layout->dirty = false;
+}
+
+
+/*
+ * Draw a text layout
+ */
+void S2D_DrawTextLayout(S2D_TextLayout *layout) {
+  if (!layout) return;
+
+  S2D_UpdateTextLayout(layout);
+  S2D_UploadSDFFont(layout->sdf);
+
+  GLfloat scale = layout->size / S2D_SDF_BASE_SIZE;
+  GLfloat line_height = layout->sdf->line_height;
+  int first = 0;
+  GLfloat bottom = 0;
+
+  // Skip to the first paragraph in the clipped range
+  if (layout->clip_height > 0) {
+    GLfloat top = layout->clip_y / scale;
+    bottom = (layout->clip_y + layout->clip_height) / scale;
+    int lo = 0, hi = layout->paragraph_count - 1;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      S2D_TextParagraph *p = &layout->paragraphs[mid];
+      if (p->y + p->lines * line_height <= top) lo = mid + 1;
+      else hi = mid;
+    }
+    first = lo;
+  }
+
+  for (int i = first; i < layout->paragraph_count; i++) {
+    S2D_TextParagraph *p = &layout->paragraphs[i];
+    if (layout->clip_height > 0 && p->y >= bottom) break;
+    if (p->quad_count == 0) continue;
+    S2D_GL_DrawGlyphs(layout->sdf->texture_id, p->quads, p->quad_count,
+                      layout->x, layout->y + p->y * scale, scale,
+                      0, 0, 0,
+                      layout->color, 0.25f / (S2D_SDF_SPREAD * scale));
+  }
+}
+
+
+/*
+ * Free a text layout
+ */
+void S2D_FreeTextLayout(S2D_TextLayout *layout) {
+  if (!layout) return;
+  for (int i = 0; i < layout->paragraph_count; i++) {
+    free(layout->paragraphs[i].quads);
+  }
+  free(layout->paragraphs);
+  free(layout->text);
+  free(layout->font);
+  S2D_ReleaseSDFFont(layout->sdf);
+  free(layout);
+}
@@ -0,0 +1,398 @@
+// transform.c
+
+#include "../include/simple2d.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+  #define S2D_X86 1
+  #include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #define S2D_NEON 1
+  #include <arm_neon.h>
+#endif
+
+// Compile a function for an instruction set the rest of the library may not be
+// built for, so it's only called once the CPU is known to support it. MSVC
+// allows any intrinsics without this.
+#if defined(__GNUC__) || defined(__clang__)
+  #define S2D_TARGET(isa) __attribute__((target(isa)))
+#else
+  #define S2D_TARGET(isa)
+#endif
+
+// Coefficients of the sine and cosine polynomials on [-pi/4, pi/4]
+#define S2D_SIN_C1 -1.6666654611e-1f
+#define S2D_SIN_C2  8.3321608736e-3f
+#define S2D_SIN_C3 -1.9515295891e-4f
+#define S2D_COS_C1  4.166664568298827e-2f
+#define S2D_COS_C2 -1.388731625493765e-3f
+#define S2D_COS_C3  2.443315711809948e-5f
+
+// Transforms quads `first` to `last`, writing 8 floats per quad into `corners`
+typedef void (*S2D_QuadKernelFunc)(const S2D_QuadArrays *q, int first, int last,
+                                   float *corners);
+
+static S2D_QuadKernelFunc kernel_func = NULL;
+static int kernel = -1;
+
+
+/*
+ * Transform quads one at a time
+ */
+static void S2D_QuadCornersScalar(const S2D_QuadArrays *q, int first, int last,
+                                  float *corners) {
+
+  for (int i = first; i < last; i++) {
+    float sa = 0, ca = 1;
+    if (q->rotate[i] != 0) {
+      double rad = q->rotate[i] * M_PI / 180.0;
+      sa = sin(rad);
+      ca = cos(rad);
+    }
+
+    float rx = q->rx[i], ry = q->ry[i];
+    float dx1 = q->x[i] - rx, dx2 = q->x[i] + q->width[i]  - rx;
+    float dy1 = q->y[i] - ry, dy2 = q->y[i] + q->height[i] - ry;
+
+    float *c = corners + (size_t)i * 8;
+    c[0] = dx1 * ca - dy1 * sa + rx;  c[1] = dx1 * sa + dy1 * ca + ry;  // top-left
+    c[2] = dx2 * ca - dy1 * sa + rx;  c[3] = dx2 * sa + dy1 * ca + ry;  // top-right
+    c[4] = dx2 * ca - dy2 * sa + rx;  c[5] = dx2 * sa + dy2 * ca + ry;  // bottom-right
+    c[6] = dx1 * ca - dy2 * sa + rx;  c[7] = dx1 * sa + dy2 * ca + ry;  // bottom-left
+  }
+}
+
+
+#if S2D_X86
+
+/*
+ * Get the sine and cosine of 4 angles in degrees. Angles are reduced to within
+ * 45 degrees of a multiple of 90, which picks the sign of each and whether they
+ * swap.
+ */
+S2D_TARGET("sse2")
+static inline void S2D_SinCosSSE(__m128 deg, __m128 *s, __m128 *c) {
+  __m128i q = _mm_cvtps_epi32(_mm_mul_ps(deg, _mm_set1_ps(1 / 90.f)));
+  __m128 r = _mm_sub_ps(deg, _mm_mul_ps(_mm_cvtepi32_ps(q), _mm_set1_ps(90.f)));
+  r = _mm_mul_ps(r, _mm_set1_ps(M_PI / 180.0));
+  __m128 r2 = _mm_mul_ps(r, r);
+
+  __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(S2D_SIN_C3), r2), _mm_set1_ps(S2D_SIN_C2));
+  ps = _mm_add_ps(_mm_mul_ps(ps, r2), _mm_set1_ps(S2D_SIN_C1));
+  ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, r2), r), r);
+
+  __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(S2D_COS_C3), r2), _mm_set1_ps(S2D_COS_C2));
+  pc = _mm_add_ps(_mm_mul_ps(pc, r2), _mm_set1_ps(S2D_COS_C1));
+  pc = _mm_mul_ps(_mm_mul_ps(pc, r2), r2);
+  pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.f));
+
+  __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+  __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, _mm_set1_epi32(2)), 30));
+  __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(
+    _mm_and_si128(_mm_add_epi32(q, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+  *s = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps)), sin_sign);
+  *c = _mm_xor_ps(_mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc)), cos_sign);
+}
+
+
+/*
+ * Transform quads 4 at a time with SSE2
+ */
+S2D_TARGET("sse2")
+static void S2D_QuadCornersSSE(const S2D_QuadArrays *q, int first, int last,
+                               float *corners) {
+  int i = first;
+
+  for (; i + 4 <= last; i += 4) {
+    __m128 sa, ca;
+    S2D_SinCosSSE(_mm_loadu_ps(q->rotate + i), &sa, &ca);
+
+    __m128 rx = _mm_loadu_ps(q->rx + i), ry = _mm_loadu_ps(q->ry + i);
+    __m128 x = _mm_loadu_ps(q->x + i), y = _mm_loadu_ps(q->y + i);
+    __m128 dx1 = _mm_sub_ps(x, rx), dx2 = _mm_sub_ps(_mm_add_ps(x, _mm_loadu_ps(q->width + i)), rx);
+    __m128 dy1 = _mm_sub_ps(y, ry), dy2 = _mm_sub_ps(_mm_add_ps(y, _mm_loadu_ps(q->height + i)), ry);
+
+    __m128 xc1 = _mm_mul_ps(dx1, ca), xs1 = _mm_mul_ps(dx1, sa);
+    __m128 xc2 = _mm_mul_ps(dx2, ca), xs2 = _mm_mul_ps(dx2, sa);
+    __m128 yc1 = _mm_mul_ps(dy1, ca), ys1 = _mm_mul_ps(dy1, sa);
+    __m128 yc2 = _mm_mul_ps(dy2, ca), ys2 = _mm_mul_ps(dy2, sa);
+
+    // Each corner's x and y, for the 4 quads
+    __m128 c0 = _mm_add_ps(_mm_sub_ps(xc1, ys1), rx), c1 = _mm_add_ps(_mm_add_ps(xs1, yc1), ry);
+    __m128 c2 = _mm_add_ps(_mm_sub_ps(xc2, ys1), rx), c3 = _mm_add_ps(_mm_add_ps(xs2, yc1), ry);
+    __m128 c4 = _mm_add_ps(_mm_sub_ps(xc2, ys2), rx), c5 = _mm_add_ps(_mm_add_ps(xs2, yc2), ry);
+    __m128 c6 = _mm_add_ps(_mm_sub_ps(xc1, ys2), rx), c7 = _mm_add_ps(_mm_add_ps(xs1, yc2), ry);
+
+    // Transpose into the corners of each quad
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _MM_TRANSPOSE4_PS(c4, c5, c6, c7);
+
+    float *out = corners + (size_t)i * 8;
+    _mm_storeu_ps(out,      c0); _mm_storeu_ps(out + 4,  c4);
+    _mm_storeu_ps(out + 8,  c1); _mm_storeu_ps(out + 12, c5);
+    _mm_storeu_ps(out + 16, c2); _mm_storeu_ps(out + 20, c6);
+    _mm_storeu_ps(out + 24, c3); _mm_storeu_ps(out + 28, c7);
+  }
+
+  S2D_QuadCornersScalar(q, i, last, corners);
+}
+
+
+/*
+ * Get the sine and cosine of 8 angles in degrees, as in `S2D_SinCosSSE`
+ */
+S2D_TARGET("avx2")
+static inline void S2D_SinCosAVX2(__m256 deg, __m256 *s, __m256 *c) {
+  __m256i q = _mm256_cvtps_epi32(_mm256_mul_ps(deg, _mm256_set1_ps(1 / 90.f)));
+  __m256 r = _mm256_sub_ps(deg, _mm256_mul_ps(_mm256_cvtepi32_ps(q), _mm256_set1_ps(90.f)));
+  r = _mm256_mul_ps(r, _mm256_set1_ps(M_PI / 180.0));
+  __m256 r2 = _mm256_mul_ps(r, r);
+
+  __m256 ps = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(S2D_SIN_C3), r2), _mm256_set1_ps(S2D_SIN_C2));
+  ps = _mm256_add_ps(_mm256_mul_ps(ps, r2), _mm256_set1_ps(S2D_SIN_C1));
+  ps = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(ps, r2), r), r);
+
+  __m256 pc = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(S2D_COS_C3), r2), _mm256_set1_ps(S2D_COS_C2));
+  pc = _mm256_add_ps(_mm256_mul_ps(pc, r2), _mm256_set1_ps(S2D_COS_C1));
+  pc = _mm256_mul_ps(_mm256_mul_ps(pc, r2), r2);
+  pc = _mm256_add_ps(_mm256_sub_ps(pc, _mm256_mul_ps(r2, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.f));
+
+  __m256 swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(
+    _mm256_and_si256(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(1)));
+  __m256 sin_sign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(q, _mm256_set1_epi32(2)), 30));
+  __m256 cos_sign = _mm256_castsi256_ps(_mm256_slli_epi32(
+    _mm256_and_si256(_mm256_add_epi32(q, _mm256_set1_epi32(1)), _mm256_set1_epi32(2)), 30));
+
+  *s = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, swap), sin_sign);
+  *c = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, swap), cos_sign);
+}
+
+
+/*
+ * Transform quads 8 at a time with AVX2
+ */
+S2D_TARGET("avx2")
+static void S2D_QuadCornersAVX2(const S2D_QuadArrays *q, int first, int last,
+                                float *corners) {
+  int i = first;
+
+  for (; i + 8 <= last; i += 8) {
+    __m256 sa, ca;
+    S2D_SinCosAVX2(_mm256_loadu_ps(q->rotate + i), &sa, &ca);
+
+    __m256 rx = _mm256_loadu_ps(q->rx + i), ry = _mm256_loadu_ps(q->ry + i);
+    __m256 x = _mm256_loadu_ps(q->x + i), y = _mm256_loadu_ps(q->y + i);
+    __m256 dx1 = _mm256_sub_ps(x, rx), dx2 = _mm256_sub_ps(_mm256_add_ps(x, _mm256_loadu_ps(q->width + i)), rx);
+    __m256 dy1 = _mm256_sub_ps(y, ry), dy2 = _mm256_sub_ps(_mm256_add_ps(y, _mm256_loadu_ps(q->height + i)), ry);
+
+    __m256 xc1 = _mm256_mul_ps(dx1, ca), xs1 = _mm256_mul_ps(dx1, sa);
+    __m256 xc2 = _mm256_mul_ps(dx2, ca), xs2 = _mm256_mul_ps(dx2, sa);
+    __m256 yc1 = _mm256_mul_ps(dy1, ca), ys1 = _mm256_mul_ps(dy1, sa);
+    __m256 yc2 = _mm256_mul_ps(dy2, ca), ys2 = _mm256_mul_ps(dy2, sa);
+
+    // Each corner's x and y, for the 8 quads
+    __m256 c0 = _mm256_add_ps(_mm256_sub_ps(xc1, ys1), rx), c1 = _mm256_add_ps(_mm256_add_ps(xs1, yc1), ry);
+    __m256 c2 = _mm256_add_ps(_mm256_sub_ps(xc2, ys1), rx), c3 = _mm256_add_ps(_mm256_add_ps(xs2, yc1), ry);
+    __m256 c4 = _mm256_add_ps(_mm256_sub_ps(xc2, ys2), rx), c5 = _mm256_add_ps(_mm256_add_ps(xs2, yc2), ry);
+    __m256 c6 = _mm256_add_ps(_mm256_sub_ps(xc1, ys2), rx), c7 = _mm256_add_ps(_mm256_add_ps(xs1, yc2), ry);
+
+    // Transpose into the corners of each quad: interleave pairs, then gather
+    // 4 values of a quad in each half, then put the halves of a quad together
+    __m256 t0 = _mm256_unpacklo_ps(c0, c1), t1 = _mm256_unpackhi_ps(c0, c1);
+    __m256 t2 = _mm256_unpacklo_ps(c2, c3), t3 = _mm256_unpackhi_ps(c2, c3);
+    __m256 t4 = _mm256_unpacklo_ps(c4, c5), t5 = _mm256_unpackhi_ps(c4, c5);
+    __m256 t6 = _mm256_unpacklo_ps(c6, c7), t7 = _mm256_unpackhi_ps(c6, c7);
+
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    float *out = corners + (size_t)i * 8;
+    _mm256_storeu_ps(out,      _mm256_permute2f128_ps(u0, u4, 0x20));
+    _mm256_storeu_ps(out + 8,  _mm256_permute2f128_ps(u1, u5, 0x20));
+    _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(u2, u6, 0x20));
+    _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(u3, u7, 0x20));
+    _mm256_storeu_ps(out + 32, _mm256_permute2f128_ps(u0, u4, 0x31));
+    _mm256_storeu_ps(out + 40, _mm256_permute2f128_ps(u1, u5, 0x31));
+    _mm256_storeu_ps(out + 48, _mm256_permute2f128_ps(u2, u6, 0x31));
+    _mm256_storeu_ps(out + 56, _mm256_permute2f128_ps(u3, u7, 0x31));
+  }
+
+  S2D_QuadCornersScalar(q, i, last, corners);
+}
+
+#endif
+
+
+#if S2D_NEON
+
+/*
+ * Get the sine and cosine of 4 angles in degrees, as in `S2D_SinCosSSE`
+ */
+static inline void S2D_SinCosNEON(float32x4_t deg, float32x4_t *s, float32x4_t *c) {
+
+  // Round to the nearest multiple of 90, since conversion truncates
+  float32x4_t t = vmulq_f32(deg, vdupq_n_f32(1 / 90.f));
+  float32x4_t half = vbslq_f32(vcltq_f32(t, vdupq_n_f32(0)), vdupq_n_f32(-0.5f), vdupq_n_f32(0.5f));
+  int32x4_t q = vcvtq_s32_f32(vaddq_f32(t, half));
+
+  float32x4_t r = vsubq_f32(deg, vmulq_f32(vcvtq_f32_s32(q), vdupq_n_f32(90.f)));
+  r = vmulq_f32(r, vdupq_n_f32(M_PI / 180.0));
+  float32x4_t r2 = vmulq_f32(r, r);
+
+  float32x4_t ps = vaddq_f32(vmulq_f32(vdupq_n_f32(S2D_SIN_C3), r2), vdupq_n_f32(S2D_SIN_C2));
+  ps = vaddq_f32(vmulq_f32(ps, r2), vdupq_n_f32(S2D_SIN_C1));
+  ps = vaddq_f32(vmulq_f32(vmulq_f32(ps, r2), r), r);
+
+  float32x4_t pc = vaddq_f32(vmulq_f32(vdupq_n_f32(S2D_COS_C3), r2), vdupq_n_f32(S2D_COS_C2));
+  pc = vaddq_f32(vmulq_f32(pc, r2), vdupq_n_f32(S2D_COS_C1));
+  pc = vmulq_f32(vmulq_f32(pc, r2), r2);
+  pc = vaddq_f32(vsubq_f32(pc, vmulq_f32(r2, vdupq_n_f32(0.5f))), vdupq_n_f32(1.f));
+
+  uint32x4_t swap = vceqq_s32(vandq_s32(q, vdupq_n_s32(1)), vdupq_n_s32(1));
+  uint32x4_t sin_sign = vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(q, vdupq_n_s32(2)), 30));
+  uint32x4_t cos_sign = vreinterpretq_u32_s32(vshlq_n_s32(
+    vandq_s32(vaddq_s32(q, vdupq_n_s32(1)), vdupq_n_s32(2)), 30));
+
+  *s = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, pc, ps)), sin_sign));
+  *c = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(vbslq_f32(swap, ps, pc)), cos_sign));
+}
+
+
+/*
+ * Transpose 4 vectors of 4 quads into 4 values of each quad
+ */
+static inline void S2D_TransposeNEON(float32x4_t a, float32x4_t b,
+                                     float32x4_t c, float32x4_t d, float32x4_t out[4]) {
+  float32x4x2_t ab = vzipq_f32(a, b);
+  float32x4x2_t cd = vzipq_f32(c, d);
+  out[0] = vcombine_f32(vget_low_f32(ab.val[0]),  vget_low_f32(cd.val[0]));
+  out[1] = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+  out[2] = vcombine_f32(vget_low_f32(ab.val[1]),  vget_low_f32(cd.val[1]));
+  out[3] = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+
+
+/*
+ * Transform quads 4 at a time with NEON
+ */
+static void S2D_QuadCornersNEON(const S2D_QuadArrays *q, int first, int last,
+                                float *corners) {
+  int i = first;
+
+  for (; i + 4 <= last; i += 4) {
+    float32x4_t sa, ca;
+    S2D_SinCosNEON(vld1q_f32(q->rotate + i), &sa, &ca);
+
+    float32x4_t rx = vld1q_f32(q->rx + i), ry = vld1q_f32(q->ry + i);
+    float32x4_t x = vld1q_f32(q->x + i), y = vld1q_f32(q->y + i);
+    float32x4_t dx1 = vsubq_f32(x, rx), dx2 = vsubq_f32(vaddq_f32(x, vld1q_f32(q->width + i)), rx);
+    float32x4_t dy1 = vsubq_f32(y, ry), dy2 = vsubq_f32(vaddq_f32(y, vld1q_f32(q->height + i)), ry);
+
+    float32x4_t xc1 = vmulq_f32(dx1, ca), xs1 = vmulq_f32(dx1, sa);
+    float32x4_t xc2 = vmulq_f32(dx2, ca), xs2 = vmulq_f32(dx2, sa);
+    float32x4_t yc1 = vmulq_f32(dy1, ca), ys1 = vmulq_f32(dy1, sa);
+    float32x4_t yc2 = vmulq_f32(dy2, ca), ys2 = vmulq_f32(dy2, sa);
+
+    // Each corner's x and y, for the 4 quads
+    float32x4_t lo[4], hi[4];
+    S2D_TransposeNEON(vaddq_f32(vsubq_f32(xc1, ys1), rx), vaddq_f32(vaddq_f32(xs1, yc1), ry),
+                      vaddq_f32(vsubq_f32(xc2, ys1), rx), vaddq_f32(vaddq_f32(xs2, yc1), ry), lo);
+    S2D_TransposeNEON(vaddq_f32(vsubq_f32(xc2, ys2), rx), vaddq_f32(vaddq_f32(xs2, yc2), ry),
+                      vaddq_f32(vsubq_f32(xc1, ys2), rx), vaddq_f32(vaddq_f32(xs1, yc2), ry), hi);
+
+    float *out = corners + (size_t)i * 8;
+    for (int k = 0; k < 4; k++) {
+      vst1q_f32(out + k * 8,     lo[k]);
+      vst1q_f32(out + k * 8 + 4, hi[k]);
+    }
+  }
+
+  S2D_QuadCornersScalar(q, i, last, corners);
+}
+
+#endif
+
+
+/*
+ * Check if the CPU can run a quad kernel
+ */
+static bool S2D_HasQuadKernel(int k) {
+  switch (k) {
+    case S2D_KERNEL_SCALAR: return true;
+  #if S2D_X86
+    case S2D_KERNEL_SSE:    return SDL_HasSSE2();
+    case S2D_KERNEL_AVX2:   return SDL_HasAVX2();
+  #endif
+  #if S2D_NEON
+    case S2D_KERNEL_NEON:   return SDL_HasNEON();
+  #endif
+    default: return false;
+  }
+}
+
+
+/*
+ * Choose the kernel for `S2D_TransformQuads`, or the fastest the CPU can run
+ * with `S2D_KERNEL_AUTO`. Returns false if the CPU can't run it.
+ */
+bool S2D_SetQuadKernel(int k) {
+  if (k == S2D_KERNEL_AUTO) {
+    k = S2D_KERNEL_SCALAR;
+    for (int i = S2D_KERNEL_COUNT - 1; i > S2D_KERNEL_SCALAR; i--) {
+      if (S2D_HasQuadKernel(i)) { k = i; break; }
+    }
+  }
+
+  if (!S2D_HasQuadKernel(k)) return false;
+
+  switch (k) {
+  #if S2D_X86
+    case S2D_KERNEL_SSE:  kernel_func = S2D_QuadCornersSSE;  break;
+    case S2D_KERNEL_AVX2: kernel_func = S2D_QuadCornersAVX2; break;
+  #endif
+  #if S2D_NEON
+    case S2D_KERNEL_NEON: kernel_func = S2D_QuadCornersNEON; break;
+  #endif
+    default:              kernel_func = S2D_QuadCornersScalar; break;
+  }
+  kernel = k;
+  return true;
+}
+
+
+/*
+ * Get the kernel used by `S2D_TransformQuads`
+ */
+int S2D_GetQuadKernel() {
+  if (kernel < 0) S2D_SetQuadKernel(S2D_KERNEL_AUTO);
+  return kernel;
+}
+
+
+/*
+ * Get the name of a quad kernel
+ */
+const char *S2D_QuadKernelName(int k) {
+  switch (k) {
+    case S2D_KERNEL_SCALAR: return "scalar";
+    case S2D_KERNEL_SSE:    return "SSE2";
+    case S2D_KERNEL_AVX2:   return "AVX2";
+    case S2D_KERNEL_NEON:   return "NEON";
+    default:                return "unknown";
+  }
+}
+
+
+/*
+ * Get the corners of quads rotated around their points
+ */
+void S2D_TransformQuads(const S2D_QuadArrays *quads, int count, GLfloat *corners) {
+  if (!kernel_func) S2D_SetQuadKernel(S2D_KERNEL_AUTO);
+  kernel_func(quads, 0, count, corners);
+}
@@ -45,12 +45,371 @@ S2D_Window *S2D_CreateWindow(const char *title, int width, int height,
   window->icon            = NULL;
   window->close           = true;
   window->deltaTime       = 0.0;
+  window->fixed_timestep  = false;
+  window->update_rate     = 60;
+  window->alpha           = 0.0;
+  window->frame_ring      = NULL;
+  window->stats_path      = NULL;
+  window->key_names       = true;
+  window->input_callbacks = true;
+  window->record_path     = NULL;
+  window->replay_path     = NULL;
+  window->replay          = NULL;
+  window->headless        = false;
+  window->max_frames      = 0;
+  window->culling         = true;
+  window->sorted_draws    = false;
+  window->render_thread   = false;
+  window->render_stats    = (S2D_RenderStats){ 0, 0, 0 };
 
   // Return the window structure
   return window;
 }
 
 
+/*
+ * Handle input and window events, calling the window's callbacks, and clearing
+ * keys and buttons pressed or released before if `clear_edges`
+ */
+static void S2D_HandleEvents(S2D_Window *window, bool clear_edges) {
+
+  int mx, my;  // mouse x, y coordinates
+
+  bool replaying = window->replay && window->replay->playing;
+
+  // Keys and buttons pressed last frame are no longer new
+  if (clear_edges) S2D_BeginInputFrame();
+
+  SDL_Event e;
+  while (SDL_PollEvent(&e)) {
+
+    // Input comes from the replay file instead
+    if (replaying && e.type != SDL_QUIT && e.type != SDL_WINDOWEVENT) continue;
+
+    switch (e.type) {
+
+      case SDL_KEYDOWN:
+        if (e.key.repeat == 0) {
+          S2D_Event event = {
+            .type = S2D_KEY_DOWN, .scancode = e.key.keysym.scancode
+          };
+          S2D_DispatchInput(window, S2D_KEYBOARD, event);
+        }
+        break;
+
+      case SDL_KEYUP: {
+        S2D_Event event = {
+          .type = S2D_KEY_UP, .scancode = e.key.keysym.scancode
+        };
+        S2D_DispatchInput(window, S2D_KEYBOARD, event);
+        break;
+      }
+
+      case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP: {
+        S2D_GetMouseOnViewport(window, e.button.x, e.button.y, &mx, &my);
+        S2D_Event event = {
+          .button = e.button.button, .x = mx, .y = my
+        };
+        event.type = e.type == SDL_MOUSEBUTTONDOWN ? S2D_MOUSE_DOWN : S2D_MOUSE_UP;
+        event.dblclick = e.button.clicks == 2 ? true : false;
+        S2D_DispatchInput(window, S2D_MOUSE, event);
+        break;
+      }
+
+      case SDL_MOUSEWHEEL: {
+        S2D_Event event = {
+          .type = S2D_MOUSE_SCROLL, .direction = e.wheel.direction,
+          .delta_x = e.wheel.x, .delta_y = -e.wheel.y
+        };
+        S2D_DispatchInput(window, S2D_MOUSE, event);
+        break;
+      }
+
+      case SDL_MOUSEMOTION:
+        if ((window->on_mouse && window->input_callbacks) || window->replay) {
+          S2D_GetMouseOnViewport(window, e.motion.x, e.motion.y, &mx, &my);
+          S2D_Event event = {
+            .type = S2D_MOUSE_MOVE,
+            .x = mx, .y = my, .delta_x = e.motion.xrel, .delta_y = e.motion.yrel
+          };
+          S2D_DispatchInput(window, S2D_MOUSE, event);
+        }
+        break;
+
+      case SDL_CONTROLLERAXISMOTION: {
+        S2D_Event event = {
+          .which = e.caxis.which, .type = S2D_AXIS,
+          .axis = e.caxis.axis, .value = e.caxis.value
+        };
+        S2D_DispatchInput(window, S2D_CONTROLLER, event);
+        break;
+      }
+
+      case SDL_JOYAXISMOTION:
+        if (!S2D_IsController(e.jbutton.which)) {
+          S2D_Event event = {
+            .which = e.jaxis.which, .type = S2D_AXIS,
+            .axis = e.jaxis.axis, .value = e.jaxis.value
+          };
+          S2D_DispatchInput(window, S2D_CONTROLLER, event);
+        }
+        break;
+
+      case SDL_CONTROLLERBUTTONDOWN: case SDL_CONTROLLERBUTTONUP: {
+        S2D_Event event = {
+          .which = e.cbutton.which, .button = e.cbutton.button
+        };
+        event.type = e.type == SDL_CONTROLLERBUTTONDOWN ? S2D_BUTTON_DOWN : S2D_BUTTON_UP;
+        S2D_DispatchInput(window, S2D_CONTROLLER, event);
+        break;
+      }
+
+      case SDL_JOYBUTTONDOWN: case SDL_JOYBUTTONUP:
+        if (!S2D_IsController(e.jbutton.which)) {
+          S2D_Event event = {
+            .which = e.jbutton.which, .button = e.jbutton.button
+          };
+          event.type = e.type == SDL_JOYBUTTONDOWN ? S2D_BUTTON_DOWN : S2D_BUTTON_UP;
+          S2D_DispatchInput(window, S2D_CONTROLLER, event);
+        }
+        break;
+
+      case SDL_JOYDEVICEADDED:
+        S2D_Log(S2D_INFO, "Controller connected (%i total)", SDL_NumJoysticks());
+        S2D_OpenControllers();
+        break;
+
+      case SDL_JOYDEVICEREMOVED:
+        S2D_RemoveControllerState(e.jdevice.which);
+        if (S2D_IsController(e.jdevice.which)) {
+          S2D_Log(S2D_INFO, "Controller #%i: %s removed (%i remaining)", e.jdevice.which, SDL_GameControllerName(SDL_GameControllerFromInstanceID(e.jdevice.which)), SDL_NumJoysticks());
+          SDL_GameControllerClose(SDL_GameControllerFromInstanceID(e.jdevice.which));
+        } else {
+          S2D_Log(S2D_INFO, "Controller #%i: %s removed (%i remaining)", e.jdevice.which, SDL_JoystickName(SDL_JoystickFromInstanceID(e.jdevice.which)), SDL_NumJoysticks());
+          SDL_JoystickClose(SDL_JoystickFromInstanceID(e.jdevice.which));
+        }
+        break;
+
+      case SDL_WINDOWEVENT:
+        switch (e.window.event) {
+          case SDL_WINDOWEVENT_RESIZED:
+            // Store new window size, set viewport
+            window->width  = e.window.data1;
+            window->height = e.window.data2;
+            S2D_GL_SetViewport(window);
+            break;
+        }
+        break;
+
+      case SDL_QUIT:
+        S2D_Close(window);
+        break;
+    }
+  }
+
+  if (replaying) S2D_ReadReplayFrame(window);
+
+  // Send events for keys held down
+  if (window->on_key && window->input_callbacks) {
+    const int *held;
+    int num_held = S2D_GetHeldKeys(&held);
+    for (int i = 0; i < num_held; i++) {
+      S2D_Event event = {
+        .type = S2D_KEY_HELD, .scancode = held[i],
+        .key = window->key_names ? SDL_GetScancodeName(held[i]) : NULL
+      };
+      window->on_key(event);
+    }
+  }
+
+  // Get and store mouse position relative to the viewport, unless replayed
+  if (!replaying) {
+    int wx, wy;  // mouse x, y coordinates relative to the window
+    SDL_GetMouseState(&wx, &wy);
+    S2D_GetMouseOnViewport(window, wx, wy, &window->mouse.x, &window->mouse.y);
+  }
+}
+
+
+/*
+ * Initialize video for a headless window, using SDL's offscreen driver which
+ * creates contexts with EGL and needs no display. If it's not available (it
+ * was added in SDL 2.0.22), use the default driver and a hidden window.
+ */
+static void S2D_InitHeadlessVideo() {
+
+  if (SDL_WasInit(SDL_INIT_VIDEO)) {
+    const char *driver = SDL_GetCurrentVideoDriver();
+    if (driver && strcmp(driver, "offscreen") == 0) return;
+    SDL_QuitSubSystem(SDL_INIT_VIDEO);
+  }
+
+  SDL_setenv("SDL_VIDEODRIVER", "offscreen", 1);
+  if (SDL_InitSubSystem(SDL_INIT_VIDEO) == 0) {
+    S2D_Log(S2D_INFO, "Using the offscreen video driver");
+    return;
+  }
+
+  S2D_Log(S2D_WARN, "Offscreen video driver not available, using a hidden window");
+  SDL_setenv("SDL_VIDEODRIVER", "", 1);
+  if (SDL_InitSubSystem(SDL_INIT_VIDEO) != 0) {
+    S2D_Error("SDL_InitSubSystem", SDL_GetError());
+  }
+}
+
+
+/*
+ * Present the frame, or just submit it if headless
+ */
+static void S2D_SwapWindow(S2D_Window *window) {
+  if (window->headless) {
+    glFlush();
+  } else {
+    SDL_GL_SwapWindow(window->sdl);
+  }
+}
+
+
+/*
+ * Draw the queued frame and present it, on the render thread
+ */
+void S2D_PresentFrame(S2D_Window *window) {
+  S2D_GL_FlushBuffers();
+  S2D_UpdateCapture(window);
+  S2D_SwapWindow(window);
+}
+
+
+/*
+ * Draw the frame and present it, timing the flush and swap, or hand it to the
+ * render thread if there is one
+ */
+static void S2D_FinishFrame(S2D_Window *window, Uint64 t[S2D_STAGE_COUNT]) {
+
+  t[S2D_STAGE_FLUSH] = SDL_GetPerformanceCounter();
+
+  // Only waits for the frame before to be drawn
+  if (S2D_RecordingFrame()) {
+    S2D_SubmitFrame(window);
+    t[S2D_STAGE_SWAP] = t[S2D_STAGE_FRAME] = SDL_GetPerformanceCounter();
+    return;
+  }
+
+  // Render and flush all OpenGL buffers
+  S2D_GL_FlushBuffers();
+  S2D_GL_EndFrame(window);
+  S2D_UpdateCapture(window);
+
+  // Swap buffers to display drawn contents in the window
+  t[S2D_STAGE_SWAP] = SDL_GetPerformanceCounter();
+  S2D_SwapWindow(window);
+  t[S2D_STAGE_FRAME] = SDL_GetPerformanceCounter();
+}
+
+
+/*
+ * Main loop using high-resolution timing, calling `update` at a fixed rate and
+ * `render` once per frame with `alpha` set for interpolating between updates
+ */
+static void S2D_RunFixedTimestep(S2D_Window *window) {
+
+  const double freq = (double)SDL_GetPerformanceFrequency();
+  const double max_frame = 0.25;  // longest frame simulated, in seconds
+  const int max_updates = 8;      // most updates caught up on in one frame
+
+  int update_rate = window->update_rate > 0 ? window->update_rate : 60;
+  double step = 1.0 / update_rate;
+  Uint64 frame_ticks = window->fps_cap > 0 ? (Uint64)(freq / window->fps_cap) : 0;
+  bool replaying = window->replay && window->replay->playing;
+  if (replaying || window->headless) frame_ticks = 0;  // run as fast as possible
+  Uint64 spin_ticks = (Uint64)(freq * 0.002);  // time to spin instead of sleep
+
+  Uint64 start = SDL_GetPerformanceCounter();
+  Uint64 last = start;
+  Uint64 next_frame = start + frame_ticks;
+  double accumulator = 0;
+  double frame_avg = 1.0 / (window->fps_cap > 0 ? window->fps_cap : 60);
+  Uint32 frames = 0;
+
+  window->deltaTime = (float)step;
+
+  // Whether an update has seen the keys and buttons pressed or released
+  bool edges_seen = true;
+
+  while (!window->close) {
+
+    S2D_GL_Clear(window->background);
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    double frame_time = (now - last) / freq;
+    last = now;
+
+    // Don't try to catch up after a stall, like the window being dragged
+    if (frame_time > max_frame) frame_time = max_frame;
+
+    // Smooth the frame rate with an exponential moving average
+    frame_avg = 0.9 * frame_avg + 0.1 * frame_time;
+
+    // Keep input from frames with no updates until one runs
+    S2D_HandleEvents(window, edges_seen);
+
+    // Replays use the recorded frame times, so the same updates are run
+    if (replaying) frame_time = window->replay->dt;
+    else if (window->replay) S2D_WriteReplayFrame(window, frame_time);
+    accumulator += frame_time;
+
+    frames++;
+    window->frames     = frames;
+    window->elapsed_ms = (Uint32)((now - start) * 1000 / freq);
+    window->fps        = frame_avg > 0 ? 1.0 / frame_avg : 0;
+
+    // Advance the simulation in fixed steps
+    Uint64 t[S2D_STAGE_COUNT];
+    t[S2D_STAGE_UPDATE] = SDL_GetPerformanceCounter();
+    int updates = 0;
+    while (accumulator >= step && updates < max_updates) {
+      // Keys and buttons pressed are new only to the first update seeing them
+      if (updates > 0) S2D_BeginInputFrame();
+      if (window->update) window->update(window->on_UpdateArgs);
+      accumulator -= step;
+      updates++;
+    }
+    if (accumulator >= step) accumulator = fmod(accumulator, step);
+    edges_seen = updates > 0;
+
+    window->alpha = accumulator / step;
+    t[S2D_STAGE_RENDER] = SDL_GetPerformanceCounter();
+    if (window->render) window->render();
+
+    S2D_FinishFrame(window, t);
+    S2D_RecordFrame(window, t);
+
+    if (window->max_frames && frames >= window->max_frames) S2D_Close(window);
+
+    // Wait until the next frame is due, sleeping for most of the wait and
+    // spinning for the rest, since sleeps can overshoot by a millisecond or two
+    Uint64 end = SDL_GetPerformanceCounter();
+    window->loop_ms = (Uint32)((end - now) * 1000 / freq);
+    window->delay_ms = 0;
+
+    if (frame_ticks == 0) continue;
+
+    if (end >= next_frame) {
+      // Running behind, so start pacing again from now
+      next_frame = end + frame_ticks;
+      continue;
+    }
+    if (next_frame - end > spin_ticks) {
+      SDL_Delay((Uint32)((next_frame - end - spin_ticks) * 1000 / freq));
+    }
+    while (SDL_GetPerformanceCounter() < next_frame);
+
+    window->delay_ms = (Uint32)((next_frame - end) * 1000 / freq);
+    next_frame += frame_ticks;
+  }
+}
+
+
 /*
  * Show the window
  */
@@ -61,12 +420,19 @@ int S2D_Show(S2D_Window *window) {
     return 1;
   }
 
+  // Headless windows are never shown, and render to a framebuffer instead
+  int flags = window->flags;
+  if (window->headless) {
+    S2D_InitHeadlessVideo();
+    flags = (flags | SDL_WINDOW_HIDDEN) & ~(SDL_WINDOW_FULLSCREEN | SDL_WINDOW_RESIZABLE);
+  }
+
   // Create SDL window
   window->sdl = SDL_CreateWindow(
     window->title,                                   // title
     SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,  // window position
     window->width, window->height,                   // window size
-    SDL_WINDOW_OPENGL | window->flags                // flags
+    SDL_WINDOW_OPENGL | flags                        // flags
   );
 
   if (!window->sdl) S2D_Error("SDL_CreateWindow", SDL_GetError());
@@ -100,8 +466,6 @@ int S2D_Show(S2D_Window *window) {
 
   // Set Main Loop Data ////////////////////////////////////////////////////////
 
-  const Uint8 *key_state;
-
   Uint32 frames = 0;           // Total frames since start
   Uint32 frames_last_sec = 0;  // Frames in the last second
   Uint32 start_ms = SDL_GetTicks();  // Elapsed time since start
@@ -123,6 +487,33 @@ int S2D_Show(S2D_Window *window) {
 
   window->close = false;
 
+  // Keep times of recent frames
+  if (!window->frame_ring) {
+    window->frame_ring = (S2D_FrameRing *) calloc(1, sizeof(S2D_FrameRing));
+    if (!window->frame_ring) S2D_Log(S2D_WARN, "Frame stats disabled, out of memory");
+  }
+
+  // Record or replay input
+  bool replaying = false;
+  if (window->record_path || window->replay_path) {
+    replaying = S2D_OpenReplay(window) && window->replay->playing;
+    if (replaying) SDL_GL_SetSwapInterval(0);
+  }
+  if (window->headless) SDL_GL_SetSwapInterval(0);
+
+  // Draw frames on another thread while the next is made
+  if (window->render_thread) S2D_StartRenderThread(window);
+
+  if (window->fixed_timestep) {
+    S2D_RunFixedTimestep(window);
+    S2D_StopRenderThread(window);
+    S2D_StopCapture(window);
+    S2D_FinishCaptures();
+    S2D_CloseReplay(window);
+    if (window->stats_path) S2D_DumpFrameStats(window, window->stats_path);
+    return 0;
+  }
+
   // Main Loop /////////////////////////////////////////////////////////////////
 
   while (!window->close) {
@@ -148,7 +539,7 @@ int S2D_Show(S2D_Window *window) {
     loop_ms = end_ms - begin_ms;
     delay_ms = (1000 / window->fps_cap) - loop_ms;
 
-    if (delay_ms < 0) delay_ms = 0;
+    if (delay_ms < 0 || replaying || window->headless) delay_ms = 0;
 
     // Note: `loop_ms + delay_ms` should equal `1000 / fps_cap`
 
@@ -157,154 +548,7 @@ int S2D_Show(S2D_Window *window) {
 
     // Handle Input and Window Events //////////////////////////////////////////
 
-    int mx, my;  // mouse x, y coordinates
-
-    SDL_Event e;
-    while (SDL_PollEvent(&e)) {
-      switch (e.type) {
-
-        case SDL_KEYDOWN:
-          if (window->on_key && e.key.repeat == 0) {
-            S2D_Event event = {
-              .type = S2D_KEY_DOWN, .key = SDL_GetScancodeName(e.key.keysym.scancode)
-            };
-            window->on_key(event);
-          }
-          break;
-
-        case SDL_KEYUP:
-          if (window->on_key) {
-            S2D_Event event = {
-              .type = S2D_KEY_UP, .key = SDL_GetScancodeName(e.key.keysym.scancode)
-            };
-            window->on_key(event);
-          }
-          break;
-
-        case SDL_MOUSEBUTTONDOWN: case SDL_MOUSEBUTTONUP:
-          if (window->on_mouse) {
-            S2D_GetMouseOnViewport(window, e.button.x, e.button.y, &mx, &my);
-            S2D_Event event = {
-              .button = e.button.button, .x = mx, .y = my
-            };
-            event.type = e.type == SDL_MOUSEBUTTONDOWN ? S2D_MOUSE_DOWN : S2D_MOUSE_UP;
-            event.dblclick = e.button.clicks == 2 ? true : false;
-            window->on_mouse(event);
-          }
-          break;
-
-        case SDL_MOUSEWHEEL:
-          if (window->on_mouse) {
-            S2D_Event event = {
-              .type = S2D_MOUSE_SCROLL, .direction = e.wheel.direction,
-              .delta_x = e.wheel.x, .delta_y = -e.wheel.y
-            };
-            window->on_mouse(event);
-          }
-          break;
-
-        case SDL_MOUSEMOTION:
-          if (window->on_mouse) {
-            S2D_GetMouseOnViewport(window, e.motion.x, e.motion.y, &mx, &my);
-            S2D_Event event = {
-              .type = S2D_MOUSE_MOVE,
-              .x = mx, .y = my, .delta_x = e.motion.xrel, .delta_y = e.motion.yrel
-            };
-            window->on_mouse(event);
-          }
-          break;
-
-        case SDL_CONTROLLERAXISMOTION:
-          if (window->on_controller) {
-            S2D_Event event = {
-              .which = e.caxis.which, .type = S2D_AXIS,
-              .axis = e.caxis.axis, .value = e.caxis.value
-            };
-            window->on_controller(event);
-          }
-          break;
-
-        case SDL_JOYAXISMOTION:
-          if (window->on_controller && !S2D_IsController(e.jbutton.which)) {
-            S2D_Event event = {
-              .which = e.jaxis.which, .type = S2D_AXIS,
-              .axis = e.jaxis.axis, .value = e.jaxis.value
-            };
-            window->on_controller(event);
-          }
-          break;
-
-        case SDL_CONTROLLERBUTTONDOWN: case SDL_CONTROLLERBUTTONUP:
-          if (window->on_controller) {
-            S2D_Event event = {
-              .which = e.cbutton.which, .button = e.cbutton.button
-            };
-            event.type = e.type == SDL_CONTROLLERBUTTONDOWN ? S2D_BUTTON_DOWN : S2D_BUTTON_UP;
-            window->on_controller(event);
-          }
-          break;
-
-        case SDL_JOYBUTTONDOWN: case SDL_JOYBUTTONUP:
-          if (window->on_controller && !S2D_IsController(e.jbutton.which)) {
-            S2D_Event event = {
-              .which = e.jbutton.which, .button = e.jbutton.button
-            };
-            event.type = e.type == SDL_JOYBUTTONDOWN ? S2D_BUTTON_DOWN : S2D_BUTTON_UP;
-            window->on_controller(event);
-          }
-          break;
-
-        case SDL_JOYDEVICEADDED:
-          S2D_Log(S2D_INFO, "Controller connected (%i total)", SDL_NumJoysticks());
-          S2D_OpenControllers();
-          break;
-
-        case SDL_JOYDEVICEREMOVED:
-          if (S2D_IsController(e.jdevice.which)) {
-            S2D_Log(S2D_INFO, "Controller #%i: %s removed (%i remaining)", e.jdevice.which, SDL_GameControllerName(SDL_GameControllerFromInstanceID(e.jdevice.which)), SDL_NumJoysticks());
-            SDL_GameControllerClose(SDL_GameControllerFromInstanceID(e.jdevice.which));
-          } else {
-            S2D_Log(S2D_INFO, "Controller #%i: %s removed (%i remaining)", e.jdevice.which, SDL_JoystickName(SDL_JoystickFromInstanceID(e.jdevice.which)), SDL_NumJoysticks());
-            SDL_JoystickClose(SDL_JoystickFromInstanceID(e.jdevice.which));
-          }
-          break;
-
-        case SDL_WINDOWEVENT:
-          switch (e.window.event) {
-            case SDL_WINDOWEVENT_RESIZED:
-              // Store new window size, set viewport
-              window->width  = e.window.data1;
-              window->height = e.window.data2;
-              S2D_GL_SetViewport(window);
-              break;
-          }
-          break;
-
-        case SDL_QUIT:
-          S2D_Close(window);
-          break;
-      }
-    }
-
-    // Detect keys held down
-    int num_keys;
-    key_state = SDL_GetKeyboardState(&num_keys);
-
-    for (int i = 0; i < num_keys; i++) {
-      if (window->on_key) {
-        if (key_state[i] == 1) {
-          S2D_Event event = {
-            .type = S2D_KEY_HELD, .key = SDL_GetScancodeName(i)
-          };
-          window->on_key(event);
-        }
-      }
-    }
-
-    // Get and store mouse position relative to the viewport
-    int wx, wy;  // mouse x, y coordinates relative to the window
-    SDL_GetMouseState(&wx, &wy);
-    S2D_GetMouseOnViewport(window, wx, wy, &window->mouse.x, &window->mouse.y);
+    S2D_HandleEvents(window, true);
 
     // Update Window State /////////////////////////////////////////////////////
 
@@ -316,19 +560,31 @@ int S2D_Show(S2D_Window *window) {
     window->fps        = fps;
     window->deltaTime  = (float)(1/fps) * 100;
 
-    // Call update and render callbacks
+    // Replays use the recorded delta times
+    if (replaying) window->deltaTime = window->replay->dt;
+    else if (window->replay) S2D_WriteReplayFrame(window, window->deltaTime);
+
+    // Call update and render callbacks, timing each stage of the frame
+    Uint64 t[S2D_STAGE_COUNT];
+    t[S2D_STAGE_UPDATE] = SDL_GetPerformanceCounter();
     if (window->update) window->update(window->on_UpdateArgs);
+    t[S2D_STAGE_RENDER] = SDL_GetPerformanceCounter();
     if (window->render) window->render();
 
     // Draw Frame //////////////////////////////////////////////////////////////
 
-    // Render and flush all OpenGL buffers
-    S2D_GL_FlushBuffers();
+    S2D_FinishFrame(window, t);
+    S2D_RecordFrame(window, t);
 
-    // Swap buffers to display drawn contents in the window
-    SDL_GL_SwapWindow(window->sdl);
+    if (window->max_frames && frames >= window->max_frames) S2D_Close(window);
   }
 
+  S2D_StopRenderThread(window);
+  S2D_StopCapture(window);
+  S2D_FinishCaptures();
+  S2D_CloseReplay(window);
+  if (window->stats_path) S2D_DumpFrameStats(window, window->stats_path);
+
   return 0;
 }
 
@@ -348,47 +604,54 @@ void S2D_SetIcon(S2D_Window *window, const char *icon) {
 }
 
 
+// Arguments of a screenshot taken on the render thread
+typedef struct {
+  S2D_Window *window;
+  const char *path;
+} S2D_ScreenshotArgs;
+
+static void S2D_CallScreenshot(void *args) {
+  S2D_ScreenshotArgs *a = (S2D_ScreenshotArgs *) args;
+  S2D_Screenshot(a->window, a->path);
+}
+
+
 /*
  * Take a screenshot of the window
  */
 void S2D_Screenshot(S2D_Window *window, const char *path) {
 
-  #if GLES
-    S2D_Error("S2D_Screenshot", "Not supported in OpenGL ES");
-  #else
-    // Create a surface the size of the window
-    SDL_Surface *surface = SDL_CreateRGBSurface(
-      SDL_SWSURFACE, window->width, window->height, 24,
-      0x000000FF, 0x0000FF00, 0x00FF0000, 0
-    );
-
-    // Grab the pixels from the front buffer, save to surface
-    glReadBuffer(GL_FRONT);
-    glReadPixels(0, 0, window->width, window->height, GL_RGB, GL_UNSIGNED_BYTE, surface->pixels);
-
-    // Flip image vertically
+  S2D_ScreenshotArgs args = { window, path };
+  if (S2D_InvokeRenderCall(S2D_CallScreenshot, &args)) return;
 
-    void *temp_row = (void *)malloc(surface->pitch);
-    if (!temp_row) {
-      S2D_Error("S2D_Screenshot", "Out of memory!");
-      SDL_FreeSurface(surface);
-      return;
-    }
-
-    int height_div_2 = (int) (surface->h * 0.5);
+  Uint8 *pixels = (Uint8 *) malloc((size_t)window->width * window->height * 4);
+  if (!pixels) {
+    S2D_Error("S2D_Screenshot", "Out of memory!");
+    return;
+  }
 
-    for (int index = 0; index < height_div_2; index++) {
-      memcpy((Uint8 *)temp_row,(Uint8 *)(surface->pixels) + surface->pitch * index, surface->pitch);
-      memcpy((Uint8 *)(surface->pixels) + surface->pitch * index, (Uint8 *)(surface->pixels) + surface->pitch * (surface->h - index-1), surface->pitch);
-      memcpy((Uint8 *)(surface->pixels) + surface->pitch * (surface->h - index-1), temp_row, surface->pitch);
+  // Grab the pixels from the front buffer. Headless windows aren't swapped,
+  // and OpenGL ES can only read the back buffer, so read what's been drawn
+  // so far instead.
+  #if GLES
+    S2D_GL_FlushBuffers();
+  #else
+    if (window->headless) {
+      S2D_GL_FlushBuffers();
+      glReadBuffer(GL_COLOR_ATTACHMENT0);
+    } else {
+      glReadBuffer(GL_FRONT);
     }
+  #endif
+  glReadPixels(0, 0, window->width, window->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 
-    free(temp_row);
-
-    // Save image to disk
-    IMG_SavePNG(surface, path);
-    SDL_FreeSurface(surface);
+  #if !GLES
+    glReadBuffer(window->headless ? GL_COLOR_ATTACHMENT0 : GL_BACK);
   #endif
+
+  // Flip and save image to disk
+  S2D_SavePixelsPNG(pixels, window->width, window->height, path);
+  free(pixels);
 }
 
 
@@ -409,8 +672,11 @@ int S2D_Close(S2D_Window *window) {
  */
 int S2D_FreeWindow(S2D_Window *window) {
   S2D_Close(window);
+  // Pooled framebuffers belong to the context
+  S2D_ClearRenderTargetPool();
   SDL_GL_DeleteContext(window->glcontext);
   SDL_DestroyWindow(window->sdl);
+  free(window->frame_ring);
   free(window);
   return 0;
 }
@@ -32,6 +32,124 @@ void end_test_suite() {
   printf("%i examples, %i failures\n\n", tests, failures);
 }
 
+int sorted_textures[8];
+int sorted_count = 0;
+
+void record_sorted_draw(S2D_DrawCommand *command, const GLfloat *data) {
+  sorted_textures[sorted_count++] = command->texture_id;
+}
+
+int job_sums[4];
+S2D_JobCounter first_jobs;
+bool ran_after_first = false;
+
+void sum_range(int first, int last, void *data) {
+  // Each range of 250 sums into its own slot, so workers never share one
+  for (int i = first; i < last; i++) job_sums[first / 250] += i;
+}
+
+void first_job(void *data) {
+  SDL_Delay(1);
+}
+
+void after_first_job(void *data) {
+  ran_after_first = SDL_AtomicGet(&first_jobs.count) == 0;
+}
+
+int frames_rendered = 0;
+S2D_Window *headless = NULL;
+
+void render_threaded() {
+  frames_rendered++;
+  S2D_DrawRect_XYWH(0, 0, 16, 16, (S2D_Color){ 1, 0, 0, 1 }, true);
+  S2D_DrawRect_XYWH(-100, -100, 16, 16, (S2D_Color){ 1, 0, 0, 1 }, true);
+}
+
+S2D_Text *threaded_text = NULL;
+
+// Change the text every frame, freeing its texture while the frame before may
+// not be drawn yet
+void render_threaded_text() {
+  frames_rendered++;
+  S2D_SetText(threaded_text, "Frame %i", frames_rendered);
+  S2D_DrawText(threaded_text);
+}
+
+S2D_Sprite *bulk_sprites[4];
+
+void render_sprites() {
+  S2D_DrawSprites(bulk_sprites, 4);
+}
+
+GLuint pooled_fbo = 0;
+bool target_reused = false;
+
+void render_count() {
+  frames_rendered++;
+  if (frames_rendered == 1) S2D_ScreenshotAsync(headless, "headless_test.png");
+
+  // Draw to a render target and free it, then to a new one of the same size
+  S2D_RenderTarget *target = S2D_CreateRenderTarget(32, 32);
+  S2D_BeginRenderTarget(target);
+  S2D_DrawRect_XYWH(0, 0, 16, 16, (S2D_Color){ 1, 0, 0, 1 }, true);
+  S2D_EndRenderTarget(target);
+  S2D_DrawRenderTarget(target);
+  if (frames_rendered > 1) target_reused = target->fbo == pooled_fbo;
+  pooled_fbo = target->fbo;
+  S2D_FreeRenderTarget(target);
+
+  // Out of view, so culled
+  S2D_DrawRect_XYWH(-100, -100, 10, 10, (S2D_Color){ 1, 1, 1, 1 }, true);
+}
+
+void render_shapes() {
+  S2D_Color c = { 1, 0.5, 0, 1 };
+  S2D_DrawDisc(16, 16, 8, c);
+  S2D_DrawRing(48, 16, 12, 2, c);
+  S2D_DrawArc(32, 48, 12, 4, 45, 270, c);
+  S2D_DrawDisc(-100, 32, 20, c);
+}
+
+void render_arrays() {
+  S2D_Vertex triangle[3] = {
+    { 0, 0, { 1, 0, 0, 1 } }, { 8, 0, { 0, 1, 0, 1 } }, { 0, 8, { 0, 0, 1, 1 } }
+  };
+  S2D_FRect rects[2] = { { 10, 10, 4, 4 }, { 1000, 10, 4, 4 } };
+  S2D_Vec2f points[4] = { { 0, 32 }, { 64, 32 }, { 5, 5 }, { 5, 5 } };
+  S2D_Color colors[2] = { { 1, 1, 1, 1 }, { 1, 1, 1, 1 } };
+  S2D_DrawTriangles(triangle, 3);
+  S2D_DrawRects(rects, colors, 2);
+  S2D_DrawLines(points, colors, 2, 2);
+}
+
+void render_smooth() {
+  S2D_Color c = { 1, 1, 1, 1 };
+  S2D_DrawSmoothLine(4, 4, 60, 40, 3, c);
+  S2D_DrawSmoothRect((S2D_FRect){ 10, 40, 20, 10 }, c);
+  S2D_DrawSmoothRect((S2D_FRect){ 1000, 40, 20, 10 }, c);
+}
+
+S2D_Vec2f polyline_points[5] = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 30, 5 }, { 20, 40 } };
+S2D_Polyline *corner_line, *whole_line, *appended_line;
+
+void render_polylines() {
+  S2D_DrawPolyline(corner_line);
+  S2D_DrawPolyline(whole_line);
+  S2D_DrawPolyline(appended_line);
+  S2D_AppendPolylinePoints(appended_line, &polyline_points[2], 3);
+  S2D_DrawPolyline(appended_line);
+}
+
+// Sum of the areas of triangles tessellating a polygon
+float triangles_area(const S2D_Vec2f *p, const int *indices, int triangles) {
+  float area = 0;
+  for (int i = 0; i < triangles * 3; i += 3) {
+    S2D_Vec2f a = p[indices[i]], b = p[indices[i + 1]], c = p[indices[i + 2]];
+    area += fabsf((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2;
+  }
+  return area;
+}
+
 
 int main() {
 
@@ -126,6 +244,50 @@ int main() {
   S2D_SetText(txt1, NULL);
   end_test(txt1 != NULL);
 
+  start_test("(S2D_SetText) unchanged text message skips re-rendering");
+  S2D_SetText(txt2, "Score: %d", 10);
+  Uint32 skipped = txt2->renders_skipped;
+  S2D_SetText(txt2, "Score: %d", 10);
+  S2D_SetText(txt2, "Score: %d", 20);
+  end_test(txt2->renders_skipped == skipped + 1 && strcmp(txt2->msg, "Score: 20") == 0);
+
+  start_test("(S2D_CreateSDFText) texts using the same font share a glyph atlas");
+  S2D_Text *sdf1 = S2D_CreateSDFText("media/bitstream_vera/vera.ttf", "Hello World", 20);
+  S2D_Text *sdf2 = S2D_CreateSDFText("media/bitstream_vera/vera.ttf", "Hello World", 40);
+  end_test(sdf1 != NULL && sdf2 != NULL && sdf1->sdf == sdf2->sdf && sdf2->width > sdf1->width);
+
+  start_test("(S2D_SetTextSize) resize SDF text without a new atlas");
+  S2D_SetTextSize(sdf1, 40);
+  end_test(sdf1->width == sdf2->width && sdf1->height == sdf2->height);
+
+  start_test("(S2D_CreateSDFText) bad font file path (expect error)");
+  S2D_Text *sdf3 = S2D_CreateSDFText("font.ttf", "Hello World", 20);
+  end_test(sdf3 == NULL);
+
+  S2D_FreeText(sdf1); S2D_FreeText(sdf2);
+
+  start_test("(S2D_CreateTextLayout) split UTF-8 text into paragraphs");
+  S2D_TextLayout *layout = S2D_CreateTextLayout("media/bitstream_vera/vera.ttf", 20, 0, S2D_ALIGN_LEFT);
+  S2D_SetLayoutText(layout, "a\nb\n\xC3\xA9t\xC3\xA9");
+  S2D_UpdateTextLayout(layout);
+  end_test(layout != NULL && layout->paragraph_count == 3 && layout->paragraphs_laid_out == 3 &&
+           layout->paragraphs[2].quad_count == 3);
+
+  start_test("(S2D_AppendLayoutText) only touched paragraphs are laid out again");
+  S2D_AppendLayoutText(layout, "d\n");
+  S2D_UpdateTextLayout(layout);
+  end_test(layout->paragraph_count == 4 && layout->paragraphs_laid_out == 5);
+
+  start_test("(S2D_SetLayoutStyle) wrap lines to a width");
+  S2D_SetLayoutText(layout, "the quick brown fox jumps over the lazy dog");
+  S2D_UpdateTextLayout(layout);
+  GLfloat unwrapped = layout->height;
+  S2D_SetLayoutStyle(layout, 20, 100, S2D_ALIGN_CENTER);
+  S2D_UpdateTextLayout(layout);
+  end_test(layout->paragraphs[0].lines > 1 && layout->height > unwrapped && layout->width <= 100);
+
+  S2D_FreeTextLayout(layout);
+
   start_test("(S2D_FreeText) free text");
   S2D_FreeText(txt1); S2D_FreeText(txt2); S2D_FreeText(txt3);
   S2D_FreeText(txt4); S2D_FreeText(txt5); S2D_FreeText(txt6);
@@ -186,10 +348,199 @@ int main() {
   S2D_FreeMusic(NULL);
   end_test(PASS);
 
+  // Geometry //////////////////////////////////////////////////////////////////
+
+  start_test("(S2D_BeginMesh) record shapes into one batch instead of drawing");
+  S2D_Mesh *mesh = S2D_CreateMesh();
+  S2D_BeginMesh(mesh);
+  S2D_DrawTriangle(0, 0, 1, 1, 1, 1, 10, 0, 1, 1, 1, 1, 0, 10, 1, 1, 1, 1);
+  S2D_DrawRect_XYWH(0, 0, 10, 20, (S2D_Color){ 1, 1, 1, 1 }, true);
+  S2D_EndMesh(mesh);
+  GLfloat mesh_x1 = 1000, mesh_y1 = 1000, mesh_x2 = -1000, mesh_y2 = -1000;
+  for (int i = 0; i < mesh->vertex_count; i++) {
+    mesh_x1 = fminf(mesh_x1, mesh->vertices[i * 8]);
+    mesh_y1 = fminf(mesh_y1, mesh->vertices[i * 8 + 1]);
+    mesh_x2 = fmaxf(mesh_x2, mesh->vertices[i * 8]);
+    mesh_y2 = fmaxf(mesh_y2, mesh->vertices[i * 8 + 1]);
+  }
+  end_test(mesh->vertex_count == 9 && mesh->batch_count == 1 &&
+           mesh_x1 == 0 && mesh_y1 == 0 && mesh_x2 == 10 && mesh_y2 == 20);
+  S2D_FreeMesh(mesh);
+
+  start_test("(S2D_GetUnitCircle) compute tables once for each number of sectors");
+  const GLfloat *unit = S2D_GetUnitCircle(12);
+  end_test(unit && unit == S2D_GetUnitCircle(12) && unit != S2D_GetUnitCircle(16) &&
+           unit[0] == unit[24] && unit[1] == unit[25] && fabsf(unit[6]) < 0.0001);
+
+  start_test("(S2D_TransformQuads) SIMD kernels match the scalar kernel");
+  GLfloat qx[11], qy[11], qw[11], qh[11], qa[11], qrx[11], qry[11];
+  GLfloat expected[11 * 8], corners[11 * 8];
+  for (int i = 0; i < 11; i++) {
+    qx[i] = i * 50; qy[i] = 20; qw[i] = 16 + i; qh[i] = 8;
+    qa[i] = i * 97 - 300; qrx[i] = qx[i] + 4; qry[i] = 30;
+  }
+  S2D_QuadArrays quads = { qx, qy, qw, qh, qa, qrx, qry };
+  S2D_SetQuadKernel(S2D_KERNEL_SCALAR);
+  S2D_TransformQuads(&quads, 11, expected);
+  bool kernels_match = true;
+  for (int k = S2D_KERNEL_SCALAR + 1; k < S2D_KERNEL_COUNT; k++) {
+    if (!S2D_SetQuadKernel(k)) continue;
+    S2D_TransformQuads(&quads, 11, corners);
+    for (int i = 0; i < 11 * 8; i++) {
+      if (fabsf(corners[i] - expected[i]) > 0.001) kernels_match = false;
+    }
+  }
+  S2D_SetQuadKernel(S2D_KERNEL_AUTO);
+  end_test(kernels_match);
+
+  start_test("(S2D_TessellatePolygon) clip the ears of a small concave polygon");
+  S2D_Vec2f u_shape[8] = {
+    { 0, 0 }, { 30, 0 }, { 30, 20 }, { 20, 20 }, { 20, 10 }, { 10, 10 }, { 10, 20 }, { 0, 20 }
+  };
+  int u_indices[6 * 3];
+  int u_triangles = S2D_TessellatePolygon(u_shape, 8, u_indices);
+  end_test(u_triangles == 6 && fabsf(triangles_area(u_shape, u_indices, 6) - 500) < 0.001);
+
+  start_test("(S2D_TessellatePolygon) split a large polygon into monotone pieces");
+  S2D_Vec2f comb[103];
+  int comb_indices[101 * 3];
+  for (int i = 0; i < 50; i++) {
+    comb[i * 2] = (S2D_Vec2f){ i * 10, 0 };
+    comb[i * 2 + 1] = (S2D_Vec2f){ i * 10 + 5, -100 };
+  }
+  comb[100] = (S2D_Vec2f){ 500, 0 };
+  comb[101] = (S2D_Vec2f){ 500, 50 };
+  comb[102] = (S2D_Vec2f){ 0, 50 };
+  int comb_triangles = S2D_TessellatePolygon(comb, 103, comb_indices);
+  end_test(comb_triangles == 101 &&
+           fabsf(triangles_area(comb, comb_indices, 101) - 50000) < 0.1);
+
+  // Draws /////////////////////////////////////////////////////////////////////
+
+  start_test("(S2D_SubmitDraws) sort by layer, then shader and texture");
+  S2D_SetDrawLayer(1, 0);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 7);
+  S2D_SetDrawLayer(0, 0);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 2);
+  S2D_QueueDraw(S2D_DRAW_TRIANGLE, 0);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 1);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 2);
+  S2D_SubmitDraws(record_sorted_draw, true);
+  S2D_SubmitDraws(record_sorted_draw, true);
+  end_test(sorted_count == 5 &&
+           sorted_textures[0] == 0 && sorted_textures[1] == 1 &&
+           sorted_textures[2] == 2 && sorted_textures[3] == 2 &&
+           sorted_textures[4] == 7);
+
+  start_test("(S2D_SubmitDraws) sort draws between calls, not across them");
+  sorted_count = 0;
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 4);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 3);
+  S2D_QueueDraw(S2D_DRAW_CALL, 0);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 2);
+  S2D_QueueDraw(S2D_DRAW_TEXTURE, 1);
+  S2D_SubmitDraws(record_sorted_draw, true);
+  end_test(sorted_count == 5 &&
+           sorted_textures[0] == 3 && sorted_textures[1] == 4 &&
+           sorted_textures[2] == 0 && sorted_textures[3] == 1 &&
+           sorted_textures[4] == 2);
+
+  // Jobs //////////////////////////////////////////////////////////////////////
+
+  start_test("(S2D_ParallelFor) call the function for every index once");
+  S2D_ParallelFor(1000, 250, sum_range, NULL);
+  end_test(job_sums[0] + job_sums[1] + job_sums[2] + job_sums[3] == 999 * 1000 / 2);
+
+  start_test("(S2D_RunJobAfter) run a job once the jobs it depends on are done");
+  S2D_JobCounter after_jobs = { { 0 } };
+  for (int i = 0; i < 4; i++) S2D_RunJob(first_job, NULL, &first_jobs);
+  S2D_RunJobAfter(&first_jobs, after_first_job, NULL, &after_jobs);
+  S2D_WaitJobs(&after_jobs);
+  end_test(ran_after_first);
+
+  // Input /////////////////////////////////////////////////////////////////////
+
+  start_test("(S2D_GetHeldKeys) held keys are added and removed");
+  S2D_SetKeyHeld(SDL_SCANCODE_A, true);
+  S2D_SetKeyHeld(SDL_SCANCODE_B, true);
+  S2D_SetKeyHeld(SDL_SCANCODE_C, true);
+  S2D_SetKeyHeld(SDL_SCANCODE_A, true);
+  S2D_SetKeyHeld(SDL_SCANCODE_A, false);
+  const int *held;
+  int num_held = S2D_GetHeldKeys(&held);
+  end_test(num_held == 2 && held[0] == SDL_SCANCODE_C && held[1] == SDL_SCANCODE_B);
+  S2D_SetKeyHeld(SDL_SCANCODE_B, false);
+  S2D_SetKeyHeld(SDL_SCANCODE_C, false);
+
+  start_test("(S2D_DispatchInput) poll key, mouse, and controller state");
+  S2D_Window *input_win = S2D_CreateWindow("Input", 100, 100, NULL, NULL, 0);
+  S2D_BeginInputFrame();
+  S2D_DispatchInput(input_win, S2D_KEYBOARD, (S2D_Event){ .type = S2D_KEY_DOWN, .scancode = SDL_SCANCODE_D });
+  S2D_DispatchInput(input_win, S2D_MOUSE, (S2D_Event){ .type = S2D_MOUSE_DOWN, .button = S2D_MOUSE_LEFT });
+  S2D_DispatchInput(input_win, S2D_CONTROLLER, (S2D_Event){ .which = 3, .type = S2D_AXIS, .axis = S2D_AXIS_LEFTX, .value = 1000 });
+  S2D_DispatchInput(input_win, S2D_CONTROLLER, (S2D_Event){ .which = 3, .type = S2D_BUTTON_DOWN, .button = S2D_BUTTON_A });
+  const S2D_ControllerState *pad = S2D_GetControllerState(3);
+  bool first_frame = S2D_IsKeyDown(SDL_SCANCODE_D) && S2D_WasKeyPressed(SDL_SCANCODE_D) &&
+                     S2D_IsMouseButtonDown(S2D_MOUSE_LEFT) && S2D_WasMouseButtonPressed(S2D_MOUSE_LEFT) &&
+                     pad && pad->axes[S2D_AXIS_LEFTX] == 1000 && pad->pressed[S2D_BUTTON_A];
+  S2D_BeginInputFrame();
+  S2D_DispatchInput(input_win, S2D_KEYBOARD, (S2D_Event){ .type = S2D_KEY_UP, .scancode = SDL_SCANCODE_D });
+  end_test(first_frame && !S2D_IsKeyDown(SDL_SCANCODE_D) && S2D_WasKeyReleased(SDL_SCANCODE_D) &&
+           !S2D_WasMouseButtonPressed(S2D_MOUSE_LEFT) && S2D_IsMouseButtonDown(S2D_MOUSE_LEFT) &&
+           pad->buttons[S2D_BUTTON_A] && !pad->pressed[S2D_BUTTON_A]);
+  S2D_RemoveControllerState(3);
+
+  start_test("(S2D_ReadReplayFrame) replay recorded input");
+  input_win->record_path = "replay_test.s2dr";
+  S2D_OpenReplay(input_win);
+  S2D_DispatchInput(input_win, S2D_KEYBOARD, (S2D_Event){ .type = S2D_KEY_DOWN, .scancode = SDL_SCANCODE_A });
+  S2D_WriteReplayFrame(input_win, 0.5f);
+  S2D_DispatchInput(input_win, S2D_KEYBOARD, (S2D_Event){ .type = S2D_KEY_UP, .scancode = SDL_SCANCODE_A });
+  S2D_WriteReplayFrame(input_win, 0.25f);
+  S2D_CloseReplay(input_win);
+  input_win->record_path = NULL;
+  input_win->replay_path = "replay_test.s2dr";
+  input_win->close = false;
+  S2D_OpenReplay(input_win);
+  S2D_BeginInputFrame();
+  bool frame1 = S2D_ReadReplayFrame(input_win) && input_win->replay->dt == 0.5f &&
+                S2D_WasKeyPressed(SDL_SCANCODE_A);
+  S2D_BeginInputFrame();
+  bool frame2 = S2D_ReadReplayFrame(input_win) && input_win->replay->dt == 0.25f &&
+                S2D_WasKeyReleased(SDL_SCANCODE_A);
+  bool ended = !S2D_ReadReplayFrame(input_win) && input_win->close;
+  S2D_CloseReplay(input_win);
+  remove("replay_test.s2dr");
+  end_test(frame1 && frame2 && ended);
+  S2D_FreeWindow(input_win);
+
   // Window ////////////////////////////////////////////////////////////////////
 
   S2D_Window *window = S2D_CreateWindow("Hello World", 100, 100, NULL, NULL, 0);
 
+  start_test("(S2D_GetFrameStats) percentiles of recorded frame times");
+  window->frame_ring = (S2D_FrameRing *) calloc(1, sizeof(S2D_FrameRing));
+  Uint64 ms = SDL_GetPerformanceFrequency() / 1000;
+  for (int i = 0; i < 100; i++) {
+    // Update takes 1ms, except for a 50ms hitch every 50 frames
+    Uint64 t[S2D_STAGE_COUNT] = { 0, (i % 50 == 49 ? 50 : 1) * ms, 0, 0, 0 };
+    for (int s = 2; s < S2D_STAGE_COUNT; s++) t[s] = t[s - 1] + ms;
+    S2D_RecordFrame(window, t);
+  }
+  S2D_FrameStats stats;
+  int frames = S2D_GetFrameStats(window, S2D_STAGE_UPDATE, 0, &stats);
+  end_test(frames == 100 && fabs(stats.p50 - 1) < 0.01 && fabs(stats.p99 - 50) < 0.01 &&
+           fabs(stats.max - 50) < 0.01);
+
+  start_test("(S2D_CameraToWorld) convert window points through a camera");
+  S2D_Window *camera_window = S2D_CreateWindow("Camera", 200, 100, NULL, NULL, 0);
+  S2D_Camera camera = { .x = 500, .y = 300, .zoom = 2, .rotate = 90 };
+  S2D_Vec2f center = S2D_CameraToWorld(camera_window, &camera, 100, 50);
+  S2D_Vec2f edge = S2D_CameraToWorld(camera_window, &camera, 200, 50);
+  end_test(center.x == 500 && center.y == 300 &&
+           fabsf(edge.x - 500) < 0.001 && fabsf(edge.y - 350) < 0.001);
+  S2D_FreeWindow(camera_window);
+
   start_test("(S2D_FreeWindow) free window");
   S2D_FreeWindow(window);
   end_test(PASS);
@@ -200,6 +551,140 @@ int main() {
   S2D_FreeWindow(win1); S2D_FreeWindow(win2);
   end_test(PASS);
 
+  start_test("(S2D_Show) run a headless window for a number of frames");
+  headless = S2D_CreateWindow("Headless", 64, 64, NULL, render_count, 0);
+  headless->headless = true;
+  headless->max_frames = 3;
+  S2D_StartCapture(headless, "headless_test.y4m", NULL);
+  S2D_Show(headless);
+  end_test(frames_rendered == 3 && headless->frames == 3);
+
+  start_test("(S2D_Show) cull primitives out of view and count them");
+  end_test(headless->render_stats.culled == 2 && headless->render_stats.submitted == 3);
+
+  start_test("(S2D_CreateRenderTarget) reuse pooled framebuffers of the same size");
+  end_test(pooled_fbo != 0 && target_reused);
+
+  start_test("(S2D_ScreenshotAsync) screenshot saved when the window closes");
+  end_test(S2D_FileExists("headless_test.png"));
+  remove("headless_test.png");
+
+  start_test("(S2D_StartCapture) capture frames to a video");
+  S2D_CaptureStats capture_stats;
+  S2D_GetCaptureStats(&capture_stats);
+  FILE *video = fopen("headless_test.y4m", "rb");
+  long video_size = 0;
+  if (video) {
+    fseek(video, 0, SEEK_END);
+    video_size = ftell(video);
+    fclose(video);
+  }
+  end_test(capture_stats.written + capture_stats.dropped == 3 &&
+           video_size > capture_stats.written * (6 + 64 * 64 * 3));
+  remove("headless_test.y4m");
+  S2D_FreeWindow(headless);
+
+  start_test("(S2D_Show) draw frames on a render thread");
+  frames_rendered = 0;
+  S2D_Window *threaded = S2D_CreateWindow("Render Thread", 64, 64, NULL, render_threaded, 0);
+  threaded->headless = true;
+  threaded->render_thread = true;
+  threaded->max_frames = 3;
+  S2D_StartCapture(threaded, "threaded_test.y4m", NULL);
+  S2D_Show(threaded);
+  S2D_GetCaptureStats(&capture_stats);
+  end_test(frames_rendered == 3 && threaded->frames == 3 &&
+           threaded->render_stats.culled == 2 && threaded->render_stats.submitted == 2 &&
+           capture_stats.written + capture_stats.dropped == 3);
+  remove("threaded_test.y4m");
+  S2D_FreeWindow(threaded);
+
+  start_test("(S2D_Show) change and draw text every frame on a render thread");
+  frames_rendered = 0;
+  threaded_text = S2D_CreateText("media/bitstream_vera/vera.ttf", "Frame 0", 20);
+  S2D_Window *threaded_texts = S2D_CreateWindow("Render Thread Text", 64, 64, NULL, render_threaded_text, 0);
+  threaded_texts->headless = true;
+  threaded_texts->render_thread = true;
+  threaded_texts->max_frames = 30;
+  S2D_Show(threaded_texts);
+  end_test(threaded_text && frames_rendered == 30 && threaded_texts->frames == 30 &&
+           threaded_text->renders_skipped == 0 && threaded_texts->render_stats.submitted == 1);
+  S2D_FreeText(threaded_text);
+  S2D_FreeWindow(threaded_texts);
+
+  start_test("(S2D_DrawSprites) draw runs of sprites with one draw call each");
+  S2D_Window *bulk = S2D_CreateWindow("Sprites", 64, 64, NULL, render_sprites, 0);
+  bulk->headless = true;
+  bulk->max_frames = 2;
+  S2D_Sprite *bulk_img = S2D_CreateSprite("media/image.png");
+  S2D_Sprite bulk_copies[3] = { *bulk_img, *bulk_img, *bulk_img };
+  bulk_copies[2].x = -1000;
+  bulk_sprites[0] = &bulk_copies[0];
+  bulk_sprites[1] = NULL;
+  bulk_sprites[2] = &bulk_copies[1];
+  bulk_sprites[3] = &bulk_copies[2];
+  S2D_Show(bulk);
+  end_test(bulk->render_stats.submitted == 2 && bulk->render_stats.culled == 1 &&
+           bulk->render_stats.draw_calls == 1);
+  S2D_FreeSprite(bulk_img);
+  S2D_FreeWindow(bulk);
+
+  start_test("(S2D_DrawDisc) draw circles, rings, and arcs in one draw call");
+  S2D_Window *discs = S2D_CreateWindow("Shapes", 64, 64, NULL, render_shapes, 0);
+  discs->headless = true;
+  discs->max_frames = 2;
+  S2D_Show(discs);
+  end_test(discs->render_stats.submitted == 3 && discs->render_stats.culled == 1 &&
+           discs->render_stats.draw_calls == 1);
+  S2D_FreeWindow(discs);
+
+  start_test("(S2D_DrawRects) draw arrays of triangles, rectangles, and lines in one draw call");
+  S2D_Window *arrays = S2D_CreateWindow("Arrays", 64, 64, NULL, render_arrays, 0);
+  arrays->headless = true;
+  arrays->max_frames = 2;
+  S2D_Show(arrays);
+  end_test(arrays->render_stats.submitted == 5 && arrays->render_stats.culled == 2 &&
+           arrays->render_stats.draw_calls == 1);
+  S2D_FreeWindow(arrays);
+
+  start_test("(S2D_DrawSmoothLine) smooth the edges of lines and rectangles with fringes");
+  S2D_Window *smooth = S2D_CreateWindow("Smooth", 64, 64, NULL, render_smooth, 0);
+  smooth->headless = true;
+  smooth->max_frames = 2;
+  S2D_Show(smooth);
+  end_test(smooth->render_stats.submitted == 20 && smooth->render_stats.culled == 10 &&
+           smooth->render_stats.draw_calls == 1);
+  S2D_FreeWindow(smooth);
+
+  start_test("(S2D_DrawPolyline) miter the corner of a polyline");
+  S2D_Color white = { 1, 1, 1, 1 };
+  corner_line = S2D_CreatePolyline(2, white);
+  whole_line = S2D_CreatePolyline(2, white);
+  appended_line = S2D_CreatePolyline(2, white);
+  whole_line->join = appended_line->join = S2D_JOIN_ROUND;
+  whole_line->cap = appended_line->cap = S2D_CAP_ROUND;
+  S2D_SetPolylinePoints(corner_line, polyline_points, 3);
+  S2D_SetPolylinePoints(whole_line, polyline_points, 5);
+  S2D_SetPolylinePoints(appended_line, polyline_points, 2);
+  S2D_Window *lines = S2D_CreateWindow("Polylines", 64, 64, NULL, render_polylines, 0);
+  lines->headless = true;
+  lines->max_frames = 1;
+  S2D_Show(lines);
+  S2D_Vertex *miter = corner_line->vertices;
+  end_test(corner_line->vertex_count == 12 &&
+           fabsf(miter[2].x - 11) < 0.001 && fabsf(miter[2].y + 1) < 0.001 &&
+           fabsf(miter[4].x - 9) < 0.001 && fabsf(miter[4].y - 1) < 0.001);
+
+  start_test("(S2D_AppendPolylinePoints) tessellate appended points like the whole line");
+  end_test(appended_line->count == 5 &&
+           appended_line->vertex_count == whole_line->vertex_count &&
+           memcmp(appended_line->vertices, whole_line->vertices,
+                  whole_line->vertex_count * sizeof(S2D_Vertex)) == 0);
+  S2D_FreePolyline(corner_line);
+  S2D_FreePolyline(whole_line);
+  S2D_FreePolyline(appended_line);
+  S2D_FreeWindow(lines);
+
   start_test("(S2D_Show) show a bad window pointer (expect error)");
   S2D_Show(NULL);
   end_test(PASS);
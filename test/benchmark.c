@@ -0,0 +1,99 @@
+// benchmark.c
+#include <simple2d.h>
+
+#define OBJECTS 5000
+#define FRAMES  120
+#define WIDTH   800
+#define HEIGHT  600
+
+S2D_Window *window;
+S2D_Image *images[4];
+
+typedef struct {
+  float x;
+  float y;
+  int image;  // index of the image drawn, or -1 for a rectangle
+} Object;
+
+Object objects[OBJECTS];
+
+// Draw calls summed over all frames
+Uint64 draw_calls = 0;
+
+
+void render() {
+  for (int i = 0; i < OBJECTS; i++) {
+    Object *o = &objects[i];
+    if (o->image < 0) {
+      S2D_DrawRect_XYWH(o->x, o->y, 16, 16, (S2D_Color){ 0.2, 0.6, 1, 1 }, true);
+    } else {
+      S2D_Image *img = images[o->image];
+      img->x = o->x;
+      img->y = o->y;
+      img->width = 16;
+      img->height = 16;
+      S2D_DrawImage(img);
+    }
+  }
+}
+
+
+// Called before rendering, so adds up the draw calls of the frame before
+void update() {
+  draw_calls += window->render_stats.draw_calls;
+}
+
+
+/*
+ * Draw every object for a number of frames, with draws sorted or not, and
+ * drawn on a render thread or not
+ */
+void run(const char *name, bool sorted, bool threaded) {
+  window = S2D_CreateWindow("Benchmark", WIDTH, HEIGHT, update, render, 0);
+  window->headless = true;
+  window->max_frames = FRAMES;
+  window->sorted_draws = sorted;
+  window->render_thread = threaded;
+
+  images[0] = S2D_CreateImage("media/image.png");
+  images[1] = S2D_CreateImage("media/image.jpg");
+  images[2] = S2D_CreateImage("media/colors.png");
+  images[3] = S2D_CreateImage("media/sprite_sheet.png");
+
+  draw_calls = 0;
+  S2D_Show(window);
+
+  S2D_FrameStats render_stats, flush_stats, frame_stats;
+  S2D_GetFrameStats(window, S2D_STAGE_RENDER, 0, &render_stats);
+  S2D_GetFrameStats(window, S2D_STAGE_FLUSH, 0, &flush_stats);
+  S2D_GetFrameStats(window, S2D_STAGE_FRAME, 0, &frame_stats);
+
+  printf("%-8s %10.1f %14.3f %14.3f %14.3f\n", name,
+         window->frames > 1 ? draw_calls / (double)(window->frames - 1) : 0,
+         render_stats.mean, flush_stats.mean, frame_stats.mean);
+
+  for (int i = 0; i < 4; i++) S2D_FreeImage(images[i]);
+  S2D_FreeWindow(window);
+}
+
+
+int main() {
+
+  // Objects in random order, a fifth of them rectangles
+  srand(2);
+  for (int i = 0; i < OBJECTS; i++) {
+    objects[i].x = rand() % (WIDTH - 16);
+    objects[i].y = rand() % (HEIGHT - 16);
+    objects[i].image = rand() % 5 - 1;
+  }
+
+  printf("%i objects, %i frames\n\n", OBJECTS, FRAMES);
+  printf("%-8s %10s %14s %14s %14s\n", "draws", "calls/frame", "render ms", "flush ms", "frame ms");
+
+  // With a render thread, the flush only waits for the frame before to be drawn
+  run("random", false, false);
+  run("sorted", true, false);
+  run("threaded", true, true);
+
+  return 0;
+}
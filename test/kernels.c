@@ -0,0 +1,72 @@
+// kernels.c
+#include <simple2d.h>
+
+#define QUADS  100000
+#define ROUNDS 50
+
+GLfloat x[QUADS], y[QUADS], width[QUADS], height[QUADS];
+GLfloat rotate[QUADS], rx[QUADS], ry[QUADS];
+GLfloat corners[QUADS * 8];
+GLfloat expected[QUADS * 8];
+
+
+/*
+ * Time transforming every quad with the kernel chosen, on one thread
+ */
+double run() {
+  S2D_QuadArrays quads = { x, y, width, height, rotate, rx, ry };
+
+  // Warm up the caches
+  S2D_TransformQuads(&quads, QUADS, corners);
+
+  Uint64 start = SDL_GetPerformanceCounter();
+  for (int r = 0; r < ROUNDS; r++) S2D_TransformQuads(&quads, QUADS, corners);
+  return (SDL_GetPerformanceCounter() - start) * 1000.0 /
+         SDL_GetPerformanceFrequency() / ROUNDS;
+}
+
+
+int main() {
+
+  srand(2);
+  for (int i = 0; i < QUADS; i++) {
+    x[i] = rand() % 800;
+    y[i] = rand() % 600;
+    width[i] = 16;
+    height[i] = 16;
+    rotate[i] = rand() % 360;
+    rx[i] = x[i] + 8;
+    ry[i] = y[i] + 8;
+  }
+
+  printf("%i quads, one thread\n\n", QUADS);
+  printf("%-8s %10s %14s %10s %12s\n", "kernel", "ms", "Mquads/s", "speedup", "max error");
+
+  double base = 0;
+  for (int k = S2D_KERNEL_SCALAR; k < S2D_KERNEL_COUNT; k++) {
+    if (!S2D_SetQuadKernel(k)) {
+      printf("%-8s %10s\n", S2D_QuadKernelName(k), "-");
+      continue;
+    }
+
+    double ms = run();
+    if (k == S2D_KERNEL_SCALAR) {
+      base = ms;
+      memcpy(expected, corners, sizeof(corners));
+    }
+
+    // Largest difference from the scalar kernel, in pixels
+    float error = 0;
+    for (int i = 0; i < QUADS * 8; i++) {
+      error = fmaxf(error, fabsf(corners[i] - expected[i]));
+    }
+
+    printf("%-8s %10.3f %14.2f %10.2f %12.6f\n", S2D_QuadKernelName(k), ms,
+           QUADS / ms / 1000.0, base / ms, error);
+  }
+
+  S2D_SetQuadKernel(S2D_KERNEL_AUTO);
+  printf("\nUsing %s by default\n", S2D_QuadKernelName(S2D_GetQuadKernel()));
+
+  return 0;
+}
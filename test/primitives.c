@@ -0,0 +1,191 @@
+// primitives.c
+#include <simple2d.h>
+
+#define RECTS   100000
+#define LINES   100000
+#define SERIES  10000  // points of a polyline
+#define POLYGONS 100    // drawn each frame
+#define POLYGON_POINTS 1000
+#define TESSELLATED_POINTS 4096  // most points of polygons tessellated
+#define FRAMES  60
+#define WIDTH   800
+#define HEIGHT  600
+
+S2D_Window *window;
+
+S2D_FRect rects[RECTS];
+S2D_Color rect_colors[RECTS];
+S2D_Vec2f line_points[LINES * 2];
+S2D_Color line_colors[LINES];
+S2D_Vec2f series[SERIES];
+S2D_Polyline *polyline;
+S2D_Vec2f polygon_points[POLYGONS][POLYGON_POINTS];
+S2D_Polygon *polygons[POLYGONS];
+int polygon_indices[(TESSELLATED_POINTS - 2) * 3];
+
+typedef void (*Draw)();
+
+
+void rects_each() {
+  for (int i = 0; i < RECTS; i++) S2D_DrawRect(rects[i], rect_colors[i], true);
+}
+
+void rects_array() {
+  S2D_DrawRects(rects, rect_colors, RECTS);
+}
+
+void lines_each() {
+  for (int i = 0; i < LINES; i++) {
+    S2D_Vec2f p1 = line_points[i * 2], p2 = line_points[i * 2 + 1];
+    S2D_Color c = line_colors[i];
+    S2D_DrawLine(p1.x, p1.y, p2.x, p2.y, 2,
+                 c.r, c.g, c.b, c.a, c.r, c.g, c.b, c.a,
+                 c.r, c.g, c.b, c.a, c.r, c.g, c.b, c.a);
+  }
+}
+
+void lines_array() {
+  S2D_DrawLines(line_points, line_colors, LINES, 2);
+}
+
+// Tessellated every frame, as if every point changed
+void polyline_changed() {
+  polyline->version++;
+  S2D_DrawPolyline(polyline);
+}
+
+void polyline_cached() {
+  S2D_DrawPolyline(polyline);
+}
+
+// Half the points at first, with the rest appended over the frames
+void polyline_appended() {
+  int count = SERIES / 2 / FRAMES;
+  if (polyline->count + count <= SERIES) {
+    S2D_AppendPolylinePoints(polyline, &series[polyline->count], count);
+  }
+  S2D_DrawPolyline(polyline);
+}
+
+void polygons_each_frame() {
+  S2D_Color c = { 0.2, 0.8, 0.4, 1 };
+  for (int i = 0; i < POLYGONS; i++) S2D_DrawPolygon(polygon_points[i], POLYGON_POINTS, c);
+}
+
+void polygons_cached() {
+  for (int i = 0; i < POLYGONS; i++) S2D_DrawCachedPolygon(polygons[i]);
+}
+
+
+/*
+ * Make a star shaped polygon, concave with points at random distances from
+ * its center
+ */
+void make_polygon(S2D_Vec2f *points, int count, float x, float y, float radius) {
+  for (int i = 0; i < count; i++) {
+    float angle = 2 * M_PI * i / count;
+    float r = radius * (0.5 + rand() % 100 / 200.0);
+    points[i] = (S2D_Vec2f){ x + r * cosf(angle), y + r * sinf(angle) };
+  }
+}
+
+
+/*
+ * Draw the primitives for a number of frames, returning the render stage mean
+ */
+double run(Draw draw) {
+  window = S2D_CreateWindow("Primitives", WIDTH, HEIGHT, NULL, draw, 0);
+  window->headless = true;
+  window->max_frames = FRAMES;
+
+  S2D_Show(window);
+
+  S2D_FrameStats render_stats;
+  S2D_GetFrameStats(window, S2D_STAGE_RENDER, 0, &render_stats);
+  S2D_FreeWindow(window);
+  return render_stats.mean;
+}
+
+
+/*
+ * Compare drawing primitives one call at a time with drawing them as an array
+ */
+void compare(const char *name, int count, Draw each, Draw array) {
+  double each_ms = run(each);
+  double array_ms = run(array);
+  printf("%-10s %12.3f %12.3f %10.2f %14.2f\n", name, each_ms, array_ms,
+         each_ms / array_ms, count / array_ms / 1000.0);
+}
+
+
+int main() {
+
+  srand(2);
+  for (int i = 0; i < RECTS; i++) {
+    rects[i] = (S2D_FRect){ rand() % WIDTH, rand() % HEIGHT, 4, 4 };
+    rect_colors[i] = (S2D_Color){ rand() % 100 / 100.0, 0.6, 1, 1 };
+  }
+
+  // A jagged series across the window, like a plot
+  for (int i = 0; i < LINES; i++) {
+    line_points[i * 2]     = (S2D_Vec2f){ i * WIDTH / (float)LINES, rand() % HEIGHT };
+    line_points[i * 2 + 1] = (S2D_Vec2f){ (i + 1) * WIDTH / (float)LINES, rand() % HEIGHT };
+    line_colors[i] = (S2D_Color){ 1, 0.5, 0, 1 };
+  }
+
+  printf("%i frames\n\n", FRAMES);
+  printf("%-10s %12s %12s %10s %14s\n", "primitive", "each ms", "array ms", "speedup", "M/s as array");
+
+  compare("rects", RECTS, rects_each, rects_array);
+  compare("lines", LINES, lines_each, lines_array);
+
+  // A series of values, like a chart of a live metric
+  for (int i = 0; i < SERIES; i++) {
+    series[i] = (S2D_Vec2f){ i * WIDTH / (float)SERIES, HEIGHT / 2 + rand() % 200 - 100 };
+  }
+
+  polyline = S2D_CreatePolyline(2, (S2D_Color){ 1, 0.5, 0, 1 });
+  polyline->join = S2D_JOIN_ROUND;
+
+  printf("\n%i point polyline\n\n", SERIES);
+  printf("%-10s %12s\n", "points", "render ms");
+
+  S2D_SetPolylinePoints(polyline, series, SERIES);
+  printf("%-10s %12.3f\n", "changed", run(polyline_changed));
+  printf("%-10s %12.3f\n", "cached", run(polyline_cached));
+  S2D_SetPolylinePoints(polyline, series, SERIES / 2);
+  printf("%-10s %12.3f\n", "appended", run(polyline_appended));
+
+  S2D_FreePolyline(polyline);
+
+  printf("\n%-10s %12s\n", "points", "tessellate us");
+
+  // Ear clipping up to 64 points, and splitting into monotone pieces above
+  for (int count = 16; count <= TESSELLATED_POINTS; count *= 4) {
+    S2D_Vec2f *points = (S2D_Vec2f *) malloc(count * sizeof(S2D_Vec2f));
+    make_polygon(points, count, WIDTH / 2, HEIGHT / 2, 250);
+
+    int rounds = 400000 / count;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int r = 0; r < rounds; r++) S2D_TessellatePolygon(points, count, polygon_indices);
+    double us = (SDL_GetPerformanceCounter() - start) * 1000000.0 /
+                SDL_GetPerformanceFrequency() / rounds;
+
+    printf("%-10i %12.2f\n", count, us);
+    free(points);
+  }
+
+  for (int i = 0; i < POLYGONS; i++) {
+    make_polygon(polygon_points[i], POLYGON_POINTS, rand() % WIDTH, rand() % HEIGHT, 60);
+    polygons[i] = S2D_CreatePolygon(polygon_points[i], POLYGON_POINTS, (S2D_Color){ 0.2, 0.8, 0.4, 1 });
+  }
+
+  printf("\n%i polygons of %i points\n\n", POLYGONS, POLYGON_POINTS);
+  printf("%-10s %12s\n", "polygons", "render ms");
+  printf("%-10s %12.3f\n", "each frame", run(polygons_each_frame));
+  printf("%-10s %12.3f\n", "cached", run(polygons_cached));
+
+  for (int i = 0; i < POLYGONS; i++) S2D_FreePolygon(polygons[i]);
+
+  return 0;
+}
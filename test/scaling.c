@@ -0,0 +1,147 @@
+// scaling.c
+#include <simple2d.h>
+
+#define QUADS   200000
+#define ROUNDS  20
+#define SPRITES 50000  // drawn from the first quads
+#define FRAMES  60
+
+typedef struct {
+  float x;
+  float y;
+  float width;
+  float height;
+  float rotate;
+} Quad;
+
+Quad quads[QUADS];
+GLfloat *vertices;  // 6 vertices of x, y, r, g, b, a, tx, ty per quad
+
+S2D_Window *window;
+S2D_Sprite *sprite_sheet[4];  // one for each image, copied for every sprite
+S2D_Sprite sprites[SPRITES];
+S2D_Sprite *sprite_ptrs[SPRITES];
+
+
+/*
+ * Generate the vertices of a range of quads, rotated around their centers
+ */
+void generate(int first, int last, void *data) {
+  for (int i = first; i < last; i++) {
+    Quad *q = &quads[i];
+    float rx = q->x + q->width / 2, ry = q->y + q->height / 2;
+
+    S2D_GL_Point v[4] = {
+      { q->x,            q->y             },
+      { q->x + q->width, q->y             },
+      { q->x + q->width, q->y + q->height },
+      { q->x,            q->y + q->height }
+    };
+    for (int c = 0; c < 4; c++) v[c] = S2D_RotatePoint(v[c], q->rotate, rx, ry);
+
+    const int corners[6] = { 0, 1, 2, 2, 3, 0 };
+    const float tx[4] = { 0, 1, 1, 0 }, ty[4] = { 0, 0, 1, 1 };
+    GLfloat *out = vertices + (size_t)i * 48;
+    for (int k = 0; k < 6; k++) {
+      int c = corners[k];
+      GLfloat vertex[8] = { v[c].x, v[c].y, 1, 1, 1, 1, tx[c], ty[c] };
+      memcpy(out + k * 8, vertex, sizeof(vertex));
+    }
+  }
+}
+
+
+/*
+ * Time generating the vertices of every quad with a number of threads
+ */
+double run(int threads) {
+  S2D_InitJobs(threads > 1 ? threads - 1 : -1);  // the calling thread and workers
+
+  Uint64 start = SDL_GetPerformanceCounter();
+  for (int r = 0; r < ROUNDS; r++) S2D_ParallelFor(QUADS, 0, generate, NULL);
+  double ms = (SDL_GetPerformanceCounter() - start) * 1000.0 /
+              SDL_GetPerformanceFrequency() / ROUNDS;
+
+  S2D_QuitJobs();
+  return ms;
+}
+
+
+void render() {
+  S2D_DrawSprites(sprite_ptrs, SPRITES);
+}
+
+
+/*
+ * Time drawing every sprite with S2D_DrawSprites, with a number of threads
+ */
+double run_sprites(int threads) {
+  S2D_InitJobs(threads > 1 ? threads - 1 : -1);
+
+  window = S2D_CreateWindow("Scaling", 800, 600, NULL, render, 0);
+  window->headless = true;
+  window->max_frames = FRAMES;
+
+  sprite_sheet[0] = S2D_CreateSprite("media/sprite_sheet.png");
+  sprite_sheet[1] = S2D_CreateSprite("media/image.png");
+  sprite_sheet[2] = S2D_CreateSprite("media/image.jpg");
+  sprite_sheet[3] = S2D_CreateSprite("media/colors.png");
+
+  // Sprites of the same image next to each other, drawn in four draw calls
+  for (int i = 0; i < SPRITES; i++) {
+    Quad *q = &quads[i];
+    sprites[i] = *sprite_sheet[i * 4 / SPRITES];
+    sprites[i].x = q->x;
+    sprites[i].y = q->y;
+    sprites[i].width = q->width;
+    sprites[i].height = q->height;
+    S2D_RotateSprite(&sprites[i], q->rotate, S2D_CENTER);
+    sprite_ptrs[i] = &sprites[i];
+  }
+
+  S2D_Show(window);
+
+  S2D_FrameStats render_stats;
+  S2D_GetFrameStats(window, S2D_STAGE_RENDER, 0, &render_stats);
+
+  for (int i = 0; i < 4; i++) S2D_FreeSprite(sprite_sheet[i]);
+  S2D_FreeWindow(window);
+
+  S2D_QuitJobs();
+  return render_stats.mean;
+}
+
+
+int main() {
+
+  vertices = (GLfloat *) malloc((size_t)QUADS * 48 * sizeof(GLfloat));
+  if (!vertices) return 1;
+
+  srand(2);
+  for (int i = 0; i < QUADS; i++) {
+    quads[i] = (Quad){ rand() % 800, rand() % 600, 16, 16, rand() % 360 };
+  }
+
+  printf("%i quads, %i CPU cores\n\n", QUADS, SDL_GetCPUCount());
+  printf("%-8s %10s %14s %10s\n", "threads", "ms", "Mquads/s", "speedup");
+
+  double base = 0;
+  for (int threads = 1; threads <= 16; threads *= 2) {
+    double ms = run(threads);
+    if (threads == 1) base = ms;
+    printf("%-8i %10.3f %14.2f %10.2f\n", threads, ms, QUADS / ms / 1000.0, base / ms);
+  }
+
+  printf("\n%i sprites, %i frames\n\n", SPRITES, FRAMES);
+  printf("%-8s %10s %14s %10s\n", "threads", "render ms", "Msprites/s", "speedup");
+
+  base = 0;
+  for (int threads = 1; threads <= 16; threads *= 2) {
+    double ms = run_sprites(threads);
+    if (threads == 1) base = ms;
+    printf("%-8i %10.3f %14.2f %10.2f\n", threads, ms, SPRITES / ms / 1000.0, base / ms);
+  }
+
+  free(vertices);
+  return 0;
+}